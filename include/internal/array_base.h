@@ -26,6 +26,7 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/types.h"
 
 // Unified array structure - both farray and parray can be cast to this
@@ -33,12 +34,14 @@ typedef struct sc_array_base {
    char handle[2]; // {'F', '\0'} for farray, {'P', '\0'} for parray
    void *bucket;   // pointer to first element (raw bytes or addr*)
    void *end;      // one past allocated memory
+   allocator alloc; // allocator owning the struct and bucket
 } sc_array_base;
 
 // Common array operations that work on the unified structure
 int array_base_capacity(const sc_array_base *arr, usize element_size);
 bool array_base_is_valid_index(const sc_array_base *arr, usize element_size, usize index);
 void *array_base_get_element_ptr(const sc_array_base *arr, usize element_size, usize index);
+int array_base_resize(sc_array_base *arr, usize element_size, usize capacity);
 
 // Type-specific operations
 typedef bool (*array_element_empty_fn)(const void *element, usize element_size);
@@ -36,9 +36,9 @@ usize farray_compact(farray arr, usize stride);
 usize parray_compact(parray arr);
 
 // Common memory management helpers
-object array_alloc_bucket(size_t element_size, usize capacity);
-void array_free_resources(void *bucket, void *struct_ptr);
-void *array_alloc_struct_with_bucket(usize struct_size, char handle_char,
+object array_alloc_bucket(allocator alloc, size_t element_size, usize capacity);
+void array_free_resources(allocator alloc, void *bucket, void *struct_ptr);
+void *array_alloc_struct_with_bucket(allocator alloc, usize struct_size, char handle_char,
                                      usize element_size, usize capacity,
                                      void **bucket_out, char **end_out);
 
@@ -30,6 +30,7 @@
 #include "sigcore/collections.h"
 #include "sigcore/farray.h"
 #include "sigcore/parray.h"
+#include "sigcore/slotarray.h"
 
 // collection structure (internal)
 struct sc_collection {
@@ -46,6 +47,7 @@ addr *array_get_bucket(parray arr);
 
 // collection internal functions
 collection collection_new(usize capacity, usize stride);
+collection collection_new_with(usize capacity, usize stride, allocator alloc);
 void collection_dispose(collection coll);
 int collection_add(collection coll, object ptr);
 int collection_grow(collection coll);
@@ -59,5 +61,14 @@ usize collection_get_stride(collection coll);
 usize collection_get_length(collection coll);
 void collection_set_length(collection coll, usize length);
 
+// list internal functions
+// Visit each pointer slot of a list and its collection (image relocation, see Arena.pin_list)
+typedef void (*image_slot_fn)(object slot, void *ctx);
+int list_image_slots(list lst, bool elements, image_slot_fn visit, void *ctx);
+
+// slotarray internal functions
+// Visit each pointer slot of a slotarray and its parray (see Arena.pin_slotarray)
+int slotarray_image_slots(slotarray sa, bool elements, image_slot_fn visit, void *ctx);
+
 // array collection helpers
 collection array_create_collection_view(void *buffer, void *end, usize stride, usize length, bool owns_buffer);
\ No newline at end of file
@@ -27,21 +27,25 @@
 
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/arena.h"
 #include "sigcore/memory.h"
 #include "sigcore/types.h"
+#include <stdatomic.h>
 
 // System memory allocation hooks
 typedef void *(*sysmem_alloc_fn)(size_t);
 typedef void (*sysmem_free_fn)(void *);
 typedef void *(*sysmem_calloc_fn)(size_t, size_t);
 typedef void *(*sysmem_realloc_fn)(void *, size_t);
+typedef void *(*sysmem_aligned_alloc_fn)(size_t, size_t);
 
 // System memory hook variables
 extern sysmem_alloc_fn sysmem_alloc;
 extern sysmem_free_fn sysmem_free;
 extern sysmem_calloc_fn sysmem_calloc;
 extern sysmem_realloc_fn sysmem_realloc;
+extern sysmem_aligned_alloc_fn sysmem_aligned_alloc; // (alignment, size); freed with sysmem_free
 
 // Allocation tracking structure
 struct sc_allocation {
@@ -59,8 +63,60 @@ struct block {
    usize alloc_size;         // Size of user allocation
    struct block *next_alloc; // Next in scope's allocation list
    struct block *prev_alloc; // Prev in scope's allocation list
+   memory_tag tag;           // Tag charged for the block (pool and root pool blocks)
 };
 
+// Per-tag counters (see Memory.Tag), kept per thread in shards that Memory.Tag.stats
+// folds together. Only the owning thread writes a shard, so charging is a plain load
+// and store; live_bytes wraps in a thread that frees what another thread charged, and
+// the folded sum comes out right. Each tag sits on its own cache line.
+#define MEMORY_TAG_LINE 64
+struct memory_tag_counters {
+   _Alignas(MEMORY_TAG_LINE) _Atomic usize live_bytes;
+   _Atomic usize allocations;
+};
+struct memory_tag_shard {
+   struct memory_tag_counters tags[MEMORY_TAG_MAX];
+   struct memory_tag_shard *next; // Next shard in the global (push-only) list
+   _Atomic bool in_use;           // Owned by a live thread; exited threads' shards are reused
+};
+extern _Thread_local struct memory_tag_shard *memory_tag_shard;
+extern _Thread_local memory_tag current_tag;
+struct memory_tag_shard *memory_tag_shard_acquire(void);
+
+// Add to the calling thread's counters of a tag
+static inline void memory_tag_add(memory_tag tag, usize bytes, usize allocations) {
+   struct memory_tag_shard *shard = memory_tag_shard;
+   if (!shard)
+      shard = memory_tag_shard_acquire();
+   struct memory_tag_counters *counters = &shard->tags[tag];
+   usize live = atomic_load_explicit(&counters->live_bytes, memory_order_relaxed);
+   atomic_store_explicit(&counters->live_bytes, live + bytes, memory_order_relaxed);
+   if (allocations) {
+      usize count = atomic_load_explicit(&counters->allocations, memory_order_relaxed);
+      atomic_store_explicit(&counters->allocations, count + allocations, memory_order_relaxed);
+   }
+}
+// Charge an allocation to a tag
+static inline void memory_tag_charge(memory_tag tag, usize bytes) {
+   memory_tag_add(tag, bytes, 1);
+}
+// Charge bytes to a tag without counting an allocation (in-place growth)
+static inline void memory_tag_grow(memory_tag tag, usize bytes) {
+   memory_tag_add(tag, bytes, 0);
+}
+// Return released bytes to a tag
+static inline void memory_tag_release(memory_tag tag, usize bytes) {
+   memory_tag_add(tag, (usize)0 - bytes, 0);
+}
+// Move live bytes between tags (a scope changing tag, or merging into another)
+static inline void memory_tag_move(memory_tag from, memory_tag to, usize bytes) {
+   if (from != to) {
+      memory_tag_release(from, bytes);
+      memory_tag_grow(to, bytes);
+   }
+}
+
 // Opaque slotarray typedef for backdoor access
 typedef struct sc_slotarray *slotarray;
 
@@ -73,18 +129,36 @@ void memory_dispose(object);
 
 // Pool functions (internal, used by Arena)
 pool pool_create(usize);
+pool pool_create_ex(const pool_opts *);
+usize pool_placement(pool, usize *, usize);
+int pool_set_budget(pool, const scope_budget *);
+void pool_retag(pool, memory_tag);
 object pool_alloc(pool, usize, bool);
 void pool_free(pool, object);
 void pool_dispose(pool);
+void pool_absorb(pool, pool);
 
 // Arena functions (internal, used by Memory)
 arena arena_create(usize);
+arena arena_create_ex(const arena_opts *);
+arena arena_load(const char *, object *);
 void arena_dispose(arena);
+void arena_retag(arena, memory_tag);
 
 // Scope functions (internal, used by Memory)
 object scope_import(void *, const void *, usize);
 object scope_export(void *, const void *, usize);
 object scope_alloc(usize, bool);
+void scope_init_header(sc_scope *, const char *, const scope_ops *);
+int scope_set_tag(void *, memory_tag);
+bool scope_budget_admit(const scope_budget *, void *, usize, usize);
+
+// Allocator helpers (internal, used by collections)
+allocator memory_get_allocator(void);
+allocator scope_allocator(void);
+object allocator_alloc(allocator, usize, bool);
+void allocator_free(allocator, object);
+object allocator_realloc(allocator, object, usize, usize);
 
 // Backdoor functions for testing internals
 struct memory_page *memory_get_current_page(void);
@@ -0,0 +1,56 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: page_cache.h
+ * Description: Internal process-wide page cache shared by arenas and pools
+ */
+#pragma once
+
+#include "sigcore/memory.h"
+#include "sigcore/types.h"
+
+// Number of distinct chunk sizes each cache level can hold
+#define PAGE_CACHE_CLASSES 8
+// Default byte limits for the global and per-thread cache levels
+#define PAGE_CACHE_GLOBAL_LIMIT (4 * 1024 * 1024)
+#define PAGE_CACHE_THREAD_LIMIT (256 * 1024)
+
+/**
+ * @brief Take a chunk of exactly `size` bytes from the cache, falling back to the system
+ * @details Chunks from the system are aligned to the OS page size, so page-multiple
+ *          chunks cover whole OS pages.
+ * @param size Chunk size in bytes
+ * @return Pointer to the chunk, or NULL if the system allocator fails
+ */
+object page_cache_acquire(usize size);
+/**
+ * @brief Return a chunk previously taken with page_cache_acquire
+ * @param chunk The chunk to recycle
+ * @param size Chunk size in bytes (must match the size it was acquired with)
+ */
+void page_cache_release(object chunk, usize size);
+
+// Cache management (internal, used by Memory)
+void page_cache_configure(usize global_limit, usize thread_limit);
+void page_cache_get_stats(page_cache_stats *stats);
+void page_cache_trim(void);
@@ -0,0 +1,71 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: trace.h
+ * Description: Internal allocator event tracing (see Memory.Trace)
+ */
+#pragma once
+
+#include "sigcore/types.h"
+#include <stdatomic.h>
+
+// Traced allocator events
+enum trace_event_kind {
+   TRACE_ALLOC,            // Memory.alloc, pool or arena allocation (addr, size)
+   TRACE_DISPOSE,          // Memory.dispose or pool free (addr)
+   TRACE_PAGE_GROW,        // Page created or reserved range committed (addr, size)
+   TRACE_PAGE_RELEASE,     // Page destroyed or range decommitted (addr, size)
+   TRACE_FRAME_BEGIN,      // Arena frame begun (arena, depth)
+   TRACE_FRAME_END,        // Arena frame ended (arena, depth)
+   TRACE_COLLECTION_GROW,  // Collection or array bucket resized (bucket, new bytes)
+   TRACE_EVENT_KINDS
+};
+
+// Set while Memory.Trace is started
+extern _Atomic bool memory_trace_on;
+
+/**
+ * @brief Append an event to the calling thread's ring (creating it on first use)
+ * @param kind An enum trace_event_kind value
+ * @param addr Address the event refers to
+ * @param size Size the event refers to
+ */
+void memory_trace_record(int kind, const void *addr, usize size);
+
+// Record an event; a single predictable branch while tracing is off, and nothing
+// at all when built with SIGCORE_NO_TRACE
+#ifdef SIGCORE_NO_TRACE
+#define MEMORY_TRACE(kind, addr, size) ((void)0)
+#else
+#define MEMORY_TRACE(kind, addr, size)                                                       \
+   do {                                                                                      \
+      if (__builtin_expect(atomic_load_explicit(&memory_trace_on, memory_order_relaxed), 0)) \
+         memory_trace_record((kind), (addr), (size));                                        \
+   } while (0)
+#endif
+
+// Memory.Trace operations
+int memory_trace_start(usize events_per_thread);
+void memory_trace_stop(void);
+void memory_trace_clear(void);
+int memory_trace_dump(const char *path);
@@ -0,0 +1,194 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: vmem.h
+ * Description: Internal virtual memory primitives for reserved arenas
+ */
+#pragma once
+
+#include "sigcore/types.h"
+
+// Default commit step for reserved arenas, and the step used with huge pages
+#define VMEM_COMMIT_STEP (64 * 1024)
+#define VMEM_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * @brief Get the operating system page size
+ * @return Page size in bytes
+ */
+usize vmem_page_size(void);
+/**
+ * @brief Reserve a range of address space without backing memory (PROT_NONE)
+ * @param size Bytes to reserve (rounded up to the OS page size by the caller)
+ * @return Base of the range, or NULL on failure
+ */
+object vmem_reserve(usize size);
+/**
+ * @brief Reserve a range of address space starting on a given boundary
+ * @param size Bytes to reserve (multiple of the OS page size)
+ * @param align Boundary for the start (power of two, multiple of the OS page size)
+ * @return Base of the range, or NULL on failure
+ */
+object vmem_reserve_aligned(usize size, usize align);
+/**
+ * @brief Make part of a reserved range readable and writable
+ * @param addr Page-aligned start of the range to commit
+ * @param size Bytes to commit (multiple of the OS page size)
+ * @param prefault If true, populate the pages now (MAP_POPULATE)
+ * @param huge If true, advise transparent huge pages for the range before it is populated
+ * @return 0 on success, -1 on failure
+ */
+int vmem_commit(object addr, usize size, bool prefault, bool huge);
+/**
+ * @brief Return committed pages to the system, keeping the range reserved
+ * @param addr Page-aligned start of the range to decommit
+ * @param size Bytes to decommit (multiple of the OS page size)
+ * @return 0 on success, -1 on failure
+ */
+int vmem_decommit(object addr, usize size);
+/**
+ * @brief Ask the kernel to back a range with transparent huge pages
+ * @param addr Start of the range
+ * @param size Bytes in the range
+ * @return 0 on success, -1 if unsupported or refused
+ */
+int vmem_advise_huge(object addr, usize size);
+/**
+ * @brief Map part of a file privately (copy-on-write), preferably at a given address
+ * @param path File to map
+ * @param offset Page-aligned file offset of the range
+ * @param size Bytes to map
+ * @param hint Preferred address; it is only used if nothing is mapped there
+ * @return Base of the mapping (hint on success at the preferred address), or NULL on failure
+ */
+object vmem_map_file(const char *path, usize offset, usize size, object hint);
+/**
+ * @brief Make a mapped range read-only
+ * @param addr Page-aligned start of the range
+ * @param size Bytes in the range
+ * @return 0 on success, -1 on failure
+ */
+int vmem_protect_read(object addr, usize size);
+/**
+ * @brief Release a reserved range entirely
+ * @param addr Base returned by vmem_reserve
+ * @param size Size passed to vmem_reserve
+ */
+void vmem_release(object addr, usize size);
+/**
+ * @brief Get the NUMA node of the CPU the calling thread is running on
+ * @return Node number, or -1 if it cannot be determined
+ */
+int vmem_numa_current_node(void);
+/**
+ * @brief Check that pages can be bound to a NUMA node
+ * @param node Node number
+ * @return true if the node exists and is allowed; false if not, or if NUMA policy is unavailable
+ */
+bool vmem_numa_node_valid(int node);
+/**
+ * @brief Bind the whole OS pages of a range to a NUMA node, migrating resident pages
+ * @param addr Start of the range
+ * @param size Bytes in the range (partial OS pages at either end are left alone)
+ * @param node Node to bind to, or -1 to restore the default policy
+ * @return 0 on success, -1 on failure
+ */
+int vmem_numa_bind(object addr, usize size, int node);
+/**
+ * @brief Count the resident OS pages of a range on each NUMA node
+ * @param addr Start of the range
+ * @param size Bytes in the range
+ * @param pages_per_node Array of `nodes` counters, incremented per resident page
+ * @param nodes Number of counters (pages on higher nodes are only counted in the result)
+ * @return Number of resident pages found (0 if placement cannot be queried)
+ */
+usize vmem_numa_placement(object addr, usize size, usize *pages_per_node, usize nodes);
+/**
+ * @brief Resolve a requested NUMA node to one pages can be bound to
+ * @param node Requested node, or -1 for the calling thread's node
+ * @return A valid node, or -1 if binding is not possible (degrade to unbound)
+ */
+int vmem_numa_resolve(int node);
+/**
+ * @brief Create a shared memory object of a given size
+ * @param name shm_open name ("/name"), or NULL for an anonymous memfd
+ * @param size Bytes of the object
+ * @return File descriptor, or -1 on failure (including a name that already exists)
+ */
+int vmem_shared_create(const char *name, usize size);
+/**
+ * @brief Open an existing named shared memory object read-write
+ * @param name shm_open name
+ * @return File descriptor, or -1 on failure
+ */
+int vmem_shared_open(const char *name);
+/**
+ * @brief Remove a named shared memory object (mappings stay valid)
+ * @param name shm_open name
+ * @return 0 on success, -1 on failure
+ */
+int vmem_shared_unlink(const char *name);
+/**
+ * @brief Get the size of a file or shared memory object
+ * @param fd File descriptor
+ * @return Size in bytes, or 0 on failure
+ */
+usize vmem_fd_size(int fd);
+/**
+ * @brief Map a file descriptor shared and read-write
+ * @param fd File descriptor
+ * @param size Bytes to map
+ * @param private_copy If true, map copy-on-write (MAP_PRIVATE) instead of shared
+ * @return Base of the mapping, or NULL on failure
+ */
+object vmem_map_fd(int fd, usize size, bool private_copy);
+/**
+ * @brief Close a file descriptor returned by vmem_shared_create or vmem_shared_open
+ * @param fd File descriptor (ignored if negative)
+ */
+void vmem_close_fd(int fd);
+/**
+ * @brief Duplicate a file descriptor
+ * @param fd File descriptor
+ * @return The new descriptor, or -1 on failure
+ */
+int vmem_dup_fd(int fd);
+/**
+ * @brief Map a file descriptor read-write over an existing range (MAP_FIXED)
+ * @param addr Page-aligned start of the range
+ * @param size Bytes to map, from offset 0 of the descriptor
+ * @param fd File descriptor
+ * @param private_copy If true, map copy-on-write (MAP_PRIVATE) instead of shared
+ * @return 0 on success, -1 on failure
+ */
+int vmem_remap_fd(object addr, usize size, int fd, bool private_copy);
+/**
+ * @brief Write the pages a private mapping of a descriptor has copied back to the descriptor
+ * @details Copied pages are found through /proc/self/pagemap, so only touched pages are
+ *          written; if pagemap cannot be read, the whole range is written.
+ * @param addr Page-aligned start of a private mapping of fd (offset 0)
+ * @param size Bytes of the mapping to consider
+ * @param fd File descriptor the range maps
+ * @return 0 on success, -1 on failure
+ */
+int vmem_write_back(object addr, usize size, int fd);
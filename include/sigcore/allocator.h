@@ -0,0 +1,66 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: allocator.h
+ * Description: Allocator interface used by SigmaCore collections
+ *
+ * Allocator:  A small vtable (alloc, free, realloc) plus an opaque context.
+ *             Collections remember the allocator they were created with and
+ *             route growth and disposal back through it, so an arena-backed
+ *             list never frees its bucket into the root pool.
+ */
+#pragma once
+
+#include "sigcore/types.h"
+
+/* Allocator vtable                                             */
+/* ============================================================ */
+typedef struct sc_allocator {
+   /**
+    * @brief Allocate a block of memory.
+    * @param ctx The allocator context
+    * @param size Size of the allocation in bytes
+    * @param zero If true, zero-initialize the memory
+    * @return Pointer to the allocated memory, or NULL on failure
+    */
+   object (*alloc)(void *ctx, usize size, bool zero);
+   /**
+    * @brief Release a block obtained from this allocator.
+    * @param ctx The allocator context
+    * @param ptr The block to release
+    */
+   void (*free)(void *ctx, object ptr);
+   /**
+    * @brief Resize a block obtained from this allocator.
+    * @param ctx The allocator context
+    * @param ptr The block to resize (NULL allocates)
+    * @param old_size Current size of the block in bytes
+    * @param new_size Requested size in bytes
+    * @return Pointer to the resized block, or NULL on failure (ptr stays valid)
+    */
+   object (*realloc)(void *ctx, object ptr, usize old_size, usize new_size);
+   void *ctx; // Passed to every call (the arena, pool, ... backing the allocator)
+} sc_allocator;
+
+// Allocators are shared by reference and must outlive the containers using them
+typedef const struct sc_allocator *allocator;
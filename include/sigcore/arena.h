@@ -26,6 +26,11 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
+#include "sigcore/farray.h"
+#include "sigcore/list.h"
+#include "sigcore/scope.h"
+#include "sigcore/slotarray.h"
 #include "sigcore/types.h"
 
 // Opaque type declarations
@@ -34,7 +39,45 @@ typedef struct sc_arena sc_arena;
 typedef struct sc_page sc_page;
 typedef struct sc_frame sc_frame;
 typedef struct sc_arena *arena;
-typedef struct sc_frame *frame;
+
+// Frame handle: a marker slot held inline by the arena and the generation that claimed
+// it. The next frame at the same depth reuses the slot under a new generation, so an
+// ended frame's handle never matches its slot again.
+typedef struct sc_frame_handle {
+   sc_frame *slot;   // Marker slot (NULL if begin_frame failed)
+   usize generation; // Arena begin count when the frame began
+} frame;
+
+// Call deferred to the end of a frame (see Arena.defer)
+typedef void (*frame_defer_fn)(object arg);
+
+// NUMA node meaning "the node of the creating thread" (arena_opts and pool_opts)
+#define NUMA_NODE_LOCAL (-1)
+
+// Arena creation options (see Memory.Arena.create_ex)
+typedef struct sc_arena_opts {
+   usize initial_pages; // Pages created up front
+   usize page_size;     // Data bytes of the first page (0 = 4096)
+   usize max_page_size; // Successive pages double up to this size (0 = fixed-size pages)
+   usize reserve;       // Bytes of address space to reserve for one contiguous page (0 = page chain)
+   bool prefault;       // Reserved arenas: populate pages as they are committed
+   bool huge_pages;     // Reserved arenas: request transparent huge pages
+   bool forkable;       // Reserved arenas: back the range with a memfd so Arena.fork works
+   bool numa_bind;      // Bind pages to numa_node (ignored where the node or NUMA policy is unavailable)
+   int numa_node;       // Node for numa_bind, or NUMA_NODE_LOCAL
+} arena_opts;
+
+// Arena counters (see Arena.stats); all are maintained incrementally
+typedef struct sc_arena_stats {
+   usize used;           // Bytes handed out by live allocations
+   usize reserved;       // Data bytes of all pages owned by the arena (committed bytes when reserved)
+   usize tail_waste;     // Bytes abandoned at the end of pages the arena moved past
+   usize peak;           // Highest value of used since creation
+   usize page_count;     // Pages owned by the arena
+   usize frame_depth;    // Frames currently open
+   usize tracked_blocks; // Entries in the allocation tracking list
+   int numa_node;        // Node the arena's pages are bound to (-1 = not bound)
+} arena_stats;
 
 /* Public interface for arena operations                    */
 /* ========================================================= */
@@ -47,6 +90,18 @@ typedef struct sc_arena_i {
     * @return Pointer to allocated memory, or NULL if allocation fails
     */
    object (*alloc)(arena, usize, bool);
+   /**
+    * @brief Resize an arena allocation, in place when it is the most recent one
+    * @details The last allocation on the current page grows or shrinks by moving the
+    *          bump pointer (unless a frame or promotion marker sits past its start).
+    *          Any other block is copied to a new allocation and the old one abandoned.
+    * @param arena The arena the block was allocated from
+    * @param ptr The block to resize (NULL allocates)
+    * @param old_size Current size of the block in bytes
+    * @param new_size Requested size in bytes
+    * @return Pointer to the resized block, or NULL on failure (ptr stays valid)
+    */
+   object (*realloc)(arena, object ptr, usize old_size, usize new_size);
    /**
     * @brief Check if a pointer is tracked by this arena
     * @param arena The arena to check
@@ -78,10 +133,43 @@ typedef struct sc_arena_i {
     * @return Total allocated bytes
     */
    usize (*get_total_allocated)(arena);
+   /**
+    * @brief Get a snapshot of the arena's usage counters in constant time
+    * @param arena The arena to query
+    * @param stats Receives the counters
+    * @return 0 on success, -1 if the arena or stats is invalid
+    */
+   int (*stats)(arena, arena_stats *);
+   /**
+    * @brief Count where the arena's resident memory physically lives
+    * @details Queries the kernel for every OS page of the arena's pages (not constant
+    *          time). Pages never touched are not resident and are not counted. On a
+    *          single-node machine everything lands on node 0.
+    * @param arena The arena to query
+    * @param pages_per_node Array of `nodes` counters to fill (zeroed first)
+    * @param nodes Number of counters
+    * @return Number of resident OS pages found (0 if placement cannot be queried)
+    */
+   usize (*placement)(arena, usize *pages_per_node, usize nodes);
+   /**
+    * @brief Limit the bytes the arena reserves (page data, or committed bytes when reserved)
+    * @details Checked only when the arena takes a new page or commits more of its
+    *          mapping: an allocation that would push reserved past budget->hard
+    *          returns NULL at once; crossing budget->soft calls budget->on_soft.
+    *          Pages the arena already holds are not affected.
+    * @param arena The arena to limit
+    * @param budget The budget (copied), or NULL to remove it
+    * @return 0 on success, -1 if the arena is invalid
+    */
+   int (*set_budget)(arena, const scope_budget *budget);
    /**
     * @brief Begin a new frame for temporary allocations
+    * @details Frames are markers held inline by the arena (no allocation); nesting
+    *          is limited to a fixed depth. The handle is a value: once the frame ends,
+    *          every call taking it fails, even after a later frame reuses its slot.
     * @param arena The arena to create a frame for
-    * @return A frame handle for temporary allocations, or NULL on failure
+    * @return A frame handle for temporary allocations; on failure, or when the arena's
+    *         frame stack is full, its slot is NULL
     */
    frame (*begin_frame)(arena);
    /**
@@ -89,5 +177,168 @@ typedef struct sc_arena_i {
     * @param frame The frame handle returned by begin_frame
     */
    void (*end_frame)(frame);
+   /**
+    * @brief Get the arena a frame allocates from
+    * @param frame The frame handle
+    * @return The frame's arena, or NULL if the frame is invalid or has ended
+    */
+   arena (*get_frame_arena)(frame);
+   /**
+    * @brief Get a frame's scope header, for Memory.Scope.push, move and adopt
+    * @details The scope's allocator is the arena's own, and allocating through the
+    *          scope falls back to the arena once the frame ends, so promoted collections
+    *          created in the frame can keep growing. Do not push, move into or adopt
+    *          into the scope after the frame ends.
+    * @param frame The frame handle
+    * @return The frame's scope, or NULL if the frame is invalid or has ended
+    */
+   object (*get_frame_scope)(frame);
+   /**
+    * @brief Keep an object allocated in a frame when the frame ends, without copying it
+    * @details The frame's rollback marker moves to the end of the object, so the object
+    *          and everything the frame allocated before it now belong to the parent scope.
+    *          Allocations made after it are still rolled back. Cost is linear in the
+    *          frame allocations between the previous marker and the object.
+    * @param frame The innermost frame of its arena
+    * @param obj An object allocated in the frame
+    * @return 0 on success (also when obj was already promoted), -1 if the frame is not
+    *         the innermost one or obj was not allocated in it
+    */
+   int (*promote)(frame, object);
+   /**
+    * @brief Keep everything allocated in a frame so far when the frame ends
+    * @details Buffers adopted through the frame (Memory.Scope.adopt) are kept as well.
+    *          Collections created in the frame allocate from the arena, so they can keep
+    *          growing after it ends (into whatever frame is open at the time).
+    * @param frame The innermost frame of its arena
+    * @return 0 on success, -1 if the frame is invalid or not the innermost one
+    */
+   int (*promote_all)(frame);
+   /**
+    * @brief Call fn(arg) when the frame ends
+    * @details Deferred calls and adopted buffers run together in LIFO order, in a
+    *          single pass, before the frame's memory is rolled back; Arena.reset and
+    *          disposing the arena run any still pending. The entry is allocated in the
+    *          frame, so registering costs one bump allocation. A promoted frame
+    *          (promote_all) keeps its deferred calls for the enclosing scope.
+    * @param frame The innermost frame of its arena
+    * @param fn Function to call
+    * @param arg Argument passed to fn (may be NULL)
+    * @return 0 on success, -1 if the frame is invalid or not the innermost one, fn is
+    *         NULL, or the entry cannot be allocated
+    */
+   int (*defer)(frame, frame_defer_fn fn, object arg);
+   /**
+    * @brief Get an allocator that allocates from the arena
+    * @details Freeing through the allocator is a no-op; the memory is reclaimed when
+    *          the enclosing frame ends or the arena is disposed.
+    * @param arena The arena to allocate from
+    * @return The arena's allocator (valid for the arena's lifetime), or NULL
+    */
+   allocator (*allocator)(arena);
+   /**
+    * @brief Check whether a pointer lies inside memory allocated from the arena
+    * @details For reserved arenas this is a single range compare.
+    * @param arena The arena to check
+    * @param ptr The pointer to test
+    * @return true if ptr points into the arena's live allocations
+    */
+   bool (*contains)(arena, object);
+   /**
+    * @brief Discard all allocations, frames and tracked pointers, keeping the pages
+    * @details Reserved arenas also decommit everything past their first commit step.
+    * @param arena The arena to reset
+    */
+   void (*reset)(arena);
+   /**
+    * @brief Write a reserved arena's memory to a relocatable image file
+    * @details Only the pointers registered with Arena.pin, pin_farray, pin_list and
+    *          pin_slotarray are relocated; everything else is saved byte for byte. A pinned pointer
+    *          to memory outside the arena is saved as-is and is not valid after loading.
+    *          Load the image back with Memory.Arena.load.
+    * @param arena The reserved arena to save (created with arena_opts.reserve)
+    * @param path File to write
+    * @param root Object inside the arena handed back by load (may be NULL)
+    * @return 0 on success, -1 if the arena is not reserved, root is foreign, or I/O fails
+    */
+   int (*save)(arena, const char *path, object root);
+   /**
+    * @brief Register a pointer field inside a reserved arena for relocation by Arena.save
+    * @details The field is read when the image is saved, so it may change after pinning.
+    *          A pin is dropped when a frame rollback, reset or fork discard frees the field.
+    * @param arena The reserved arena holding the field
+    * @param slot Address of a pointer-aligned pointer field inside the arena
+    * @return 0 on success, -1 if the arena is not reserved or slot is foreign or misaligned
+    */
+   int (*pin)(arena, object slot);
+   /**
+    * @brief Register an farray's header (bucket and allocator) for relocation by Arena.save
+    * @param arena The reserved arena holding the array
+    * @param arr Array allocated from the arena
+    * @return 0 on success, -1 if the arena is not reserved or arr is not an farray inside it
+    */
+   int (*pin_farray)(arena, farray arr);
+   /**
+    * @brief Register a list and its buffer for relocation by Arena.save
+    * @details The list is walked when the image is saved, so it may keep growing after
+    *          pinning. With elements set, every stored pointer is relocated as well.
+    * @param arena The reserved arena holding the list
+    * @param lst List allocated from the arena
+    * @param elements Relocate the elements too (lists of pointers only)
+    * @return 0 on success, -1 if the arena is not reserved, lst is foreign, or elements
+    *         is set for a list of values
+    */
+   int (*pin_list)(arena, list lst, bool elements);
+   /**
+    * @brief Register a slotarray and its slots for relocation by Arena.save
+    * @details The slotarray is walked when the image is saved, so slots may be added or
+    *          removed after pinning. With elements set, every stored pointer is relocated.
+    * @param arena The reserved arena holding the slotarray
+    * @param sa Slotarray allocated from the arena
+    * @param elements Relocate the stored pointers too
+    * @return 0 on success, -1 if the arena is not reserved or sa is not a slotarray inside it
+    */
+   int (*pin_slotarray)(arena, slotarray sa, bool elements);
+   /**
+    * @brief Hand everything allocated in a child arena to a parent arena without copying
+    * @details The child's pages, tracked pointers and adopted buffers are spliced onto
+    *          the parent in constant time (the child's empty spare pages are released).
+    *          Allocations then continue on the child's last page. The child handle must
+    *          not be used afterwards, but allocators taken from it keep working and
+    *          allocate from the parent; its header is freed when the parent is disposed.
+    * @param parent The arena taking ownership
+    * @param child The arena to merge (must have no open frames)
+    * @return 0 on success, -1 if either arena is reserved or loaded from an image, or
+    *         the child has open frames
+    */
+   int (*merge)(arena parent, arena child);
+   /**
+    * @brief Snapshot a forkable arena for speculative work, committed or discarded later
+    * @details The arena's memfd is remapped copy-on-write in place, so pointers stay
+    *          valid and existing data may be modified freely; only pages written during
+    *          the fork are copied. Frames may be used inside the fork. Resetting the
+    *          arena discards an open fork first.
+    * @param arena The arena to fork (created with arena_opts.reserve and forkable)
+    * @return 0 on success, -1 if the arena is not forkable, already forked, or has open frames
+    */
+   int (*fork)(arena);
+   /**
+    * @brief Keep everything done since Arena.fork
+    * @details Writes the pages copied during the fork back to the memfd, so the cost
+    *          follows the pages touched. Frames opened during the fork stay open.
+    * @param arena The forked arena
+    * @return 0 on success, -1 if the arena is not forked or the write-back fails (the
+    *         fork then stays open)
+    */
+   int (*commit)(arena);
+   /**
+    * @brief Undo everything done since Arena.fork
+    * @details Drops the copied pages and restores allocations, tracking, adopted
+    *          buffers (releasing the ones adopted during the fork) and counters to the
+    *          fork point. Frames opened during the fork are invalidated.
+    * @param arena The forked arena
+    * @return 0 on success, -1 if the arena is not forked
+    */
+   int (*discard)(arena);
 } sc_arena_i;
 extern const sc_arena_i Arena;
\ No newline at end of file
@@ -30,6 +30,7 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/collection.h"
 #include "sigcore/farray.h"
 #include "sigcore/list.h"
@@ -42,6 +43,7 @@ typedef struct iterator_s *iterator;
 struct iterator_s {
    struct sc_collection *coll; /* The collection to iterate over */
    size_t current;             /* Current index */
+   allocator alloc;            /* Allocator owning the iterator */
 };
 
 /* Public interface for collections operations                */
@@ -31,6 +31,10 @@
 
 // Memory management
 #include "sigcore/memory.h"
+#include "sigcore/dstack.h"
+#include "sigcore/shmem.h"
+#include "sigcore/epoch.h"
+#include "sigcore/sharedbuf.h"
 
 // Collections (includes collection, farray, parray, list)
 #include "sigcore/collections.h"
@@ -0,0 +1,109 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: dstack.h
+ * Description: Header file for the SigmaCore double-ended stack allocator
+ *
+ * DStack:  One reserved region that is allocated from both ends. Long-lived
+ *          data grows up from the bottom and temporaries grow down from the
+ *          top; each end is released LIFO by popping back to a marker, the
+ *          same way arena frames roll back. Memory is committed lazily from
+ *          each end, so a large capacity costs only address space.
+ */
+#pragma once
+
+#include "sigcore/allocator.h"
+#include "sigcore/types.h"
+
+// Opaque double-ended stack type
+typedef struct sc_dstack *dstack;
+
+// Position on one end of a dstack, as returned by DStack.mark
+typedef usize dstack_marker;
+
+// The two ends of a dstack
+typedef enum {
+   DSTACK_BOTTOM, // Grows up from the start of the region (persistent data)
+   DSTACK_TOP,    // Grows down from the end of the region (temporaries)
+} dstack_end;
+
+/* Public interface for double-ended stack operations           */
+/* ============================================================ */
+typedef struct sc_dstack_i {
+   /**
+    * @brief Create a double-ended stack over one reserved region.
+    * @param capacity Bytes shared by both ends (rounded up to the commit step)
+    * @return The new dstack, or NULL on failure
+    */
+   dstack (*create)(usize capacity);
+   /**
+    * @brief Release the region and everything allocated from either end.
+    * @param ds The dstack to dispose
+    */
+   void (*dispose)(dstack ds);
+   /**
+    * @brief Allocate from one end; allocations are aligned for any scalar type.
+    * @param ds The dstack to allocate from
+    * @param end DSTACK_BOTTOM or DSTACK_TOP
+    * @param size Size of the allocation in bytes
+    * @param zero If true, zero-initialize the memory
+    * @return Pointer to the allocation, or NULL if the ends would meet
+    */
+   object (*alloc)(dstack ds, dstack_end end, usize size, bool zero);
+   /**
+    * @brief Get the current position of one end.
+    * @param ds The dstack
+    * @param end DSTACK_BOTTOM or DSTACK_TOP
+    * @return Marker to pass to pop
+    */
+   dstack_marker (*mark)(dstack ds, dstack_end end);
+   /**
+    * @brief Release everything allocated on one end since a marker was taken.
+    * @param ds The dstack
+    * @param end The end the marker was taken from
+    * @param marker Marker returned by mark
+    * @return 0 on success, -1 if the marker lies past the end's current position
+    */
+   int (*pop)(dstack ds, dstack_end end, dstack_marker marker);
+   /**
+    * @brief Release everything allocated on one end.
+    * @param ds The dstack
+    * @param end DSTACK_BOTTOM or DSTACK_TOP
+    */
+   void (*reset)(dstack ds, dstack_end end);
+   /**
+    * @brief Get the number of bytes still free between the two ends.
+    * @param ds The dstack
+    * @return Free bytes (before alignment padding)
+    */
+   usize (*remaining)(dstack ds);
+   /**
+    * @brief Get an allocator that allocates from one end (free does nothing).
+    * @param ds The dstack
+    * @param end DSTACK_BOTTOM or DSTACK_TOP
+    * @return The end's allocator, or NULL if ds is NULL
+    */
+   allocator (*allocator)(dstack ds, dstack_end end);
+} sc_dstack_i;
+
+extern const sc_dstack_i DStack;
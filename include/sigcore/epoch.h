@@ -0,0 +1,113 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: epoch.h
+ * Description: Header file for SigmaCore epoch-based memory reclamation
+ *
+ * Epoch:  Lets lock-free readers traverse shared structures while writers
+ *         unlink and retire nodes. Readers bracket every access with
+ *         Epoch.enter / Epoch.exit (two atomic stores, no shared writes);
+ *         writers hand unlinked memory to Epoch.retire instead of freeing it.
+ *         Retired memory is released in batches once every thread inside a
+ *         read section has moved past the epoch it was retired in.
+ *         Each thread keeps its own retire lists (nodes come from a
+ *         per-thread pool), so retiring never contends with other threads.
+ */
+#pragma once
+
+#include "sigcore/scope.h"
+#include "sigcore/types.h"
+
+// Opaque reclamation domain: readers and writers of one set of structures share a domain
+typedef struct sc_epoch *epoch;
+
+/* Public interface for epoch-based reclamation                 */
+/* ============================================================ */
+typedef struct sc_epoch_i {
+   /**
+    * @brief Create a reclamation domain.
+    * @return The domain, or NULL on allocation failure
+    */
+   epoch (*create)(void);
+   /**
+    * @brief Release everything still retired in a domain and dispose it.
+    * @details No thread may be inside a read section or use the domain afterwards.
+    * @param domain The domain to dispose
+    */
+   void (*dispose)(epoch domain);
+   /**
+    * @brief Enter a read section; memory retired from now on outlives the section.
+    * @details Sections nest; only the outermost enter/exit pair publishes anything.
+    *          The first call on a thread registers it with the domain.
+    * @param domain The domain
+    * @return 0 on success, -1 if domain is NULL or the thread cannot be registered
+    */
+   int (*enter)(epoch domain);
+   /**
+    * @brief Leave a read section; pointers read inside it must not be used afterwards.
+    * @param domain The domain
+    */
+   void (*exit)(epoch domain);
+   /**
+    * @brief Release memory once no reader can still hold a pointer to it.
+    * @details The memory must already be unreachable for new readers. Every few
+    *          retirements the calling thread tries to advance the epoch and releases
+    *          its own batches that are old enough. Safe inside or outside a read section.
+    * @param domain The domain
+    * @param ptr Memory to release
+    * @param size Size passed back to release
+    * @param release Releases the memory, or NULL for Memory.dispose
+    * @return 0 on success, -1 if an argument is invalid or the thread cannot be registered
+    */
+   int (*retire)(epoch domain, object ptr, usize size, scope_release_fn release);
+   /**
+    * @brief Try to advance the epoch and release the calling thread's eligible batches.
+    * @param domain The domain
+    * @return Number of retired objects released
+    */
+   usize (*reclaim)(epoch domain);
+   /**
+    * @brief Wait until everything the calling thread retired has been released.
+    * @details Spins while other threads finish their read sections; must not be
+    *          called from inside a read section.
+    * @param domain The domain
+    * @return Number of retired objects released, or 0 if called inside a read section
+    */
+   usize (*synchronize)(epoch domain);
+   /**
+    * @brief Unregister the calling thread from a domain it no longer uses.
+    * @details Objects the thread retired stay pending and are released by the next
+    *          thread that takes over its slot, or when the domain is disposed. A thread
+    *          that exits is detached from every domain automatically, even from inside
+    *          a read section.
+    * @param domain The domain
+    */
+   void (*detach)(epoch domain);
+   /**
+    * @brief Get the number of retired objects not yet released, across all threads.
+    * @param domain The domain
+    * @return Pending object count
+    */
+   usize (*pending)(epoch domain);
+} sc_epoch_i;
+extern const sc_epoch_i Epoch;
@@ -39,6 +39,7 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/collection.h"
 #include "sigcore/types.h"
 
@@ -55,6 +56,13 @@ typedef struct sc_farray_i {
     * @param stride Size of each element in the array
     */
    farray (*new)(usize, usize);
+   /**
+    * @brief Initialize a new array whose memory comes from the given allocator.
+    * @param capacity Initial array capacity
+    * @param stride Size of each element in the array
+    * @param alloc Allocator for the array and its bucket (NULL = current scope's)
+    */
+   farray (*new_with)(usize, usize, allocator);
    /**
     * @brief Initialize an array with the specified capacity.
     * @param arr The array to initialize
@@ -45,6 +45,13 @@ typedef struct sc_list_i {
     * @param stride Size of each element in the list
     */
    list (*new)(usize, usize);
+   /**
+    * @brief Create a new list whose memory, including growth, comes from the given allocator.
+    * @param capacity Initial list capacity
+    * @param stride Size of each element in the list
+    * @param alloc Allocator for the list (NULL = current scope's)
+    */
+   list (*new_with)(usize, usize, allocator);
    /**
     * @brief Dispose of the list and free associated resources.
     * @param lst The list to dispose of
@@ -27,12 +27,38 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/arena.h"
+#include "sigcore/scope.h"
 #include "sigcore/types.h"
 
 // Opaque pool type
 typedef struct sc_pool *pool;
 
+// Pool creation options (see Memory.Pool.create_ex)
+typedef struct sc_pool_opts {
+   usize initial_pages; // Pages created up front (at least 1)
+   bool numa_bind;      // Bind pages to numa_node (ignored where the node or NUMA policy is unavailable)
+   int numa_node;       // Node for numa_bind, or NUMA_NODE_LOCAL
+} pool_opts;
+
+// Page cache counters (see Memory.Cache)
+typedef struct sc_page_cache_stats {
+   usize hits;          // Pages served from a cache level
+   usize misses;        // Pages that fell through to the system allocator
+   usize releases;      // Pages handed back by arenas and pools
+   usize evictions;     // Released pages freed because the caches were full
+   usize global_chunks; // Pages currently held by the global cache
+   usize global_bytes;  // Bytes currently held by the global cache
+   usize thread_bytes;  // Bytes currently held by the calling thread's cache
+} page_cache_stats;
+
+// Counters of one allocation tag (see Memory.Tag)
+typedef struct sc_memory_tag_stats {
+   usize live_bytes;  // Bytes currently held by allocations charged to the tag
+   usize allocations; // Allocations charged to the tag since startup
+} memory_tag_stats;
+
 /* Public interface for memory operations                        */
 /* ============================================================= */
 typedef struct sc_memory_i {
@@ -60,18 +86,37 @@ typedef struct sc_memory_i {
     * @return Pointer to the reallocated memory block, or NULL on failure
     */
    object (*realloc)(object, usize);
+   /**
+    * @brief Get the allocator backed by the root pool (Memory.alloc/dispose).
+    * @return The root pool allocator
+    */
+   allocator (*allocator)(void);
+   /**
+    * @brief Limit the bytes of pages held by the root pool (Memory.alloc).
+    * @details Checked only when the pool grows: Memory.alloc returns NULL at once
+    *          when a new page would pass budget->hard, and crossing budget->soft calls
+    *          budget->on_soft with the root pool locked (the callback must not use
+    *          Memory.alloc or Memory.dispose).
+    * @param budget The budget (copied), or NULL to remove it
+    * @return 0 on success, -1 on failure
+    */
+   int (*set_budget)(const scope_budget *budget);
+   /**
+    * @brief Print live bytes and allocation counts of every defined tag to stdout.
+    */
+   void (*report_tags)(void);
 
    /**
     * @brief Scope management operations for transferring object ownership between scopes.
     */
    struct {
       /**
-       * @brief Get the current active scope for allocations.
+       * @brief Get the current active scope for allocations on the calling thread.
        * @return Current scope, or NULL if no scope is active
        */
       void *(*get_current)(void);
       /**
-       * @brief Set the current active scope for allocations.
+       * @brief Set the current active scope for allocations on the calling thread.
        * @param scope The scope to make current, or NULL to clear
        */
       void (*set_current)(void *scope);
@@ -99,8 +144,142 @@ typedef struct sc_memory_i {
        * @return Pointer to the copied data in external memory, or NULL if export fails
        */
       object (*export)(void *scope, const void *data, usize size);
+      /**
+       * @brief Hand an external buffer to a scope without copying it.
+       * @details The scope calls `release` when it ends: arenas on reset and dispose,
+       *          frames on end_frame (unless promoted with Arena.promote_all). Buffers
+       *          are released in reverse order of adoption. Pools do not adopt.
+       * @param scope The scope taking ownership
+       * @param ptr The buffer to adopt
+       * @param size Size of the buffer in bytes (passed back to release)
+       * @param release Function that releases the buffer
+       * @return 0 on success, -1 on failure (the caller keeps ownership)
+       */
+      int (*adopt)(void *scope, object ptr, usize size, scope_release_fn release);
+      /**
+       * @brief Make a scope current for the calling thread, saving the previous one.
+       * @param scope The scope to make current (may be NULL)
+       * @return 0 on success, -1 if the thread's scope stack is full
+       */
+      int (*push)(void *scope);
+      /**
+       * @brief Restore the scope that was current before the matching push.
+       * @return The scope that was current before the pop, or NULL if the stack is empty
+       */
+      void *(*pop)(void);
+      /**
+       * @brief Get the calling thread's default arena, creating it on first use.
+       * @details The arena is private to the thread and disposed when the thread exits.
+       *          Workers opt in with Memory.Scope.push(Memory.Scope.thread_arena()).
+       * @return The thread's arena, or NULL if it could not be created
+       */
+      arena (*thread_arena)(void);
+      /**
+       * @brief Begin a frame on one of the calling thread's two scratch arenas.
+       * @details The returned frame never lives in `conflict`, so a function can keep
+       *          its results in an output arena and use scratch space for temporaries.
+       *          Allocate through Arena.get_frame_arena and release with Arena.end_frame.
+       * @param conflict Arena that must not be used for scratch (may be NULL)
+       * @return A frame on a scratch arena; its slot is NULL on failure
+       */
+      frame (*scratch)(arena conflict);
+      /**
+       * @brief Get the allocator of the calling thread's current scope.
+       * @details Collections created without an explicit allocator capture this one.
+       * @return The current arena's (or frame's arena's) allocator, or the root pool allocator
+       */
+      allocator (*allocator)(void);
+      /**
+       * @brief Set up a user-defined scope so it can be made current.
+       * @details Embed an sc_scope as the first member of the scope structure; once
+       *          set up, the scope can be passed to set_current, push, move and import.
+       * @param scope Header at the start of the user's scope
+       * @param ops Dispatch table (alloc is required; track/untrack may be NULL)
+       * @return 0 on success, -1 on failure
+       */
+      int (*init)(sc_scope *scope, const scope_ops *ops);
    } Scope;
 
+   /**
+    * @brief Allocation tags: cheap per-subsystem byte and allocation counters.
+    * @details Memory.alloc charges the calling thread's tag. Arenas and pools charge
+    *          their scope tag, which is the creating thread's tag unless changed
+    *          with set_scope; their bytes return to the tag on free, reset, end_frame
+    *          and dispose. Arena bookkeeping is charged to the untagged tag 0.
+    */
+   struct {
+      /**
+       * @brief Register a named tag.
+       * @param name Name shown by Memory.report_tags (copied, truncated to 31 characters)
+       * @return The new tag, or 0 (untagged) if all MEMORY_TAG_MAX tags are in use
+       */
+      memory_tag (*define)(const char *name);
+      /**
+       * @brief Set the calling thread's tag.
+       * @param tag Tag to charge from now on (0 = untagged)
+       * @return The previous tag, to restore when the subsystem is done
+       */
+      memory_tag (*set)(memory_tag tag);
+      /**
+       * @brief Get the calling thread's tag.
+       * @return The current tag
+       */
+      memory_tag (*get)(void);
+      /**
+       * @brief Charge an arena, pool or user scope to a tag; bytes it holds move along.
+       * @param scope The scope to retag (frames are charged through their arena)
+       * @param tag The tag
+       * @return 0 on success, -1 if the scope or tag is invalid
+       */
+      int (*set_scope)(void *scope, memory_tag tag);
+      /**
+       * @brief Get a snapshot of one tag's counters.
+       * @details Counters are kept per thread and summed here, so charging costs no
+       *          shared atomic; a snapshot taken while other threads allocate is not
+       *          a single point in time.
+       * @param tag The tag
+       * @param stats Receives the counters
+       * @return 0 on success, -1 if the tag is out of range or stats is NULL
+       */
+      int (*stats)(memory_tag tag, memory_tag_stats *stats);
+   } Tag;
+
+   /**
+    * @brief Allocator event tracing into per-thread rings, exported as Chrome trace JSON.
+    * @details While started, allocations and disposals (root pool and pools, arena
+    *          allocations), page growth and release, arena frame begin/end and
+    *          collection growth are timestamped into the recording thread's ring;
+    *          full rings overwrite their oldest events. A ring outlives its thread and
+    *          is taken over by the next thread that records. Stopped, each hook costs
+    *          one branch; building with -DSIGCORE_NO_TRACE removes the hooks entirely.
+    */
+   struct {
+      /**
+       * @brief Start recording.
+       * @param events_per_thread Ring size for threads that start recording from now on
+       *                          (rounded up to a power of two; 0 = 4096)
+       * @return 0 on success, -1 if the size is too large
+       */
+      int (*start)(usize events_per_thread);
+      /**
+       * @brief Stop recording; recorded events are kept for dump.
+       */
+      void (*stop)(void);
+      /**
+       * @brief Forget all recorded events; later timestamps count from now.
+       * @details Safe while other threads record: each ring is reset by its owner.
+       */
+      void (*clear)(void);
+      /**
+       * @brief Write recorded events as Chrome trace JSON (chrome://tracing, Perfetto).
+       * @details Frames appear as durations, everything else as instant events with
+       *          the address and size in args. Best taken while threads are quiet.
+       * @param path File to write
+       * @return 0 on success, -1 on I/O failure
+       */
+      int (*dump)(const char *path);
+   } Trace;
+
    /**
     * @brief Pool operations (v2 core memory pools).
     */
@@ -111,6 +290,32 @@ typedef struct sc_memory_i {
        * @return Pool handle, or NULL on failure
        */
       pool (*create)(usize initial_pages);
+      /**
+       * @brief Create a new memory pool with placement options.
+       * @details With opts->numa_bind, every page is bound to the node before it is
+       *          first touched; on machines without NUMA policy the pool is unbound.
+       * @param opts Pool creation options
+       * @return Pool handle, or NULL on failure
+       */
+      pool (*create_ex)(const pool_opts *opts);
+      /**
+       * @brief Count where the pool's resident memory physically lives.
+       * @param p Pool to query
+       * @param pages_per_node Array of `nodes` counters to fill (zeroed first)
+       * @param nodes Number of counters
+       * @return Number of resident OS pages found (0 if placement cannot be queried)
+       */
+      usize (*placement)(pool p, usize *pages_per_node, usize nodes);
+      /**
+       * @brief Limit the bytes of pages held by a pool.
+       * @details Checked only when the pool grows: an allocation needing a page past
+       *          budget->hard returns NULL at once; crossing budget->soft calls
+       *          budget->on_soft.
+       * @param p Pool to limit
+       * @param budget The budget (copied), or NULL to remove it
+       * @return 0 on success, -1 if the pool is NULL
+       */
+      int (*set_budget)(pool p, const scope_budget *budget);
       /**
        * @brief Destroy a memory pool.
        * @param p Pool to destroy
@@ -128,6 +333,26 @@ typedef struct sc_memory_i {
        * @return Arena handle, or NULL on failure
        */
       arena (*create)(usize initial_pages);
+      /**
+       * @brief Create a new arena with an explicit page growth policy.
+       * @details Pages start at opts->page_size and double with every new page up
+       *          to opts->max_page_size; requests larger than the cap fail. With
+       *          opts->reserve set, the arena is a single contiguous mapping of that
+       *          size, committed in opts->page_size steps (default 64 KB).
+       * @param opts Arena creation options
+       * @return Arena handle, or NULL on failure
+       */
+      arena (*create_ex)(const arena_opts *opts);
+      /**
+       * @brief Map an image written by Arena.save as a read-only arena.
+       * @details The image is mapped at its original address when that range is free
+       *          (no pointer fixups besides the allocator), otherwise relocated. The
+       *          arena rejects allocations and frames; dispose it to unmap the image.
+       * @param path Image file to load
+       * @param root Receives the root object passed to Arena.save (may be NULL)
+       * @return Arena handle, or NULL on failure
+       */
+      arena (*load)(const char *path, object *root);
       /**
        * @brief Dispose an arena.
        * @param a Arena to dispose
@@ -135,5 +360,26 @@ typedef struct sc_memory_i {
       void (*dispose)(arena a);
    } Arena;
 
+   /**
+    * @brief Process-wide page cache shared by all arenas and pools.
+    */
+   struct {
+      /**
+       * @brief Set the byte limits of the global cache and of each thread's cache.
+       * @param global_limit Maximum bytes held by the global cache
+       * @param thread_limit Maximum bytes held by each thread's cache
+       */
+      void (*configure)(usize global_limit, usize thread_limit);
+      /**
+       * @brief Get a snapshot of the page cache counters.
+       * @param stats Receives the counters
+       */
+      void (*stats)(page_cache_stats *stats);
+      /**
+       * @brief Release all pages held by the global cache and the calling thread's cache.
+       */
+      void (*trim)(void);
+   } Cache;
+
 } sc_memory_i;
 extern const sc_memory_i Memory;
\ No newline at end of file
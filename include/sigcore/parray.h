@@ -38,6 +38,7 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/collection.h"
 #include "sigcore/types.h"
 
@@ -53,6 +54,12 @@ typedef struct sc_parray_i {
     * @param capacity Initial array capacity
     */
    parray (*new)(usize);
+   /**
+    * @brief Initialize a new array whose memory comes from the given allocator.
+    * @param capacity Initial array capacity
+    * @param alloc Allocator for the array and its bucket (NULL = current scope's)
+    */
+   parray (*new_with)(usize, allocator);
    /**
     * @brief Initialize an array with the specified capacity.
     * @param arr The array to initialize
@@ -26,8 +26,94 @@
  */
 #pragma once
 
+#include "sigcore/allocator.h"
 #include "sigcore/types.h"
 
+// Handle shared by all scopes set up with Memory.Scope.init
+#define SCOPE_HANDLE_USER "USR"
+
+// Releases a buffer adopted by a scope (e.g. a wrapper around free or munmap)
+typedef void (*scope_release_fn)(object ptr, usize size);
+
+// Allocation tag from Memory.Tag.define (0 = untagged)
+typedef uint16_t memory_tag;
+// Number of tags, including the untagged tag 0
+#define MEMORY_TAG_MAX 64
+
+// Called when a scope's reserved bytes cross its soft budget
+typedef void (*scope_budget_fn)(void *scope, usize reserved, usize soft_limit);
+
+// Byte budget on the memory a scope reserves from the system (0 = no limit)
+typedef struct sc_scope_budget {
+   usize soft;              // Growing past this calls on_soft (once per crossing)
+   usize hard;              // Growth that would pass this fails immediately
+   scope_budget_fn on_soft; // Runs inside the growing allocation: must not allocate from the scope (may be NULL)
+} scope_budget;
+
+/* Scope dispatch table                                         */
+/* ============================================================ */
+typedef struct sc_scope_ops {
+   /**
+    * @brief Allocate memory owned by the scope.
+    * @param scope The scope
+    * @param size Size of the allocation in bytes
+    * @param zero If true, zero-initialize the memory
+    * @return Pointer to the allocated memory, or NULL on failure
+    */
+   object (*alloc)(void *scope, usize size, bool zero);
+   /**
+    * @brief Release a block allocated by the scope (may do nothing for bulk scopes).
+    * @param scope The scope
+    * @param ptr The block to release
+    */
+   void (*free)(void *scope, object ptr);
+   /**
+    * @brief Resize a block allocated by the scope.
+    * @param scope The scope
+    * @param ptr The block to resize (NULL allocates)
+    * @param old_size Current size of the block in bytes
+    * @param new_size Requested size in bytes
+    * @return Pointer to the resized block, or NULL on failure
+    */
+   object (*realloc)(void *scope, object ptr, usize old_size, usize new_size);
+   /**
+    * @brief Take ownership of an object (NULL if the scope cannot own foreign objects).
+    * @param scope The scope
+    * @param ptr The object to track
+    * @return 0 on success, -1 on failure
+    */
+   int (*track)(void *scope, object ptr);
+   /**
+    * @brief Give up ownership of an object (NULL if the scope cannot own foreign objects).
+    * @param scope The scope
+    * @param ptr The object to untrack
+    * @return 0 on success, -1 if the scope does not own the object
+    */
+   int (*untrack)(void *scope, object ptr);
+   /**
+    * @brief Take ownership of an external buffer without copying it (NULL if unsupported).
+    * @param scope The scope
+    * @param ptr The buffer to adopt
+    * @param size Size of the buffer in bytes
+    * @param release Called with ptr and size when the scope releases the buffer
+    * @return 0 on success, -1 on failure
+    */
+   int (*adopt)(void *scope, object ptr, usize size, scope_release_fn release);
+} scope_ops;
+
+/**
+ * @brief Header at the start of every scope (arenas, frames, pools and user scopes).
+ * @details Allocation through the current scope is one call through `ops`. A
+ *          user-defined scope embeds this header as its first member and sets it
+ *          up with Memory.Scope.init.
+ */
+typedef struct sc_scope {
+   char handle[4];          // Scope identifier: "ARN", "FRM", "POL" or SCOPE_HANDLE_USER
+   memory_tag tag;          // Tag charged for the scope's memory (the creating thread's tag)
+   const scope_ops *ops;    // Dispatch table
+   sc_allocator allocator;  // ops->alloc/free/realloc bound to this scope
+} sc_scope;
+
 /**
  * @brief Transfer ownership of an object from one scope to another.
  *
@@ -48,9 +134,10 @@
  * ✅ Arena ↔ Arena
  * ✅ Frame ↔ Arena
  * ✅ Frame ↔ Frame
+ * ✅ Any scope whose ops implement track and untrack
  *
- * @param from Source scope (arena or frame)
- * @param to   Destination scope (arena or frame)
+ * @param from Source scope
+ * @param to   Destination scope
  * @param obj  Object to transfer
  * @return 0 on success, -1 on failure
  */
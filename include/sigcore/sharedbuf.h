@@ -0,0 +1,100 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: sharedbuf.h
+ * Description: Header file for SigmaCore reference-counted shared buffers
+ *
+ * SharedBuffer:  Immutable bytes handed between threads without copying. A
+ *                buffer takes ownership of memory (an FArray bucket, a string,
+ *                or any block from an allocator) and counts references
+ *                atomically; every holder reads the same bytes, and the last
+ *                release returns the memory to the allocator it came from.
+ *                Nobody may write to the bytes once the buffer is shared.
+ */
+#pragma once
+
+#include "sigcore/allocator.h"
+#include "sigcore/farray.h"
+#include "sigcore/types.h"
+
+// Opaque handle; each retain/release pair is one reference
+typedef struct sc_shared_buffer *shared_buffer;
+
+/* Public interface for shared buffers                          */
+/* ============================================================ */
+typedef struct sc_shared_buffer_i {
+   /**
+    * @brief Share a block of memory, taking ownership of it (one reference).
+    * @param data The block (must come from alloc)
+    * @param size Bytes of the block visible through the buffer
+    * @param alloc Allocator the block is returned to, or NULL for Memory (root pool);
+    *              it is called from whichever thread drops the last reference
+    * @return The buffer, or NULL on failure (data is then still owned by the caller)
+    */
+   shared_buffer (*wrap)(object data, usize size, allocator alloc);
+   /**
+    * @brief Share an FArray's bucket without copying; the array itself is disposed.
+    * @param arr The array (the handle must not be used afterwards)
+    * @return The buffer covering the whole bucket, or NULL on failure (arr is then untouched)
+    */
+   shared_buffer (*from_farray)(farray arr);
+   /**
+    * @brief Share a string from String.dupe/copy/concat/format without copying.
+    * @details Those functions allocate from the scope current when they ran, so pass
+    *          that scope's allocator (Memory.Scope.allocator() at the time).
+    * @param str The string (must not be disposed by the caller afterwards)
+    * @param alloc Allocator the string came from, or NULL for the current scope's
+    * @return The buffer covering the string and its terminator, or NULL on failure
+    */
+   shared_buffer (*from_string)(string str, allocator alloc);
+   /**
+    * @brief Add a reference, e.g. before handing the buffer to another thread.
+    * @param buf The buffer
+    * @return buf
+    */
+   shared_buffer (*retain)(shared_buffer buf);
+   /**
+    * @brief Drop a reference; the last one frees the memory through its allocator.
+    * @param buf The buffer (must not be used by this holder afterwards)
+    */
+   void (*release)(shared_buffer buf);
+   /**
+    * @brief Get the shared bytes (read-only).
+    * @param buf The buffer
+    * @return Pointer to the bytes, or NULL if buf is NULL
+    */
+   const void *(*data)(shared_buffer buf);
+   /**
+    * @brief Get the number of shared bytes.
+    * @param buf The buffer
+    * @return Size in bytes
+    */
+   usize (*size)(shared_buffer buf);
+   /**
+    * @brief Get the current reference count (a snapshot while other threads hold it).
+    * @param buf The buffer
+    * @return Number of references
+    */
+   usize (*refs)(shared_buffer buf);
+} sc_shared_buffer_i;
+extern const sc_shared_buffer_i SharedBuffer;
@@ -0,0 +1,308 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: shmem.h
+ * Description: Header file for SigmaCore cross-process shared memory regions
+ *
+ * ShmRegion:  A bump-allocated region in a memfd or shm_open mapping that
+ *             several processes map at different addresses. Everything in
+ *             the region refers to everything else by shm_offset (bytes from
+ *             the region start), never by pointer, so one copy of the data is
+ *             valid in every process without serialization.
+ * ShmFArray, ShmList, ShmSlotArray:
+ *             Offset-based counterparts of FArray, List and SlotArray whose
+ *             headers and storage live inside a region. Growth allocates new
+ *             storage from the region (the old storage is not reused).
+ *             Collections assume one writer; readers may map the region
+ *             read-mostly from any number of processes.
+ */
+#pragma once
+
+#include "sigcore/types.h"
+
+// Opaque process-local handle on a mapped region
+typedef struct sc_shm_region *shm_region;
+
+// Position of an object inside a region, in bytes from its start (0 = none)
+typedef uint64_t shm_offset;
+
+// Offset-based collections (each is the offset of its header in the region)
+typedef shm_offset shm_farray;
+typedef shm_offset shm_list;
+typedef shm_offset shm_slotarray;
+
+/* Public interface for shared memory regions                   */
+/* ============================================================ */
+typedef struct sc_shm_region_i {
+   /**
+    * @brief Create a region in a new shared memory object and map it.
+    * @param name shm_open name ("/name"; fails if it exists), or NULL for an anonymous
+    *             memfd shared with children or passed on with ShmRegion.fd
+    * @param capacity Bytes of the region, header included (fixed for its lifetime)
+    * @return The region, or NULL on failure
+    */
+   shm_region (*create)(const char *name, usize capacity);
+   /**
+    * @brief Map an existing named region.
+    * @param name shm_open name given to create
+    * @return The region, or NULL if it does not exist or is not a region
+    */
+   shm_region (*open)(const char *name);
+   /**
+    * @brief Map a region from a descriptor (e.g. an inherited memfd).
+    * @param fd Descriptor of the shared memory object (duplicated; the caller keeps fd)
+    * @return The region, or NULL if the object is not a region
+    */
+   shm_region (*open_fd)(int fd);
+   /**
+    * @brief Unmap a region from this process; the data lives while others map it.
+    * @param region The region to close
+    */
+   void (*close)(shm_region region);
+   /**
+    * @brief Remove a region's name; existing mappings stay valid.
+    * @param name shm_open name given to create
+    * @return 0 on success, -1 on failure
+    */
+   int (*unlink)(const char *name);
+   /**
+    * @brief Get the region's descriptor, e.g. to pass to another process.
+    * @param region The region
+    * @return The descriptor, or -1 if region is NULL
+    */
+   int (*fd)(shm_region region);
+   /**
+    * @brief Allocate zeroed bytes from the region (safe across processes).
+    * @param region The region
+    * @param size Bytes to allocate (aligned for any scalar type)
+    * @return Offset of the allocation, or 0 if the region is full
+    */
+   shm_offset (*alloc)(shm_region region, usize size);
+   /**
+    * @brief Turn an offset into a pointer valid in this process.
+    * @param region The region
+    * @param offset Offset inside the region
+    * @return Pointer, or NULL for offset 0 or an offset past the region
+    */
+   object (*at)(shm_region region, shm_offset offset);
+   /**
+    * @brief Turn a pointer into this process's mapping into an offset.
+    * @param region The region
+    * @param ptr Pointer inside the region
+    * @return Offset, or 0 if ptr is outside the region
+    */
+   shm_offset (*offset_of)(shm_region region, object ptr);
+   /**
+    * @brief Publish the region's root object (e.g. the table other processes look up).
+    * @param region The region
+    * @param offset Offset of the root object (0 clears it)
+    */
+   void (*set_root)(shm_region region, shm_offset offset);
+   /**
+    * @brief Get the region's root object.
+    * @param region The region
+    * @return Offset of the root object, or 0 if none was published
+    */
+   shm_offset (*root)(shm_region region);
+   /**
+    * @brief Get the number of bytes allocated from the region, header included.
+    * @param region The region
+    * @return Bytes in use
+    */
+   usize (*used)(shm_region region);
+} sc_shm_region_i;
+
+/* Offset-based fixed array (FArray)                            */
+/* ============================================================ */
+typedef struct sc_shm_farray_i {
+   /**
+    * @brief Create a zeroed fixed array in a region.
+    * @param region The region
+    * @param capacity Number of elements
+    * @param stride Size of each element in bytes
+    * @return The array, or 0 on failure
+    */
+   shm_farray (*new)(shm_region region, usize capacity, usize stride);
+   /**
+    * @brief Get the number of elements.
+    * @param region The region holding the array
+    * @param arr The array
+    * @return Capacity, or 0 if arr is invalid
+    */
+   usize (*capacity)(shm_region region, shm_farray arr);
+   /**
+    * @brief Copy a value into an element.
+    * @param region The region holding the array
+    * @param arr The array
+    * @param index Element index
+    * @param value Pointer to stride bytes to copy
+    * @return 0 on success, -1 on failure
+    */
+   int (*set)(shm_region region, shm_farray arr, usize index, const void *value);
+   /**
+    * @brief Copy an element out.
+    * @param region The region holding the array
+    * @param arr The array
+    * @param index Element index
+    * @param out Receives stride bytes
+    * @return 0 on success, -1 on failure
+    */
+   int (*get)(shm_region region, shm_farray arr, usize index, object out);
+   /**
+    * @brief Get a pointer to an element in this process's mapping (no copy).
+    * @param region The region holding the array
+    * @param arr The array
+    * @param index Element index
+    * @return Pointer to the element, or NULL on failure
+    */
+   object (*at)(shm_region region, shm_farray arr, usize index);
+} sc_shm_farray_i;
+
+/* Offset-based list of offsets (List)                          */
+/* ============================================================ */
+typedef struct sc_shm_list_i {
+   /**
+    * @brief Create an empty list in a region.
+    * @param region The region
+    * @param capacity Initial capacity (at least 1)
+    * @return The list, or 0 on failure
+    */
+   shm_list (*new)(shm_region region, usize capacity);
+   /**
+    * @brief Get the number of items.
+    * @param region The region holding the list
+    * @param lst The list
+    * @return Item count, or 0 if lst is invalid
+    */
+   usize (*size)(shm_region region, shm_list lst);
+   /**
+    * @brief Get the number of items the list holds before it grows.
+    * @param region The region holding the list
+    * @param lst The list
+    * @return Capacity, or 0 if lst is invalid
+    */
+   usize (*capacity)(shm_region region, shm_list lst);
+   /**
+    * @brief Append an item, growing the list from the region when full.
+    * @param region The region holding the list
+    * @param lst The list
+    * @param value Offset to store
+    * @return 0 on success, -1 on failure
+    */
+   int (*append)(shm_region region, shm_list lst, shm_offset value);
+   /**
+    * @brief Get an item.
+    * @param region The region holding the list
+    * @param lst The list
+    * @param index Item index
+    * @param out Receives the offset
+    * @return 0 on success, -1 on failure
+    */
+   int (*get)(shm_region region, shm_list lst, usize index, shm_offset *out);
+   /**
+    * @brief Replace an item.
+    * @param region The region holding the list
+    * @param lst The list
+    * @param index Item index
+    * @param value Offset to store
+    * @return 0 on success, -1 on failure
+    */
+   int (*set)(shm_region region, shm_list lst, usize index, shm_offset value);
+   /**
+    * @brief Remove an item, shifting the following items down.
+    * @param region The region holding the list
+    * @param lst The list
+    * @param index Item index
+    * @return 0 on success, -1 on failure
+    */
+   int (*remove)(shm_region region, shm_list lst, usize index);
+   /**
+    * @brief Remove all items (capacity is kept).
+    * @param region The region holding the list
+    * @param lst The list
+    */
+   void (*clear)(shm_region region, shm_list lst);
+} sc_shm_list_i;
+
+/* Offset-based slot array (SlotArray)                          */
+/* ============================================================ */
+typedef struct sc_shm_slotarray_i {
+   /**
+    * @brief Create an empty slot array in a region.
+    * @param region The region
+    * @param capacity Initial number of slots (at least 1)
+    * @return The slot array, or 0 on failure
+    */
+   shm_slotarray (*new)(shm_region region, usize capacity);
+   /**
+    * @brief Store an offset in the first empty slot, growing when all are taken.
+    * @param region The region holding the slot array
+    * @param slots The slot array
+    * @param value Offset to store (must not be 0, which marks empty slots)
+    * @return Slot index, or -1 on failure
+    */
+   int (*add)(shm_region region, shm_slotarray slots, shm_offset value);
+   /**
+    * @brief Get the offset in a slot.
+    * @param region The region holding the slot array
+    * @param slots The slot array
+    * @param index Slot index
+    * @param out Receives the offset
+    * @return 0 on success, -1 if the slot is empty or out of range
+    */
+   int (*get_at)(shm_region region, shm_slotarray slots, usize index, shm_offset *out);
+   /**
+    * @brief Empty a slot; its index may be handed out again by add.
+    * @param region The region holding the slot array
+    * @param slots The slot array
+    * @param index Slot index
+    * @return 0 on success, -1 if the slot is out of range
+    */
+   int (*remove_at)(shm_region region, shm_slotarray slots, usize index);
+   /**
+    * @brief Check whether a slot is empty.
+    * @param region The region holding the slot array
+    * @param slots The slot array
+    * @param index Slot index
+    * @return true if the slot is empty or out of range
+    */
+   bool (*is_empty_slot)(shm_region region, shm_slotarray slots, usize index);
+   /**
+    * @brief Get the number of slots.
+    * @param region The region holding the slot array
+    * @param slots The slot array
+    * @return Slot count, or 0 if slots is invalid
+    */
+   usize (*capacity)(shm_region region, shm_slotarray slots);
+   /**
+    * @brief Empty every slot.
+    * @param region The region holding the slot array
+    * @param slots The slot array
+    */
+   void (*clear)(shm_region region, shm_slotarray slots);
+} sc_shm_slotarray_i;
+
+extern const sc_shm_region_i ShmRegion;
+extern const sc_shm_farray_i ShmFArray;
+extern const sc_shm_list_i ShmList;
+extern const sc_shm_slotarray_i ShmSlotArray;
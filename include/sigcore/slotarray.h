@@ -47,6 +47,13 @@ typedef struct sc_slotarray_i {
     * @return A pointer to the newly created SlotArray, or NULL on ERRure.
     */
    slotarray (*new)(usize);
+   /**
+    * @brief Create a new SlotArray whose memory comes from the given allocator.
+    * @param capacity The initial number of slots to allocate.
+    * @param alloc Allocator for the SlotArray (NULL = current scope's).
+    * @return A pointer to the newly created SlotArray, or NULL on failure.
+    */
+   slotarray (*new_with)(usize, allocator);
    /**
     * @brief Dispose of the SlotArray and free its resources.
     * @param sa The SlotArray to dispose.
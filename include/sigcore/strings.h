@@ -47,6 +47,7 @@ int string_compare(const string, const string);
 
 /* IStringBuilder Helpers */
 string_builder stringbuilder_new(size_t);
+string_builder stringbuilder_new_with(size_t, allocator);
 string_builder stringbuilder_from_string(string);
 size_t stringbuilder_length(string_builder);
 void stringbuilder_append(string_builder, string);
@@ -68,6 +69,7 @@ typedef struct sc_string_i {
 /* IStringBuilder interface */
 typedef struct sc_stringbuilder_i {
    string_builder (*new)(size_t capacity);        /**< Initializes with a starting capacity. */
+   string_builder (*new_with)(size_t, allocator); /**< Initializes with a capacity and allocator (NULL = current scope's). */
    string_builder (*snew)(string);                /**< Initializes a new string builder from char* buffer. */
    void (*append)(string_builder, string);        /**< Appends a string to the buffer. */
    void (*appendf)(string_builder, string, ...);  /**< Appends a formatted string using printf-style specifiers. */
@@ -25,67 +25,183 @@
  * Description: SigmaCore arena memory management implementation
  */
 #include "sigcore/arena.h"
+#include "internal/collections.h"
 #include "internal/memory_internal.h"
+#include "internal/page_cache.h"
+#include "internal/trace.h"
+#include "internal/vmem.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// Page data size constant (4KB as per design)
+// Default page data size (4KB as per design)
 #define PAGE_DATA_SIZE 4096
+// Maximum number of nested frames held inline by an arena
+#define ARENA_FRAME_DEPTH 16
+// Alignment of every arena allocation (page data starts aligned to it)
+#define ARENA_ALIGN _Alignof(max_align_t)
+
+// Arena image files: header, relocation table, then the page body at a page-aligned offset
+#define ARENA_IMAGE_MAGIC "SCARENA"
+#define ARENA_IMAGE_VERSION 2
+// Relocation entries with this bit point at the arena's allocator instead of into the image
+#define ARENA_IMAGE_RELOC_ALLOCATOR ((uint64_t)1 << 63)
+#define ARENA_IMAGE_NO_ROOT UINT64_MAX
+
+// On-disk image header
+struct arena_image_header {
+   char magic[8];        // ARENA_IMAGE_MAGIC
+   uint64_t version;     // ARENA_IMAGE_VERSION
+   uint64_t base;        // Address of the page (mapping start) when saved
+   uint64_t data_offset; // Offset of the page data from the page start
+   uint64_t size;        // Bytes from the page start to the end of used data
+   uint64_t used;        // Bytes allocated in the page
+   uint64_t root;        // Offset of the root object from base, or ARENA_IMAGE_NO_ROOT
+   uint64_t reloc_count; // Entries in the relocation table
+   uint64_t body_offset; // Page-aligned file offset of the body
+};
 
 // Internal page structure
 struct sc_page {
    struct sc_page *next;      // Chain to next page
    void *bump;                // Current bump pointer
    usize used;                // Bytes used in data area
-   char data[PAGE_DATA_SIZE]; // Data area for allocations
+   usize capacity;            // Size of the data area
+   usize mapped;              // Size of the reserved mapping holding this page (0 = heap page)
+   usize committed;           // Accessible bytes of the mapping, header included
+   int node;                  // NUMA node the data is bound to (-1 = default policy)
+   char *data;                // Data area: OS-page aligned heap chunk, or right after the header when mapped
 };
 
-// Internal arena structure
-struct sc_arena {
-   char handle[4];           // Scope identifier: "ARN\0"
-   sc_page *root_pages;      // Head of permanent pages chain
-   sc_page *current_page;    // Active page for allocations
-   struct block *alloc_head; // Head of allocation block list
-   struct block *alloc_tail; // Tail of allocation block list
-   usize page_count;         // Total number of pages
-   frame frame_stack;        // Stack of active frames (linked list)
-   pool root_pool;           // Root pool for block allocation
+// External buffer adopted by an arena or frame, or a call deferred to the end of a frame;
+// both run in LIFO order
+struct arena_finalizer {
+   struct arena_finalizer *next; // Previously registered entry
+   object ptr;                   // Adopted buffer, or the deferred call's argument
+   usize size;                   // Buffer size passed back to release
+   scope_release_fn release;     // Releases the buffer (NULL for a deferred call)
+   frame_defer_fn defer;         // Deferred call; the entry is allocated in the arena itself
+};
+
+// Pointer fixup for Arena.save, expanded into relocation entries when the image is written
+enum arena_pin_kind {
+   ARENA_PIN_SLOT,      // A single pointer field
+   ARENA_PIN_FARRAY,    // An farray header
+   ARENA_PIN_LIST,      // A list, its collection and optionally its elements
+   ARENA_PIN_SLOTARRAY, // A slotarray, its parray and optionally its elements
+};
+struct arena_pin {
+   struct arena_pin *next; // Previously registered pin
+   object target;          // Pinned field or structure inside the arena
+   enum arena_pin_kind kind;
+   bool elements;          // Lists and slotarrays: relocate the stored pointers too
 };
 
-// Internal frame structure
+// Internal frame structure: a rollback marker stored inline in its arena
 struct sc_frame {
-   char handle[4];           // Scope identifier: "FRM\0"
+   sc_scope scope;           // Scope header: "FRM"
    sc_arena *arena;          // Arena this frame belongs to
    sc_page *start_page;      // Page where frame began
    void *bump_start;         // Bump pointer position at frame start
-   struct block *tail_start; // Allocation tail at frame start
-   frame next;               // Next frame in stack (more nested)
-   bool valid;               // Whether this frame is still valid (not disposed)
+   struct block *tail_start; // Allocation tail at the rollback marker
+   struct block *tail_origin; // Allocation tail at frame start (before any promotion)
+   usize used_start;         // Arena bytes used at frame start
+   usize waste_start;        // Arena tail waste at frame start
+   struct arena_finalizer *finalizer_start; // Adopted buffers that outlive the frame
+   usize generation;         // Arena begin count when the frame began (handles must match)
+   usize depth;              // Position in the arena's frame stack
+   bool valid;               // Whether this frame is still valid (not ended)
+};
+
+// Internal arena structure
+struct sc_arena {
+   sc_scope scope;                    // Scope header: "ARN"; its allocator is Arena.allocator
+   sc_page *root_pages;               // Oldest page; pages chain in allocation order
+   sc_page *current_page;             // Active page for allocations (later pages are empty)
+   struct block *alloc_head;          // Head of allocation block list
+   struct block *alloc_tail;          // Tail of allocation block list
+   struct arena_finalizer *finalizers; // Adopted buffers, most recent first
+   struct arena_finalizer *finalizers_tail; // Oldest adopted buffer
+   usize page_count;                  // Total number of pages
+   usize used;                        // Bytes handed out across all pages
+   usize reserved;                    // Data bytes of all pages
+   usize tail_waste;                  // Bytes left unused at the end of skipped pages
+   usize peak;                        // High-water mark of used
+   usize tracked_blocks;              // Entries in the allocation block list
+   usize next_page_size;              // Data size of the next page to create
+   usize max_page_size;               // Growth cap for next_page_size
+   usize commit_step;                 // Commit granularity of a reserved arena
+   bool prefault;                     // Populate committed pages up front
+   bool huge_pages;                   // Advise transparent huge pages on each commit
+   int numa_node;                     // NUMA node new pages are bound to (-1 = not bound)
+   scope_budget budget;               // Limits on reserved (zeroed = unlimited)
+   int fork_fd;                       // memfd behind a forkable reserved arena (-1 = not forkable)
+   sc_frame fork_mark;                // State at Arena.fork (valid while a fork is open)
+   usize fork_reserved;               // Reserved bytes at Arena.fork
+   usize frame_depth;                 // Number of active frames
+   usize frame_generation;            // Frames begun so far
+   sc_frame frames[ARENA_FRAME_DEPTH]; // Inline frame stack (most nested at frame_depth - 1)
+   sc_arena *merged_into;             // Arena this one was merged into (handle is then a forwarder)
+   sc_arena *absorbed;                // Headers of arenas merged into this one
+   sc_arena *next_absorbed;           // Sibling in the absorbing arena's list
+   char *image;                       // Read-only image mapping (loaded arenas only)
+   usize image_size;                  // Size of the image mapping
+   struct arena_pin *pins;            // Pointer fixups for Arena.save, most recent first
+   pool root_pool;                    // Root pool for block allocation
 };
 
 #if 1 // Region: Forward declarations
 // API functions
 static object arena_alloc(arena arena, usize size, bool zero);
+static object arena_realloc(arena arena, object ptr, usize old_size, usize new_size);
 static bool arena_is_tracking(arena arena, object ptr);
 static void arena_track(arena arena, object ptr);
 static void arena_untrack(arena arena, object ptr);
 static usize arena_get_page_count(arena arena);
 static usize arena_get_total_allocated(arena arena);
+static int arena_get_stats(arena arena, arena_stats *stats);
+static usize arena_placement(arena arena, usize *pages_per_node, usize nodes);
+static int arena_set_budget(arena arena, const scope_budget *budget);
 static frame arena_begin_frame(arena arena);
 static void arena_end_frame(frame current_frame);
+static arena arena_get_frame_arena(frame current_frame);
+static object arena_get_frame_scope(frame current_frame);
+static int arena_promote(frame current_frame, object ptr);
+static int arena_promote_all(frame current_frame);
+static int arena_defer(frame current_frame, frame_defer_fn fn, object arg);
+static allocator arena_get_allocator(arena arena);
+static bool arena_contains(arena arena, object ptr);
+static void arena_reset(arena arena);
+static int arena_save(arena arena, const char *path, object root);
+static int arena_pin(arena arena, object slot);
+static int arena_pin_farray(arena arena, farray arr);
+static int arena_pin_list(arena arena, list lst, bool elements);
+static int arena_pin_slotarray(arena arena, slotarray sa, bool elements);
+static int arena_merge(arena parent, arena child);
+static int arena_fork(arena arena);
+static int arena_commit(arena arena);
+static int arena_discard(arena arena);
 
 // Helper/utility functions
-static sc_page *page_create(void);
+static usize page_chunk_size(usize capacity);
+static sc_page *page_create(usize capacity, int node);
+static sc_page *page_create_reserved(usize reserve, usize commit, bool prefault, bool huge_pages, int node, int fd);
 static void page_destroy(sc_page *page);
 static object page_alloc(sc_page *page, usize size, bool zero);
+static object page_alloc_aligned(sc_page *page, usize size, bool zero);
 static void arena_add_block(arena arena, struct block *block);
 static void arena_remove_block(arena arena, struct block *block);
+static void arena_run_finalizers(arena arena, struct arena_finalizer *stop);
+static void arena_release_spare_pages(arena arena);
+static void arena_dispose_absorbed(arena arena);
 
 // Validation helpers
 static bool arena_validate(arena arena);
+static arena arena_resolve(arena arena);
 static bool arena_validate_ptr(arena arena, object ptr);
-static bool frame_validate(frame current_frame);
+static sc_frame *frame_resolve(frame handle);
+static bool frame_validate(sc_frame *current_frame);
+static sc_frame *frame_innermost(frame handle);
 
 // Block management helpers
 static struct block *arena_find_block(arena arena, object ptr);
@@ -94,38 +210,141 @@ static struct block *arena_create_block(arena arena, object ptr, usize alloc_siz
 // Allocation helpers
 static bool arena_alloc_validate_and_check_size(arena arena, usize size);
 static bool arena_alloc_ensure_page(arena arena);
+static usize arena_alloc_next_page_size(arena arena, usize size);
 static object arena_alloc_try_current_page(arena arena, usize size, bool zero);
 static object arena_alloc_create_new_page(arena arena, usize size, bool zero);
-
-// Page iterator helper
-static usize arena_sum_page_usage(arena arena);
+static void arena_alloc_account(arena arena, object ptr, usize size);
+static bool arena_alloc_commit(arena arena, usize size);
+static usize arena_round_up(usize size, usize step);
+static bool arena_fork_remap(arena arena, bool private_copy);
+static bool arena_realloc_in_place(arena arena, object ptr, usize old_size, usize new_size);
+
+// Image helpers
+static usize arena_image_relocs(arena arena, sc_page *page, uint64_t *relocs);
+static void arena_image_visit(object slot, void *ctx);
+static int arena_image_compare(const void *left, const void *right);
+static int arena_pin_add(arena arena, object target, enum arena_pin_kind kind, bool elements);
+static void arena_unpin_freed(arena arena);
+static bool arena_image_write(FILE *file, const struct arena_image_header *header,
+                              const uint64_t *relocs, const sc_page *page);
+static bool arena_image_check(const struct arena_image_header *header, uint64_t file_size);
 
 // Frame management helpers
-static void arena_end_frame_cleanup_inner_frames(arena arena, frame target_frame);
-static void arena_end_frame_reset_bump_pointer(frame current_frame, arena arena);
-static void arena_end_frame_cleanup_tracking(frame current_frame, arena arena);
+static void arena_end_frame_invalidate_inner_frames(arena arena, usize depth);
+static void arena_end_frame_reset_bump_pointer(sc_frame *current_frame, arena arena);
+static void arena_end_frame_cleanup_tracking(sc_frame *current_frame, arena arena);
+
+// Scope operations
+static object arena_scope_alloc(void *scope, usize size, bool zero);
+static void arena_scope_free(void *scope, object ptr);
+static object arena_scope_realloc(void *scope, object ptr, usize old_size, usize new_size);
+static int arena_scope_track(void *scope, object ptr);
+static int arena_scope_untrack(void *scope, object ptr);
+static int arena_scope_adopt(void *scope, object ptr, usize size, scope_release_fn release);
+static object frame_scope_alloc(void *scope, usize size, bool zero);
+static object frame_scope_realloc(void *scope, object ptr, usize old_size, usize new_size);
+static int frame_scope_track(void *scope, object ptr);
+static int frame_scope_untrack(void *scope, object ptr);
+static int frame_scope_adopt(void *scope, object ptr, usize size, scope_release_fn release);
 #endif
 
-// Create a new arena
+static const scope_ops arena_scope_ops = {
+    .alloc = arena_scope_alloc,
+    .free = arena_scope_free,
+    .realloc = arena_scope_realloc,
+    .track = arena_scope_track,
+    .untrack = arena_scope_untrack,
+    .adopt = arena_scope_adopt,
+};
+
+// Frames allocate from and track in their arena while they are valid
+static const scope_ops frame_scope_ops = {
+    .alloc = frame_scope_alloc,
+    .free = arena_scope_free,
+    .realloc = frame_scope_realloc,
+    .track = frame_scope_track,
+    .untrack = frame_scope_untrack,
+    .adopt = frame_scope_adopt,
+};
+
+// Create a new arena with fixed-size pages
 arena arena_create(usize initial_pages) {
+   return arena_create_ex(&(arena_opts){.initial_pages = initial_pages});
+}
+
+// Create a new arena with an explicit page growth policy
+arena arena_create_ex(const arena_opts *opts) {
+   if (!opts)
+      return NULL;
+
+   usize page_size = opts->page_size ? opts->page_size : PAGE_DATA_SIZE;
+   usize max_page_size = opts->max_page_size > page_size ? opts->max_page_size : page_size;
+
    arena arena = memory_alloc(sizeof(sc_arena), true);
    if (!arena)
       return NULL;
 
-   // Initialize handle
-   memcpy(arena->handle, "ARN", 4);
+   // Initialize scope header
+   scope_init_header(&arena->scope, "ARN", &arena_scope_ops);
 
    arena->root_pages = NULL;
    arena->current_page = NULL;
    arena->alloc_head = NULL;
    arena->alloc_tail = NULL;
+   arena->finalizers = NULL;
+   arena->finalizers_tail = NULL;
    arena->page_count = 0;
-   arena->frame_stack = NULL;
+   arena->used = 0;
+   arena->reserved = 0;
+   arena->tail_waste = 0;
+   arena->peak = 0;
+   arena->tracked_blocks = 0;
+   arena->next_page_size = page_size;
+   arena->max_page_size = max_page_size;
+   arena->commit_step = 0;
+   arena->prefault = opts->prefault;
+   arena->huge_pages = opts->reserve && opts->huge_pages;
+   arena->numa_node = opts->numa_bind ? vmem_numa_resolve(opts->numa_node) : -1;
+   arena->budget = (scope_budget){0};
+   arena->fork_fd = -1;
+   arena->fork_mark.valid = false;
+   arena->frame_depth = 0;
    arena->root_pool = pool_create(1); // Create root pool for block allocation
+   pool_retag(arena->root_pool, 0);   // Tracking blocks are bookkeeping, not the arena's data
+
+   if (opts->reserve) {
+      // Reserved arena: one contiguous mapping, committed as the bump pointer advances
+      usize step = opts->page_size ? opts->page_size : VMEM_COMMIT_STEP;
+      if (opts->huge_pages && step < VMEM_HUGE_PAGE_SIZE)
+         step = VMEM_HUGE_PAGE_SIZE;
+      arena->commit_step = arena_round_up(step, vmem_page_size());
+      usize reserve = arena_round_up(opts->reserve, arena->commit_step);
+
+      // A forkable arena maps a memfd shared, so a fork can remap it copy-on-write in place
+      if (opts->forkable && (arena->fork_fd = vmem_shared_create(NULL, reserve)) < 0) {
+         arena_dispose(arena);
+         return NULL;
+      }
+
+      sc_page *page = page_create_reserved(reserve, arena->commit_step, opts->prefault, opts->huge_pages,
+                                           arena->numa_node, arena->fork_fd);
+      if (!page) {
+         arena_dispose(arena);
+         return NULL;
+      }
 
-   // Create initial pages
-   for (usize i = 0; i < initial_pages; i++) {
-      sc_page *new_page = page_create();
+      arena->root_pages = page;
+      arena->current_page = page;
+      arena->page_count = 1;
+      arena->reserved = page->committed - sizeof(sc_page);
+      arena->next_page_size = page->capacity;
+      arena->max_page_size = page->capacity;
+      return arena;
+   }
+
+   // Create initial pages (all empty, so their order does not matter)
+   for (usize i = 0; i < opts->initial_pages; i++) {
+      sc_page *new_page = page_create(page_size, arena->numa_node);
       if (!new_page) {
          // Cleanup on failure
          arena_dispose(arena);
@@ -134,12 +353,9 @@ arena arena_create(usize initial_pages) {
 
       new_page->next = arena->root_pages;
       arena->root_pages = new_page;
-
-      if (!arena->current_page) {
-         arena->current_page = new_page;
-      }
-
+      arena->current_page = new_page;
       arena->page_count++;
+      arena->reserved += new_page->capacity;
    }
 
    return arena;
@@ -147,9 +363,15 @@ arena arena_create(usize initial_pages) {
 
 // Destroy an arena
 void arena_dispose(arena arena) {
-   if (!arena)
+   // A merged arena's header is owned (and disposed) by the arena it was merged into
+   if (!arena || arena->merged_into)
       return;
 
+   // Release adopted buffers before the memory that may refer to them
+   arena_run_finalizers(arena, NULL);
+
+   memory_tag_release(arena->scope.tag, arena->used);
+
    // Dispose all allocation blocks
    struct block *block = arena->alloc_head;
    while (block) {
@@ -171,6 +393,11 @@ void arena_dispose(arena arena) {
       page = next;
    }
 
+   if (arena->image)
+      vmem_release(arena->image, arena->image_size);
+   vmem_close_fd(arena->fork_fd);
+
+   arena_dispose_absorbed(arena);
    memory_dispose(arena);
 }
 
@@ -182,6 +409,10 @@ static object arena_alloc(arena arena, usize size, bool zero) {
    if (!arena_alloc_ensure_page(arena))
       return NULL;
 
+   // Reserved arenas grow in place by committing more of their mapping
+   if (arena->current_page->mapped && !arena_alloc_commit(arena, size))
+      return NULL;
+
    // Try to allocate from current page
    object ptr = arena_alloc_try_current_page(arena, size, zero);
    if (ptr)
@@ -191,6 +422,23 @@ static object arena_alloc(arena arena, usize size, bool zero) {
    return arena_alloc_create_new_page(arena, size, zero);
 }
 
+// Resize an allocation, in place when it is the top of the current page
+static object arena_realloc(arena arena, object ptr, usize old_size, usize new_size) {
+   if (!ptr)
+      return arena_alloc(arena, new_size, false);
+   if (new_size == 0 || !arena_alloc_validate_and_check_size(arena, new_size))
+      return NULL;
+
+   if (arena_realloc_in_place(arena, ptr, old_size, new_size))
+      return ptr;
+
+   // Not the top allocation: copy, abandoning the old block until the frame or arena ends
+   object new_ptr = arena_alloc(arena, new_size, false);
+   if (new_ptr)
+      memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+   return new_ptr;
+}
+
 // Check if arena is tracking a pointer
 static bool arena_is_tracking(arena arena, object ptr) {
    return arena_find_block(arena, ptr) != NULL;
@@ -198,19 +446,12 @@ static bool arena_is_tracking(arena arena, object ptr) {
 
 // Track a pointer in the arena
 static void arena_track(arena arena, object ptr) {
-   struct block *block = arena_create_block(arena, ptr, 0); // 0 for external pointers
-   if (block) {
-      arena_add_block(arena, block);
-   }
+   arena_scope_track(arena, ptr);
 }
 
 // Untrack a pointer from the arena
 static void arena_untrack(arena arena, object ptr) {
-   struct block *block = arena_find_block(arena, ptr);
-   if (block) {
-      arena_remove_block(arena, block);
-      pool_free(arena->root_pool, (object)block);
-   }
+   arena_scope_untrack(arena, ptr);
 }
 
 // Get page count
@@ -220,95 +461,652 @@ static usize arena_get_page_count(arena arena) {
 
 // Get total allocated bytes
 static usize arena_get_total_allocated(arena arena) {
-   return arena_sum_page_usage(arena);
+   return arena_validate(arena) ? arena->used : 0;
 }
 
-// Begin a new frame
-static frame arena_begin_frame(arena arena) {
+// Get a snapshot of the arena's running counters
+static int arena_get_stats(arena arena, arena_stats *stats) {
+   if (!arena_validate(arena) || !stats)
+      return ERR;
+
+   stats->used = arena->used;
+   stats->reserved = arena->reserved;
+   stats->tail_waste = arena->tail_waste;
+   stats->peak = arena->peak;
+   stats->page_count = arena->page_count;
+   stats->frame_depth = arena->frame_depth;
+   stats->tracked_blocks = arena->tracked_blocks;
+   stats->numa_node = arena->numa_node;
+
+   return OK;
+}
+
+// Count the arena's resident OS pages per NUMA node
+static usize arena_placement(arena arena, usize *pages_per_node, usize nodes) {
    if (!arena_validate(arena))
-      return NULL;
+      return 0;
+   if (pages_per_node)
+      memset(pages_per_node, 0, nodes * sizeof(usize));
+
+   if (arena->image)
+      return vmem_numa_placement(arena->image, arena->image_size, pages_per_node, nodes);
+
+   usize found = 0;
+   for (sc_page *page = arena->root_pages; page; page = page->next) {
+      if (page->mapped)
+         found += vmem_numa_placement(page, page->committed, pages_per_node, nodes);
+      else
+         found += vmem_numa_placement(page->data, page->capacity, pages_per_node, nodes);
+   }
+   return found;
+}
 
-   sc_frame *frame = memory_alloc(sizeof(sc_frame), true);
-   if (!frame)
-      return NULL;
+// Charge the arena's live bytes to a new tag
+void arena_retag(arena arena, memory_tag tag) {
+   if (!arena_validate(arena))
+      return;
+   memory_tag_move(arena->scope.tag, tag, arena->used);
+   arena->scope.tag = tag;
+}
+
+// Set or clear the arena's byte budget
+static int arena_set_budget(arena arena, const scope_budget *budget) {
+   if (!arena_validate(arena))
+      return ERR;
+   arena->budget = budget ? *budget : (scope_budget){0};
+   return OK;
+}
+
+// Begin a new frame: push a marker onto the arena's inline frame stack
+static frame arena_begin_frame(arena arena) {
+   if (!arena_validate(arena) || arena->image || arena->frame_depth >= ARENA_FRAME_DEPTH)
+      return (struct sc_frame_handle){0};
+
+   // The slot of the previous frame at this depth gets a new generation, retiring its handles
+   sc_frame *frame = &arena->frames[arena->frame_depth];
+   frame->generation = ++arena->frame_generation;
+   frame->depth = arena->frame_depth++;
 
-   // Initialize handle
-   memcpy(frame->handle, "FRM", 4);
+   // Initialize scope header; the allocator is the arena's, which outlives the frame
+   scope_init_header(&frame->scope, "FRM", &frame_scope_ops);
+   frame->scope.allocator = arena->scope.allocator;
 
    frame->arena = arena;
    frame->start_page = arena->current_page;
    frame->bump_start = arena->current_page ? arena->current_page->bump : NULL;
    frame->tail_start = arena->alloc_tail; // Track allocation tail at frame start
+   frame->tail_origin = arena->alloc_tail;
+   frame->used_start = arena->used;
+   frame->waste_start = arena->tail_waste;
+   frame->finalizer_start = arena->finalizers;
    frame->valid = true;
 
-   // Push frame onto stack (most nested frame is at head)
-   frame->next = arena->frame_stack;
-   arena->frame_stack = frame;
-
-   return frame;
+   MEMORY_TRACE(TRACE_FRAME_BEGIN, arena, arena->frame_depth);
+   return (struct sc_frame_handle){.slot = frame, .generation = frame->generation};
 }
 
 // End a frame, rolling back allocations
-static void arena_end_frame(frame current_frame) {
-   if (!frame_validate(current_frame))
+static void arena_end_frame(frame handle) {
+   sc_frame *current_frame = frame_resolve(handle);
+   if (!current_frame)
       return;
 
    sc_arena *arena = current_frame->arena;
+   usize depth = current_frame->depth;
 
    // Check if this frame is at the top of the stack
-   if (arena->frame_stack != current_frame) {
-      // Frame is not the most recently begun - this is an error
-      // For safety, we'll still clean up but this indicates improper nesting
-      // In a real implementation, this might be an assertion failure
+   if (depth + 1 != arena->frame_depth) {
+      // Frame is not the most recently begun - this indicates improper nesting.
+      // Rolling back to this frame's marker also discards every inner frame.
       fprintf(stderr, "Warning: Ending frame out of order - inner frames will be cleaned up\n");
    }
 
-   // Automatically end any inner frames (more nested) first
-   arena_end_frame_cleanup_inner_frames(arena, current_frame);
+   // Inner frames share this frame's rollback, so they only need invalidating
+   arena_end_frame_invalidate_inner_frames(arena, depth);
+
+   arena_run_finalizers(arena, current_frame->finalizer_start);
+   arena_end_frame_reset_bump_pointer(current_frame, arena);
+   arena_end_frame_cleanup_tracking(current_frame, arena);
+
+   current_frame->valid = false;
+   arena->frame_depth = depth; // Pop this frame from the stack
+   MEMORY_TRACE(TRACE_FRAME_END, arena, depth + 1);
+}
 
-   // Now handle the target frame
-   if (arena->frame_stack == current_frame) {
-      arena->frame_stack = current_frame->next; // Pop this frame from stack
+// Get the arena a frame allocates from
+static arena arena_get_frame_arena(frame handle) {
+   sc_frame *current_frame = frame_resolve(handle);
+   return current_frame ? current_frame->arena : NULL;
+}
 
-      arena_end_frame_reset_bump_pointer(current_frame, arena);
+// Get a frame's scope header (the slot itself)
+static object arena_get_frame_scope(frame handle) {
+   return frame_resolve(handle);
+}
 
-      // Clean up tracking entries if on same page
-      if (current_frame->start_page && current_frame->start_page == arena->current_page) {
-         arena_end_frame_cleanup_tracking(current_frame, arena);
+// Move a frame's rollback marker past one of its allocations
+static int arena_promote(frame handle, object ptr) {
+   sc_frame *current_frame = frame_innermost(handle);
+   if (!current_frame || !ptr)
+      return ERR;
+
+   // Frame allocations are tracked in allocation (and therefore address) order;
+   // only the sizes past the current marker need adding to the surviving count
+   sc_arena *arena = current_frame->arena;
+   bool past_marker = current_frame->tail_start == current_frame->tail_origin;
+   usize survived = 0;
+   struct block *block = current_frame->tail_origin ? current_frame->tail_origin->next_alloc : arena->alloc_head;
+   for (; block; block = block->next_alloc) {
+      if (past_marker)
+         survived += block->alloc_size;
+      if (block->ptr == ptr && block->alloc_size > 0)
+         break;
+      if (block == current_frame->tail_start)
+         past_marker = true;
+   }
+   if (!block)
+      return ERR; // Not allocated in this frame
+   if (!past_marker)
+      return OK; // Already below the marker
+
+   // Find the page holding the object; pages left behind on the way become the parent's waste
+   sc_page *page = current_frame->start_page ? current_frame->start_page : arena->root_pages;
+   usize waste = 0;
+   while (page && !((char *)ptr >= page->data && (char *)ptr < page->data + page->used)) {
+      waste += page->capacity - page->used;
+      page = page->next;
+   }
+   if (!page)
+      return ERR;
+
+   current_frame->start_page = page;
+   current_frame->bump_start = (char *)ptr + block->alloc_size;
+   current_frame->tail_start = block;
+   current_frame->used_start += survived;
+   current_frame->waste_start += waste;
+   return OK;
+}
+
+// Move a frame's rollback marker to the arena's current position
+static int arena_promote_all(frame handle) {
+   sc_frame *current_frame = frame_innermost(handle);
+   if (!current_frame)
+      return ERR;
+
+   sc_arena *arena = current_frame->arena;
+   current_frame->start_page = arena->current_page;
+   current_frame->bump_start = arena->current_page ? arena->current_page->bump : NULL;
+   current_frame->tail_start = arena->alloc_tail;
+   current_frame->used_start = arena->used;
+   current_frame->waste_start = arena->tail_waste;
+   current_frame->finalizer_start = arena->finalizers;
+   return OK;
+}
+
+// Register a call to make when the frame ends (or the arena resets or is disposed)
+static int arena_defer(frame handle, frame_defer_fn fn, object arg) {
+   sc_frame *current_frame = frame_innermost(handle);
+   if (!current_frame || !fn)
+      return ERR;
+
+   // The entry is frame memory: it is rolled back right after the call runs
+   sc_arena *arena = current_frame->arena;
+   struct arena_finalizer *entry = arena_alloc(arena, sizeof(*entry), false);
+   if (!entry)
+      return ERR;
+
+   if (!arena->finalizers)
+      arena->finalizers_tail = entry;
+   entry->next = arena->finalizers;
+   entry->ptr = arg;
+   entry->size = 0;
+   entry->release = NULL;
+   entry->defer = fn;
+   arena->finalizers = entry;
+   return OK;
+}
+
+// Get the arena's allocator
+static allocator arena_get_allocator(arena arena) {
+   return arena_validate(arena) ? &arena->scope.allocator : NULL;
+}
+
+// Check whether a pointer lies inside memory handed out by the arena
+static bool arena_contains(arena arena, object ptr) {
+   if (!arena_validate(arena) || !ptr)
+      return false;
+
+   if (arena->image) {
+      char *data = arena->image + sizeof(sc_page);
+      return (char *)ptr >= data && (char *)ptr < data + arena->used;
+   }
+
+   // Pages past current_page are empty spares; a reserved arena has a single range
+   for (sc_page *page = arena->root_pages; page; page = page->next) {
+      if ((char *)ptr >= page->data && (char *)ptr < page->data + page->used)
+         return true;
+      if (page == arena->current_page)
+         break;
+   }
+   return false;
+}
+
+// Discard every allocation and frame, keeping the pages for reuse
+static void arena_reset(arena arena) {
+   if (!arena_validate(arena) || arena->image)
+      return;
+
+   // Resetting ends a fork; discarding it first leaves nothing pointing at forked state
+   if (arena->fork_mark.valid)
+      arena_discard(arena);
+
+   // Open frames can no longer be rolled back to
+   for (usize i = 0; i < arena->frame_depth; i++) {
+      arena->frames[i].valid = false;
+   }
+   arena->frame_depth = 0;
+
+   arena_run_finalizers(arena, NULL);
+
+   // Drop all tracking, including explicitly tracked pointers
+   struct block *block = arena->alloc_head;
+   while (block) {
+      struct block *next = block->next_alloc;
+      pool_free(arena->root_pool, (object)block);
+      block = next;
+   }
+   arena->alloc_head = NULL;
+   arena->alloc_tail = NULL;
+   arena->tracked_blocks = 0;
+
+   while (arena->pins) {
+      struct arena_pin *next = arena->pins->next;
+      pool_free(arena->root_pool, arena->pins);
+      arena->pins = next;
+   }
+
+   for (sc_page *page = arena->root_pages; page; page = page->next) {
+      page->bump = page->data;
+      page->used = 0;
+   }
+   arena->current_page = arena->root_pages;
+   memory_tag_release(arena->scope.tag, arena->used);
+   arena->used = 0;
+   arena->tail_waste = 0;
+
+   // A reserved arena returns everything past its first commit step to the system
+   // (a forkable arena keeps its memfd pages, which stay mapped shared)
+   sc_page *page = arena->root_pages;
+   if (page && page->mapped && arena->fork_fd < 0 && page->committed > arena->commit_step) {
+      if (vmem_decommit((char *)page + arena->commit_step, page->committed - arena->commit_step) == OK) {
+         MEMORY_TRACE(TRACE_PAGE_RELEASE, (char *)page + arena->commit_step, page->committed - arena->commit_step);
+         arena->reserved -= page->committed - arena->commit_step;
+         page->committed = arena->commit_step;
+      }
+   }
+}
+
+// Write a reserved arena's memory to a relocatable image file
+static int arena_save(arena arena, const char *path, object root) {
+   if (!arena_validate(arena) || !path || arena->image)
+      return ERR;
+
+   // Only a reserved arena is one contiguous range that can be mapped back
+   sc_page *page = arena->root_pages;
+   if (!page || !page->mapped)
+      return ERR;
+   if (root && !arena_contains(arena, root))
+      return ERR;
+
+   usize reloc_count = arena_image_relocs(arena, page, NULL);
+   uint64_t *relocs = NULL;
+   if (reloc_count) {
+      relocs = sysmem_alloc(reloc_count * sizeof(uint64_t));
+      if (!relocs)
+         return ERR;
+      arena_image_relocs(arena, page, relocs);
+
+      // Pins may overlap (a field pinned directly and through its list): relocate once
+      qsort(relocs, reloc_count, sizeof(uint64_t), arena_image_compare);
+      usize unique = 1;
+      for (usize i = 1; i < reloc_count; i++) {
+         if (relocs[i] != relocs[unique - 1])
+            relocs[unique++] = relocs[i];
       }
+      reloc_count = unique;
+   }
+
+   struct arena_image_header header = {
+       .magic = ARENA_IMAGE_MAGIC,
+       .version = ARENA_IMAGE_VERSION,
+       .base = (uint64_t)(uintptr_t)page,
+       .data_offset = sizeof(sc_page),
+       .size = sizeof(sc_page) + page->used,
+       .used = page->used,
+       .root = root ? (uint64_t)((char *)root - (char *)page) : ARENA_IMAGE_NO_ROOT,
+       .reloc_count = reloc_count,
+       .body_offset = arena_round_up(sizeof(header) + reloc_count * sizeof(uint64_t), vmem_page_size()),
+   };
+
+   FILE *file = fopen(path, "wb");
+   bool written = file && arena_image_write(file, &header, relocs, page);
+   if (file && fclose(file) != 0)
+      written = false;
+
+   sysmem_free(relocs);
+   return written ? OK : ERR;
+}
 
-      current_frame->valid = false;  // Mark as invalid before disposing
-      memory_dispose(current_frame); // Free the frame structure
+// Map an image written by Arena.save as a read-only arena
+arena arena_load(const char *path, object *root) {
+   if (!path)
+      return NULL;
+
+   FILE *file = fopen(path, "rb");
+   if (!file)
+      return NULL;
+
+   struct arena_image_header header;
+   uint64_t *relocs = NULL;
+   long file_size = fseek(file, 0, SEEK_END) == 0 ? ftell(file) : -1;
+   bool valid = file_size >= (long)sizeof(header) && fseek(file, 0, SEEK_SET) == 0 &&
+                fread(&header, sizeof(header), 1, file) == 1 &&
+                arena_image_check(&header, (uint64_t)file_size);
+   if (valid && header.reloc_count) {
+      relocs = sysmem_alloc(header.reloc_count * sizeof(uint64_t));
+      valid = relocs && fread(relocs, sizeof(uint64_t), header.reloc_count, file) == header.reloc_count;
+   }
+   // Every relocated slot must hold a whole pointer inside the image, and be patched once
+   for (uint64_t i = 0; valid && i < header.reloc_count; i++) {
+      uint64_t offset = relocs[i] & ~ARENA_IMAGE_RELOC_ALLOCATOR;
+      valid = offset >= header.data_offset && offset <= header.size - sizeof(uint64_t) &&
+              (i == 0 || offset >= (relocs[i - 1] & ~ARENA_IMAGE_RELOC_ALLOCATOR) + sizeof(uint64_t));
    }
+   fclose(file);
+
+   arena arena = valid ? arena_create_ex(&(arena_opts){0}) : NULL;
+   usize image_size = valid ? arena_round_up(header.size, vmem_page_size()) : 0;
+   char *image = arena ? vmem_map_file(path, header.body_offset, image_size, (object)(uintptr_t)header.base) : NULL;
+   if (!image) {
+      sysmem_free(relocs);
+      arena_dispose(arena);
+      return NULL;
+   }
+
+   // Fix up pointers; an image mapped at its original base only needs the allocator patched
+   uintptr_t base = (uintptr_t)header.base;
+   for (uint64_t i = 0; i < header.reloc_count; i++) {
+      char *slot = image + (relocs[i] & ~ARENA_IMAGE_RELOC_ALLOCATOR);
+      uintptr_t value;
+      if (relocs[i] & ARENA_IMAGE_RELOC_ALLOCATOR) {
+         value = (uintptr_t)&arena->scope.allocator;
+      } else {
+         memcpy(&value, slot, sizeof(value));
+         // A relocated pointer must land inside the image (one past the end included)
+         if (value - base > header.size) {
+            sysmem_free(relocs);
+            vmem_release(image, image_size);
+            arena_dispose(arena);
+            return NULL;
+         }
+         if ((uintptr_t)image == base)
+            continue;
+         value = value - base + (uintptr_t)image;
+      }
+      memcpy(slot, &value, sizeof(value));
+   }
+   sysmem_free(relocs);
+   vmem_protect_read(image, image_size);
+
+   arena->image = image;
+   arena->image_size = image_size;
+   arena->used = header.used;
+   memory_tag_charge(arena->scope.tag, header.used);
+   arena->peak = header.used;
+   arena->reserved = header.used;
+
+   if (root)
+      *root = header.root == ARENA_IMAGE_NO_ROOT ? NULL : image + header.root;
+   return arena;
+}
+
+// Register a pointer field for relocation by Arena.save
+static int arena_pin(arena arena, object slot) {
+   if ((uintptr_t)slot % _Alignof(object) != 0)
+      return ERR;
+   return arena_pin_add(arena, slot, ARENA_PIN_SLOT, false);
+}
+
+// Register an farray header for relocation by Arena.save
+static int arena_pin_farray(arena arena, farray arr) {
+   if (!arr || ((sc_array_base *)arr)->handle[0] != 'F')
+      return ERR;
+   return arena_pin_add(arena, arr, ARENA_PIN_FARRAY, false);
+}
+
+// Register a list (walked when saving) for relocation by Arena.save
+static int arena_pin_list(arena arena, list lst, bool elements) {
+   if (list_image_slots(lst, elements, NULL, NULL) != OK)
+      return ERR;
+   return arena_pin_add(arena, lst, ARENA_PIN_LIST, elements);
+}
+
+// Register a slotarray (walked when saving) for relocation by Arena.save
+static int arena_pin_slotarray(arena arena, slotarray sa, bool elements) {
+   if (slotarray_image_slots(sa, elements, NULL, NULL) != OK)
+      return ERR;
+   return arena_pin_add(arena, sa, ARENA_PIN_SLOTARRAY, elements);
+}
+
+// Splice a child arena's pages, tracking and adopted buffers onto a parent
+static int arena_merge(arena parent, arena child) {
+   if (!arena_validate(parent) || !arena_validate(child) || parent == child)
+      return ERR;
+   // Reserved and image arenas are single mappings, and open child frames would dangle
+   if (parent->image || child->image || parent->commit_step || child->commit_step || child->frame_depth)
+      return ERR;
+
+   // Pages: the child's live pages go after the parent's current page and the child's
+   // current page becomes the parent's; the parent's current tail is abandoned as waste
+   arena_release_spare_pages(child);
+   if (child->current_page) {
+      if (parent->current_page) {
+         parent->tail_waste += parent->current_page->capacity - parent->current_page->used;
+         child->current_page->next = parent->current_page->next;
+         parent->current_page->next = child->root_pages;
+      } else {
+         child->current_page->next = parent->root_pages;
+         parent->root_pages = child->root_pages;
+      }
+      parent->current_page = child->current_page;
+   }
+
+   // Tracking blocks live in the child's block pool, which the parent's pool absorbs
+   if (child->alloc_head) {
+      child->alloc_head->prev_alloc = parent->alloc_tail;
+      if (parent->alloc_tail)
+         parent->alloc_tail->next_alloc = child->alloc_head;
+      else
+         parent->alloc_head = child->alloc_head;
+      parent->alloc_tail = child->alloc_tail;
+   }
+   pool_absorb(parent->root_pool, child->root_pool);
+
+   // The child's adopted buffers are newer, so they are released first
+   if (child->finalizers) {
+      child->finalizers_tail->next = parent->finalizers;
+      if (!parent->finalizers)
+         parent->finalizers_tail = child->finalizers_tail;
+      parent->finalizers = child->finalizers;
+   }
+
+   memory_tag_move(child->scope.tag, parent->scope.tag, child->used);
+   parent->page_count += child->page_count;
+   parent->used += child->used;
+   parent->reserved += child->reserved;
+   parent->tail_waste += child->tail_waste;
+   parent->tracked_blocks += child->tracked_blocks;
+   if (parent->used > parent->peak)
+      parent->peak = parent->used;
+
+   // Collections may still hold the child's allocator, so the header stays as a forwarder
+   child->root_pages = NULL;
+   child->current_page = NULL;
+   child->alloc_head = NULL;
+   child->alloc_tail = NULL;
+   child->finalizers = NULL;
+   child->finalizers_tail = NULL;
+   child->root_pool = NULL;
+   child->merged_into = parent;
+   child->next_absorbed = parent->absorbed;
+   parent->absorbed = child;
+   return OK;
+}
+
+// Start speculative work: remap the arena's memfd copy-on-write in place, so pointers
+// keep their addresses and only the pages written from now on are copied
+static int arena_fork(arena arena) {
+   if (!arena_validate(arena) || arena->fork_fd < 0 || arena->fork_mark.valid || arena->frame_depth)
+      return ERR;
+
+   sc_page *page = arena->root_pages;
+   if (!arena_fork_remap(arena, true))
+      return ERR;
+
+   // The page header lives in the mapping and rolls back with it; the arena's own
+   // counters and tracking live outside and are recorded like a frame
+   sc_frame *mark = &arena->fork_mark;
+   mark->arena = arena;
+   mark->start_page = page;
+   mark->bump_start = page->bump;
+   mark->tail_start = arena->alloc_tail;
+   mark->tail_origin = arena->alloc_tail;
+   mark->used_start = arena->used;
+   mark->waste_start = arena->tail_waste;
+   mark->finalizer_start = arena->finalizers;
+   mark->valid = true;
+   arena->fork_reserved = arena->reserved;
+   return OK;
+}
+
+// Keep a fork's changes: write the copied pages back to the memfd and map it shared again
+static int arena_commit(arena arena) {
+   if (!arena_validate(arena) || !arena->fork_mark.valid)
+      return ERR;
+
+   sc_page *page = arena->root_pages;
+   if (vmem_write_back(page, page->committed, arena->fork_fd) != OK)
+      return ERR; // The fork stays open and can still be discarded
+   if (!arena_fork_remap(arena, false))
+      return ERR;
+
+   arena->fork_mark.valid = false;
+   return OK;
+}
+
+// Drop a fork's changes: mapping the memfd shared again discards the copied pages
+static int arena_discard(arena arena) {
+   if (!arena_validate(arena) || !arena->fork_mark.valid)
+      return ERR;
+
+   // Deferred calls registered in the fork live in its copied pages, so they run first
+   sc_frame *mark = &arena->fork_mark;
+   arena_run_finalizers(arena, mark->finalizer_start);
+   if (!arena_fork_remap(arena, false))
+      return ERR;
+
+   // Frames begun during the fork roll back with it
+   for (usize i = 0; i < arena->frame_depth; i++) {
+      arena->frames[i].valid = false;
+   }
+   arena->frame_depth = 0;
+
+   arena_end_frame_cleanup_tracking(mark, arena);
+   if (arena->used > mark->used_start)
+      memory_tag_release(arena->scope.tag, arena->used - mark->used_start);
+   else
+      memory_tag_grow(arena->scope.tag, mark->used_start - arena->used);
+   arena->used = mark->used_start;
+   arena->tail_waste = mark->waste_start;
+   arena->reserved = arena->fork_reserved;
+   mark->valid = false;
+   if (arena->pins)
+      arena_unpin_freed(arena);
+   return OK;
 }
 
 // Public interface
 const sc_arena_i Arena = {
     .alloc = arena_alloc,
+    .realloc = arena_realloc,
     .is_tracking = arena_is_tracking,
     .track = arena_track,
     .untrack = arena_untrack,
     .get_page_count = arena_get_page_count,
     .get_total_allocated = arena_get_total_allocated,
+    .stats = arena_get_stats,
+    .placement = arena_placement,
+    .set_budget = arena_set_budget,
     .begin_frame = arena_begin_frame,
     .end_frame = arena_end_frame,
+    .get_frame_arena = arena_get_frame_arena,
+    .get_frame_scope = arena_get_frame_scope,
+    .promote = arena_promote,
+    .promote_all = arena_promote_all,
+    .defer = arena_defer,
+    .allocator = arena_get_allocator,
+    .contains = arena_contains,
+    .reset = arena_reset,
+    .save = arena_save,
+    .pin = arena_pin,
+    .pin_farray = arena_pin_farray,
+    .pin_list = arena_pin_list,
+    .pin_slotarray = arena_pin_slotarray,
+    .merge = arena_merge,
+    .fork = arena_fork,
+    .commit = arena_commit,
+    .discard = arena_discard,
 };
 
 // Helper/utility function definitions
 #if 1 // Region: Helper/utility function definitions
 // Validation helpers
 static bool arena_validate(arena arena) {
-   return arena != NULL;
+   return arena != NULL && !arena->merged_into;
+}
+
+// Follow merges to the arena that now owns a (possibly merged) arena's memory
+static arena arena_resolve(arena arena) {
+   while (arena && arena->merged_into)
+      arena = arena->merged_into;
+   return arena;
 }
 
 static bool arena_validate_ptr(arena arena, object ptr) {
    return arena_validate(arena) && ptr != NULL;
 }
 
-static bool frame_validate(frame current_frame) {
+// A handle is live only while its slot still holds the frame it was returned for
+static sc_frame *frame_resolve(frame handle) {
+   sc_frame *current_frame = handle.slot;
+   if (!current_frame || current_frame->generation != handle.generation)
+      return NULL;
+   return frame_validate(current_frame) ? current_frame : NULL;
+}
+
+static bool frame_validate(sc_frame *current_frame) {
    return current_frame != NULL &&
           current_frame->arena != NULL &&
-          current_frame->valid;
+          current_frame->valid &&
+          current_frame->depth < current_frame->arena->frame_depth;
+}
+
+// Promotion moves the rollback marker, which inner frames would undercut
+static sc_frame *frame_innermost(frame handle) {
+   sc_frame *current_frame = frame_resolve(handle);
+   if (!current_frame || current_frame->depth + 1 != current_frame->arena->frame_depth)
+      return NULL;
+   return current_frame;
 }
 
 // Block management helpers
@@ -344,12 +1142,13 @@ static struct block *arena_create_block(arena arena, object ptr, usize alloc_siz
 
 // Allocation helpers
 static bool arena_alloc_validate_and_check_size(arena arena, usize size) {
-   if (!arena_validate(arena))
+   // Loaded images are read-only
+   if (!arena_validate(arena) || arena->image)
       return false;
 
-   // Handle large allocations (> PAGE_DATA_SIZE) - not supported in bump allocation
-   if (size > PAGE_DATA_SIZE)
-      return false; // Large allocations are not supported
+   // Allocations larger than the biggest page the arena may grow are not supported
+   if (size > arena->max_page_size)
+      return false;
 
    return true;
 }
@@ -357,143 +1156,573 @@ static bool arena_alloc_validate_and_check_size(arena arena, usize size) {
 static bool arena_alloc_ensure_page(arena arena) {
    // If no current page, create one
    if (!arena->current_page) {
-      sc_page *new_page = page_create();
+      if (!scope_budget_admit(&arena->budget, arena, arena->reserved, arena->next_page_size))
+         return false;
+      sc_page *new_page = page_create(arena->next_page_size, arena->numa_node);
       if (!new_page)
          return false;
 
       arena->root_pages = new_page;
       arena->current_page = new_page;
       arena->page_count++;
+      arena->reserved += new_page->capacity;
    }
    return true;
 }
 
 static object arena_alloc_try_current_page(arena arena, usize size, bool zero) {
-   // Try to allocate from current page
-   object ptr = page_alloc(arena->current_page, size, zero);
+   // Try to allocate from current page, then from empty pages left behind by frames
+   object ptr = page_alloc_aligned(arena->current_page, size, zero);
+   while (!ptr && arena->current_page->next) {
+      arena->tail_waste += arena->current_page->capacity - arena->current_page->used;
+      arena->current_page = arena->current_page->next;
+      ptr = page_alloc_aligned(arena->current_page, size, zero);
+   }
    if (ptr) {
-      // Create a block to track this allocation
-      struct block *block = arena_create_block(arena, ptr, size);
-      if (block) {
-         arena_add_block(arena, block);
-      }
+      arena_alloc_account(arena, ptr, size);
    }
    return ptr;
 }
 
+// Size the next page: double up to the cap, and at least fit the request
+static usize arena_alloc_next_page_size(arena arena, usize size) {
+   usize page_size = arena->next_page_size;
+   while (page_size < size)
+      page_size *= 2;
+   if (page_size > arena->max_page_size)
+      page_size = arena->max_page_size;
+
+   // Successive pages double until they reach the growth cap
+   usize next = page_size * 2;
+   arena->next_page_size = next < arena->max_page_size ? next : arena->max_page_size;
+   return page_size;
+}
+
 static object arena_alloc_create_new_page(arena arena, usize size, bool zero) {
-   // Current page is full, create new page
-   sc_page *new_page = page_create();
+   // Current page is full, create new page (unless that breaks the hard budget)
+   usize next_page_size = arena->next_page_size;
+   usize page_size = arena_alloc_next_page_size(arena, size);
+   if (!scope_budget_admit(&arena->budget, arena, arena->reserved, page_size)) {
+      arena->next_page_size = next_page_size;
+      return NULL;
+   }
+   sc_page *new_page = page_create(page_size, arena->numa_node);
    if (!new_page)
       return NULL;
 
-   // Chain the new page
-   new_page->next = arena->root_pages;
-   arena->root_pages = new_page;
+   // Chain the new page after the (last) current page; its remaining bytes are abandoned
+   arena->tail_waste += arena->current_page->capacity - arena->current_page->used;
+   arena->current_page->next = new_page;
    arena->current_page = new_page;
    arena->page_count++;
+   arena->reserved += new_page->capacity;
 
    // Allocate from the new page
-   object ptr = page_alloc(new_page, size, zero);
+   object ptr = page_alloc_aligned(new_page, size, zero);
    if (ptr) {
-      // Create a block to track this allocation
-      struct block *block = arena_create_block(arena, ptr, size);
-      if (block) {
-         arena_add_block(arena, block);
-      }
+      arena_alloc_account(arena, ptr, size);
    }
 
    return ptr;
 }
 
-// Page iterator helper
-static usize arena_sum_page_usage(arena arena) {
-   if (!arena_validate(arena)) {
-      return 0;
+// Make sure a reserved arena's mapping is committed far enough for `size` more bytes
+static bool arena_alloc_commit(arena arena, usize size) {
+   sc_page *page = arena->current_page;
+   usize start = arena_round_up(page->used, ARENA_ALIGN);
+   if (start > page->capacity || size > page->capacity - start)
+      return false; // Reservation exhausted
+
+   usize needed = sizeof(sc_page) + start + size;
+   if (needed <= page->committed)
+      return true;
+
+   usize target = arena_round_up(needed, arena->commit_step);
+   if (target > page->mapped)
+      target = page->mapped;
+   if (!scope_budget_admit(&arena->budget, arena, arena->reserved, target - page->committed))
+      return false;
+
+   // A forkable arena's whole range is mapped already; committing only accounts for it
+   if (arena->fork_fd < 0) {
+      if (vmem_commit((char *)page + page->committed, target - page->committed, arena->prefault,
+                      arena->huge_pages) != OK)
+         return false;
+      if (page->node >= 0) // Committing re-maps the range, which drops its memory policy
+         vmem_numa_bind((char *)page + page->committed, target - page->committed, page->node);
    }
 
-   usize total = 0;
+   MEMORY_TRACE(TRACE_PAGE_GROW, (char *)page + page->committed, target - page->committed);
+   arena->reserved += target - page->committed;
+   page->committed = target;
+   return true;
+}
+
+// Map a forkable arena's memfd over its range, shared or copy-on-write
+static bool arena_fork_remap(arena arena, bool private_copy) {
    sc_page *page = arena->root_pages;
-   while (page) {
-      total += page->used;
-      page = page->next;
+   if (vmem_remap_fd(page, page->mapped, arena->fork_fd, private_copy) != OK)
+      return false;
+   if (arena->huge_pages) // Advice, like the memory policy, does not carry over
+      vmem_advise_huge(page, page->mapped);
+   if (page->node >= 0) // The new mapping starts with the default memory policy
+      vmem_numa_bind(page, page->mapped, page->node);
+   return true;
+}
+
+static usize arena_round_up(usize size, usize step) {
+   return (size + step - 1) / step * step;
+}
+
+// Move the bump pointer when ptr is the last allocation of the current page
+static bool arena_realloc_in_place(arena arena, object ptr, usize old_size, usize new_size) {
+   sc_page *page = arena->current_page;
+   struct block *tail = arena->alloc_tail;
+   if (!page || !old_size || (char *)ptr + old_size != (char *)page->bump)
+      return false;
+   // The tracking entry carries the size that frames and promotion account with
+   if (!tail || tail->ptr != ptr || tail->alloc_size != old_size)
+      return false;
+
+   // A frame begun (or promoted) after ptr would cut the block when it rolls back
+   if (arena->frame_depth) {
+      sc_frame *top = &arena->frames[arena->frame_depth - 1];
+      if (top->start_page == page && (char *)top->bump_start > (char *)ptr)
+         return false;
+   }
+   // Likewise a fork: discarding it restores the bump pointer but not the block's size
+   if (arena->fork_mark.valid && (char *)arena->fork_mark.bump_start > (char *)ptr)
+      return false;
+
+   if (new_size > old_size) {
+      usize grow = new_size - old_size;
+      if (page->mapped ? !arena_alloc_commit(arena, grow) : grow > page->capacity - page->used)
+         return false;
+      arena->used += grow;
+      memory_tag_grow(arena->scope.tag, grow);
+      if (arena->used > arena->peak)
+         arena->peak = arena->used;
+   } else {
+      arena->used -= old_size - new_size;
+      memory_tag_release(arena->scope.tag, old_size - new_size);
    }
-   return total;
+
+   page->used = page->used - old_size + new_size;
+   page->bump = (char *)ptr + new_size;
+   tail->alloc_size = new_size;
+   if (new_size < old_size && arena->pins)
+      arena_unpin_freed(arena);
+   return true;
 }
 
-// Frame management helpers
-static void arena_end_frame_cleanup_inner_frames(arena arena, frame target_frame) {
-   while (arena->frame_stack && arena->frame_stack != target_frame) {
-      frame inner_frame = arena->frame_stack;
-      arena->frame_stack = inner_frame->next; // Pop inner frame
-
-      // Reset to inner frame's start position
-      if (inner_frame->start_page && inner_frame->start_page == arena->current_page) {
-         inner_frame->start_page->bump = inner_frame->bump_start;
-         if (inner_frame->bump_start >= (void *)inner_frame->start_page->data) {
-            inner_frame->start_page->used = (char *)inner_frame->bump_start - inner_frame->start_page->data;
-         }
+// Image helpers
+// Relocation entries collected from an arena's pins
+struct arena_image_relocs {
+   sc_page *page;
+   uintptr_t alloc_ref; // The arena's allocator, patched to the loading arena's
+   uint64_t *relocs;    // NULL while counting
+   usize count;
+};
+
+// Expand the arena's pins into relocation entries (counted only when relocs is NULL)
+static usize arena_image_relocs(arena arena, sc_page *page, uint64_t *relocs) {
+   struct arena_image_relocs state = {
+       .page = page,
+       .alloc_ref = (uintptr_t)&arena->scope.allocator,
+       .relocs = relocs,
+   };
+   for (struct arena_pin *pin = arena->pins; pin; pin = pin->next) {
+      if (pin->kind == ARENA_PIN_SLOT) {
+         arena_image_visit(pin->target, &state);
+      } else if (pin->kind == ARENA_PIN_FARRAY) {
+         sc_array_base *arr = pin->target;
+         arena_image_visit(&arr->bucket, &state);
+         arena_image_visit(&arr->end, &state);
+         arena_image_visit(&arr->alloc, &state);
+      } else if (pin->kind == ARENA_PIN_LIST) {
+         list_image_slots(pin->target, pin->elements, arena_image_visit, &state);
+      } else {
+         slotarray_image_slots(pin->target, pin->elements, arena_image_visit, &state);
       }
+   }
+   return state.count;
+}
+
+// Record one pinned slot: pointers into the page are rebased, the allocator is
+// patched, and anything else (NULL, foreign memory) is saved as-is
+static void arena_image_visit(object slot, void *ctx) {
+   struct arena_image_relocs *state = ctx;
+   sc_page *page = state->page;
+   if ((char *)slot < page->data || (char *)slot + sizeof(uintptr_t) > page->data + page->used)
+      return;
 
-      inner_frame->valid = false;  // Mark as invalid before disposing
-      memory_dispose(inner_frame); // Free inner frame
+   uintptr_t value;
+   memcpy(&value, slot, sizeof(value));
+   uint64_t entry = (uint64_t)((char *)slot - (char *)page);
+   if (value == state->alloc_ref) {
+      entry |= ARENA_IMAGE_RELOC_ALLOCATOR;
+   } else if (value < (uintptr_t)page->data || value > (uintptr_t)page->data + page->used) {
+      return; // One-past-the-end pointers (e.g. bucket ends) are relocated too
    }
+
+   if (state->relocs)
+      state->relocs[state->count] = entry;
+   state->count++;
+}
+
+static int arena_image_compare(const void *left, const void *right) {
+   uint64_t a = *(const uint64_t *)left & ~ARENA_IMAGE_RELOC_ALLOCATOR;
+   uint64_t b = *(const uint64_t *)right & ~ARENA_IMAGE_RELOC_ALLOCATOR;
+   return (a > b) - (a < b);
+}
+
+// Register a fixup; only reserved arenas can be saved, so only they take pins
+static int arena_pin_add(arena arena, object target, enum arena_pin_kind kind, bool elements) {
+   if (!arena_validate(arena) || arena->image || !arena->root_pages || !arena->root_pages->mapped)
+      return ERR;
+   if (!arena_contains(arena, target))
+      return ERR;
+
+   struct arena_pin *pin = pool_alloc(arena->root_pool, sizeof(struct arena_pin), false);
+   if (!pin)
+      return ERR;
+   pin->target = target;
+   pin->kind = kind;
+   pin->elements = elements;
+   pin->next = arena->pins;
+   arena->pins = pin;
+   return OK;
 }
 
-static void arena_end_frame_reset_bump_pointer(frame current_frame, arena arena) {
-   // Reset bump pointer to frame start
-   if (current_frame->start_page && current_frame->start_page == arena->current_page) {
-      current_frame->start_page->bump = current_frame->bump_start;
-      if (current_frame->bump_start >= (void *)current_frame->start_page->data) {
-         current_frame->start_page->used = (char *)current_frame->bump_start - current_frame->start_page->data;
+// Drop pins whose target was freed by a rollback (the memory may be reused for anything)
+static void arena_unpin_freed(arena arena) {
+   struct arena_pin **link = &arena->pins;
+   while (*link) {
+      struct arena_pin *pin = *link;
+      if (arena_contains(arena, pin->target)) {
+         link = &pin->next;
+      } else {
+         *link = pin->next;
+         pool_free(arena->root_pool, pin);
       }
-   } else {
-      // Frame spanned multiple pages - reset starting page
-      if (current_frame->start_page) {
-         current_frame->start_page->bump = current_frame->bump_start;
-         if (current_frame->bump_start >= (void *)current_frame->start_page->data) {
-            current_frame->start_page->used = (char *)current_frame->bump_start - current_frame->start_page->data;
-         }
+   }
+}
+
+static bool arena_image_write(FILE *file, const struct arena_image_header *header,
+                              const uint64_t *relocs, const sc_page *page) {
+   if (fwrite(header, sizeof(*header), 1, file) != 1)
+      return false;
+   if (header->reloc_count && fwrite(relocs, sizeof(uint64_t), header->reloc_count, file) != header->reloc_count)
+      return false;
+   if (fseek(file, (long)header->body_offset, SEEK_SET) != 0)
+      return false;
+   return fwrite(page, 1, header->size, file) == header->size;
+}
+
+// Validate an image header against the file holding it; nothing in it is trusted
+static bool arena_image_check(const struct arena_image_header *header, uint64_t file_size) {
+   if (memcmp(header->magic, ARENA_IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+       header->version != ARENA_IMAGE_VERSION || header->data_offset != sizeof(sc_page))
+      return false;
+   // The relocation table sits between the header and the body
+   if (header->reloc_count > (file_size - sizeof(*header)) / sizeof(uint64_t))
+      return false;
+   uint64_t table_end = sizeof(*header) + header->reloc_count * sizeof(uint64_t);
+   if (header->body_offset < table_end || header->body_offset % vmem_page_size() != 0 ||
+       header->body_offset > file_size)
+      return false;
+   // The body must be all there: a mapping past the end of the file faults on access
+   if (header->used > file_size || header->size != header->data_offset + header->used ||
+       header->size > file_size - header->body_offset)
+      return false;
+   return header->root == ARENA_IMAGE_NO_ROOT || (header->root >= header->data_offset && header->root < header->size);
+}
+
+// Track a fresh allocation and update the running counters
+static void arena_alloc_account(arena arena, object ptr, usize size) {
+   struct block *block = arena_create_block(arena, ptr, size);
+   if (block) {
+      arena_add_block(arena, block);
+   }
+
+   arena->used += size;
+   memory_tag_charge(arena->scope.tag, size);
+   MEMORY_TRACE(TRACE_ALLOC, ptr, size);
+   if (arena->used > arena->peak)
+      arena->peak = arena->used;
+}
+
+// Release adopted buffers, most recent first, until `stop` is at the head of the list
+static void arena_run_finalizers(arena arena, struct arena_finalizer *stop) {
+   while (arena->finalizers && arena->finalizers != stop) {
+      struct arena_finalizer *finalizer = arena->finalizers;
+      arena->finalizers = finalizer->next;
+      if (finalizer->release) {
+         finalizer->release(finalizer->ptr, finalizer->size);
+         pool_free(arena->root_pool, finalizer);
+      } else {
+         finalizer->defer(finalizer->ptr);
       }
    }
+   if (!arena->finalizers)
+      arena->finalizers_tail = NULL;
 }
 
-static void arena_end_frame_cleanup_tracking(frame current_frame, arena arena) {
-   // Clean up tracking entries added during this frame
-   // Free allocations from tail_start onward
-   struct block *current = current_frame->tail_start;
+// Return the empty pages past the current page to the page cache
+static void arena_release_spare_pages(arena arena) {
+   if (!arena->current_page)
+      return;
+
+   sc_page *page = arena->current_page->next;
+   arena->current_page->next = NULL;
+   while (page) {
+      sc_page *next = page->next;
+      arena->page_count--;
+      arena->reserved -= page->capacity;
+      page_destroy(page);
+      page = next;
+   }
+}
+
+// Free the forwarding headers of arenas merged into this one
+static void arena_dispose_absorbed(arena arena) {
+   sc_arena *absorbed = arena->absorbed;
+   while (absorbed) {
+      sc_arena *next = absorbed->next_absorbed;
+      arena_dispose_absorbed(absorbed);
+      memory_dispose(absorbed);
+      absorbed = next;
+   }
+   arena->absorbed = NULL;
+}
+
+// Frame management helpers
+static void arena_end_frame_invalidate_inner_frames(arena arena, usize depth) {
+   for (usize i = depth + 1; i < arena->frame_depth; i++) {
+      arena->frames[i].valid = false;
+   }
+}
+
+static void arena_end_frame_reset_bump_pointer(sc_frame *current_frame, arena arena) {
+   // Pages begun after the frame started are emptied but kept for reuse; an empty page
+   // may sit before used ones (an allocation too large for it skipped ahead), so walk them all
+   sc_page *start = current_frame->start_page;
+   sc_page *page = start ? start->next : arena->root_pages;
+   while (page) {
+      page->bump = page->data;
+      page->used = 0;
+      page = page->next;
+   }
+
+   if (start) {
+      // Reset bump pointer of the starting page to the frame start
+      start->bump = current_frame->bump_start;
+      start->used = (char *)current_frame->bump_start - start->data;
+      arena->current_page = start;
+   } else {
+      // Frame began before the arena had any page
+      arena->current_page = arena->root_pages;
+   }
+
+   // Everything past the marker is gone, so the counters return to their frame-start values
+   memory_tag_release(arena->scope.tag, arena->used - current_frame->used_start);
+   arena->used = current_frame->used_start;
+   arena->tail_waste = current_frame->waste_start;
+   if (arena->pins)
+      arena_unpin_freed(arena);
+}
+
+static void arena_end_frame_cleanup_tracking(sc_frame *current_frame, arena arena) {
+   // Clean up tracking entries for the frame's own allocations; pointers tracked
+   // explicitly (alloc_size 0, e.g. moved in from another scope) stay tracked
+   struct block *current = current_frame->tail_start ? current_frame->tail_start->next_alloc : arena->alloc_head;
    while (current) {
       struct block *next = current->next_alloc;
-      pool_free(arena->root_pool, current);
+      if (current->alloc_size > 0) {
+         arena_remove_block(arena, current);
+         pool_free(arena->root_pool, current);
+      }
       current = next;
    }
+}
+#endif
+
+#if 1 // Region: Scope operations
+static object arena_scope_alloc(void *scope, usize size, bool zero) {
+   return arena_alloc(arena_resolve((arena)scope), size, zero);
+}
+
+static void arena_scope_free(void *scope, object ptr) {
+   // Arena memory is released in bulk by frames and dispose
+   (void)scope;
+   (void)ptr;
+}
+
+static object arena_scope_realloc(void *scope, object ptr, usize old_size, usize new_size) {
+   return arena_realloc(arena_resolve((arena)scope), ptr, old_size, new_size);
+}
+
+static int arena_scope_track(void *scope, object ptr) {
+   arena arena = arena_resolve((sc_arena *)scope);
+   struct block *block = arena_create_block(arena, ptr, 0); // 0 for external pointers
+   if (!block)
+      return ERR;
+   arena_add_block(arena, block);
+   return OK;
+}
+
+static int arena_scope_untrack(void *scope, object ptr) {
+   arena arena = arena_resolve((sc_arena *)scope);
+   struct block *block = arena_find_block(arena, ptr);
+   if (!block)
+      return ERR; // Not owned by this arena
+
+   // Frames marking this block as their start fall back to its predecessor
+   for (usize i = 0; i < arena->frame_depth; i++) {
+      sc_frame *marker = &arena->frames[i];
+      if (marker->tail_start == block)
+         marker->tail_start = block->prev_alloc;
+      if (marker->tail_origin == block)
+         marker->tail_origin = block->prev_alloc;
+   }
+   if (arena->fork_mark.valid && arena->fork_mark.tail_start == block)
+      arena->fork_mark.tail_start = block->prev_alloc;
+   arena_remove_block(arena, block);
+   pool_free(arena->root_pool, (object)block);
+   return OK;
+}
+
+static int arena_scope_adopt(void *scope, object ptr, usize size, scope_release_fn release) {
+   arena arena = arena_resolve((sc_arena *)scope);
+   if (!arena_validate(arena) || arena->image || !release)
+      return ERR;
+
+   struct arena_finalizer *finalizer = pool_alloc(arena->root_pool, sizeof(*finalizer), false);
+   if (!finalizer)
+      return ERR;
+
+   if (!arena->finalizers)
+      arena->finalizers_tail = finalizer;
+   finalizer->next = arena->finalizers;
+   finalizer->ptr = ptr;
+   finalizer->size = size;
+   finalizer->release = release;
+   finalizer->defer = NULL;
+   arena->finalizers = finalizer;
+   return OK;
+}
 
-   // Update arena's alloc_tail to point before the freed blocks
-   arena->alloc_tail = current_frame->tail_start ? current_frame->tail_start->prev_alloc : NULL;
-   if (arena->alloc_tail)
-      arena->alloc_tail->next_alloc = NULL;
+// Frame memory is arena memory, so once the frame ends (promoted objects may still grow)
+// allocation falls back to the arena
+static object frame_scope_alloc(void *scope, usize size, bool zero) {
+   sc_frame *current_frame = (sc_frame *)scope;
+   return current_frame->arena ? arena_scope_alloc(current_frame->arena, size, zero) : NULL;
+}
+
+static object frame_scope_realloc(void *scope, object ptr, usize old_size, usize new_size) {
+   sc_frame *current_frame = (sc_frame *)scope;
+   if (!current_frame->arena)
+      return NULL;
+   return arena_scope_realloc(current_frame->arena, ptr, old_size, new_size);
+}
+
+static int frame_scope_track(void *scope, object ptr) {
+   sc_frame *current_frame = (sc_frame *)scope;
+   return frame_validate(current_frame) ? arena_scope_track(current_frame->arena, ptr) : ERR;
+}
+
+static int frame_scope_untrack(void *scope, object ptr) {
+   sc_frame *current_frame = (sc_frame *)scope;
+   return frame_validate(current_frame) ? arena_scope_untrack(current_frame->arena, ptr) : ERR;
+}
+static int frame_scope_adopt(void *scope, object ptr, usize size, scope_release_fn release) {
+   sc_frame *current_frame = (sc_frame *)scope;
+   return frame_validate(current_frame) ? arena_scope_adopt(current_frame->arena, ptr, size, release) : ERR;
 }
 #endif
 
 #if 1 // Region: Page helper functions
-// Create a new arena page
-static sc_page *page_create(void) {
-   sc_page *page = malloc(sizeof(sc_page));
+// Size of the page cache chunk backing a heap page (the cache needs room for its link)
+static usize page_chunk_size(usize capacity) {
+   return capacity < sizeof(object) ? sizeof(object) : capacity;
+}
+// Create a new arena page; the header lives out of line so the data (recycled through
+// the page cache) starts on an OS page and page-multiple capacities cover whole OS pages
+static sc_page *page_create(usize capacity, int node) {
+   sc_page *page = sysmem_alloc(sizeof(sc_page));
    if (!page)
       return NULL;
 
+   page->data = page_cache_acquire(page_chunk_size(capacity));
+   if (!page->data) {
+      sysmem_free(page);
+      return NULL;
+   }
+
    page->next = NULL;
    page->bump = page->data;
    page->used = 0;
+   page->capacity = capacity;
+   page->mapped = 0;
+   page->committed = 0;
+   page->node = -1;
+   if (node >= 0 && vmem_numa_bind(page->data, capacity, node) == OK)
+      page->node = node; // Best effort, like huge pages: an unbound page still works
+
+   MEMORY_TRACE(TRACE_PAGE_GROW, page->data, capacity);
+   return page;
+}
+// Create a page spanning a reserved mapping; only the first `commit` bytes are accessible
+// (with an fd, the whole range maps the descriptor shared and `commit` is only accounting)
+static sc_page *page_create_reserved(usize reserve, usize commit, bool prefault, bool huge_pages, int node, int fd) {
+   if (reserve <= sizeof(sc_page))
+      return NULL;
+
+   // Start on a huge page boundary so every full commit step can be backed by huge pages
+   sc_page *page = vmem_reserve_aligned(reserve, huge_pages ? VMEM_HUGE_PAGE_SIZE : 0);
+   if (!page)
+      return NULL;
 
+   if (commit > reserve)
+      commit = reserve;
+   if (fd >= 0 ? vmem_remap_fd(page, reserve, fd, false) != OK
+               : vmem_commit(page, commit, prefault, huge_pages) != OK) {
+      vmem_release(page, reserve);
+      return NULL;
+   }
+   if (fd >= 0 && huge_pages)
+      vmem_advise_huge(page, reserve); // Best effort; the arena works without it
+
+   page->next = NULL;
+   page->data = (char *)(page + 1);
+   page->bump = page->data;
+   page->used = 0;
+   page->capacity = reserve - sizeof(sc_page);
+   page->mapped = reserve;
+   page->committed = commit;
+   page->node = -1;
+   if (node >= 0 && vmem_numa_bind(page, commit, node) == OK)
+      page->node = node;
+
+   MEMORY_TRACE(TRACE_PAGE_GROW, page, commit);
    return page;
 }
-// Destroy an arena page
+// Destroy an arena page (returned to the page cache)
 static void page_destroy(sc_page *page) {
    if (!page)
       return;
 
-   free(page);
+   if (page->mapped) {
+      MEMORY_TRACE(TRACE_PAGE_RELEASE, page, page->committed);
+      vmem_release(page, page->mapped);
+      return;
+   }
+   MEMORY_TRACE(TRACE_PAGE_RELEASE, page->data, page->capacity);
+   // Cached chunks are shared by every arena, so drop the binding before recycling
+   if (page->node >= 0)
+      vmem_numa_bind(page->data, page->capacity, -1);
+   page_cache_release(page->data, page_chunk_size(page->capacity));
+   sysmem_free(page);
 }
 // Allocate from a page
 static object page_alloc(sc_page *page, usize size, bool zero) {
@@ -501,7 +1730,7 @@ static object page_alloc(sc_page *page, usize size, bool zero) {
       return NULL;
 
    // Check if allocation fits
-   usize remaining = PAGE_DATA_SIZE - page->used;
+   usize remaining = page->capacity - page->used;
    if (size > remaining) {
       return NULL; // Page full or allocation too large
    }
@@ -518,6 +1747,18 @@ static object page_alloc(sc_page *page, usize size, bool zero) {
 
    return ptr;
 }
+// Allocate from a page with the bump pointer aligned for any object type
+static object page_alloc_aligned(sc_page *page, usize size, bool zero) {
+   if (!page)
+      return NULL;
+
+   usize start = arena_round_up(page->used, ARENA_ALIGN);
+   if (start > page->capacity || size > page->capacity - start)
+      return NULL;
+   page->bump = page->data + start;
+   page->used = start;
+   return page_alloc(page, size, zero);
+}
 // Helper functions for block list management
 static void arena_add_block(arena arena, struct block *block) {
    if (!arena || !block)
@@ -532,6 +1773,7 @@ static void arena_add_block(arena arena, struct block *block) {
       arena->alloc_head = block;
    }
    arena->alloc_tail = block;
+   arena->tracked_blocks++;
 }
 static void arena_remove_block(arena arena, struct block *block) {
    if (!arena || !block)
@@ -551,14 +1793,13 @@ static void arena_remove_block(arena arena, struct block *block) {
 
    block->next_alloc = NULL;
    block->prev_alloc = NULL;
+   arena->tracked_blocks--;
 }
 #endif
 
 #if 1 // Region: Backdoor functions for testing (defined in page_tests.h)
 sc_page *Page_create(usize data_size) {
-   // For testing, we ignore data_size and use fixed PAGE_DATA_SIZE
-   (void)data_size;
-   return page_create();
+   return page_create(data_size ? data_size : PAGE_DATA_SIZE, -1);
 }
 void Page_destroy(sc_page *page) {
    page_destroy(page);
@@ -573,8 +1814,7 @@ usize Page_get_used(sc_page *page) {
    return page ? page->used : 0;
 }
 usize Page_get_capacity(sc_page *page) {
-   (void)page; // Unused
-   return PAGE_DATA_SIZE;
+   return page ? page->capacity : PAGE_DATA_SIZE;
 }
 slotarray Page_get_tracked_addrs(sc_page *page) {
    (void)page; // No longer tracking at page level
@@ -583,7 +1823,7 @@ slotarray Page_get_tracked_addrs(sc_page *page) {
 bool Page_contains(sc_page *page, object ptr) {
    if (!page || !ptr)
       return false;
-   return ptr >= (object)page->data && ptr < (object)(page->data + PAGE_DATA_SIZE);
+   return ptr >= (object)page->data && ptr < (object)(page->data + page->capacity);
 }
 usize Page_get_allocation_count(sc_page *page) {
    (void)page; // Allocation count no longer tracked per page
@@ -591,6 +1831,6 @@ usize Page_get_allocation_count(sc_page *page) {
 }
 // Get arena from frame (internal accessor)
 arena frame_get_arena(frame f) {
-   return f ? f->arena : NULL;
+   return f.slot ? f.slot->arena : NULL;
 }
 #endif
\ No newline at end of file
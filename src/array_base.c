@@ -25,6 +25,8 @@
  * Description: Implementation of unified base array operations
  */
 #include "internal/array_base.h"
+#include "internal/memory_internal.h"
+#include "internal/trace.h"
 #include "sigcore/types.h"
 #include <string.h>
 
@@ -36,6 +38,28 @@ int array_base_capacity(const sc_array_base *arr, usize element_size) {
    return (int)((arr->end - arr->bucket) / element_size);
 }
 
+// Resize the bucket through its allocator; new elements are zeroed
+int array_base_resize(sc_array_base *arr, usize element_size, usize capacity) {
+   if (!arr || !arr->bucket || capacity == 0) {
+      return ERR;
+   }
+
+   usize old_bytes = (char *)arr->end - (char *)arr->bucket;
+   usize new_bytes = capacity * element_size;
+   void *bucket = allocator_realloc(arr->alloc, arr->bucket, old_bytes, new_bytes);
+   if (!bucket) {
+      return ERR;
+   }
+   if (new_bytes > old_bytes) {
+      memset((char *)bucket + old_bytes, 0, new_bytes - old_bytes);
+   }
+
+   arr->bucket = bucket;
+   arr->end = (char *)bucket + new_bytes;
+   MEMORY_TRACE(TRACE_COLLECTION_GROW, bucket, new_bytes);
+   return OK;
+}
+
 // Check if index is valid for the array
 bool array_base_is_valid_index(const sc_array_base *arr, usize element_size, usize index) {
    return arr && arr->bucket && index < (usize)array_base_capacity(arr, element_size);
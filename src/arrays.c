@@ -30,31 +30,31 @@
 #include <string.h>
 
 // allocate memory for an array bucket
-object array_alloc_bucket(size_t element_size, usize capacity) {
+object array_alloc_bucket(allocator alloc, size_t element_size, usize capacity) {
    // Check for overflow: capacity * element_size > SIZE_MAX
    if (capacity > 0 && element_size > SIZE_MAX / capacity) {
       return NULL; // Would overflow
    }
-   return scope_alloc(element_size * capacity, false);
+   return allocator_alloc(alloc, element_size * capacity, false);
 }
 
-// free array resources (bucket and struct)
-void array_free_resources(void *bucket, void *struct_ptr) {
+// free array resources (bucket and struct) back to their allocator
+void array_free_resources(allocator alloc, void *bucket, void *struct_ptr) {
    if (bucket) {
-      Memory.dispose(bucket);
+      allocator_free(alloc, bucket);
    }
    if (struct_ptr) {
-      Memory.dispose(struct_ptr);
+      allocator_free(alloc, struct_ptr);
    }
 }
 
 // Common array structure allocation with bucket
 // Handles the common pattern: allocate struct, set handle, allocate bucket, set end, check overflow
-void *array_alloc_struct_with_bucket(usize struct_size, char handle_char,
+void *array_alloc_struct_with_bucket(allocator alloc, usize struct_size, char handle_char,
                                      usize element_size, usize capacity,
                                      void **bucket_out, char **end_out) {
    // Allocate memory for the array structure
-   void *struct_ptr = scope_alloc(struct_size, false);
+   void *struct_ptr = allocator_alloc(alloc, struct_size, false);
    if (!struct_ptr) {
       return NULL;
    }
@@ -64,9 +64,9 @@ void *array_alloc_struct_with_bucket(usize struct_size, char handle_char,
    ((char *)struct_ptr)[1] = '\0';
 
    // Allocate memory for the bucket
-   void *bucket = array_alloc_bucket(element_size, capacity);
+   void *bucket = array_alloc_bucket(alloc, element_size, capacity);
    if (!bucket && capacity > 0) {
-      Memory.dispose(struct_ptr);
+      allocator_free(alloc, struct_ptr);
       return NULL;
    }
 
@@ -75,7 +75,7 @@ void *array_alloc_struct_with_bucket(usize struct_size, char handle_char,
 
    // Check for pointer arithmetic overflow
    if (capacity > 0 && end < (char *)bucket) {
-      array_free_resources(bucket, struct_ptr);
+      array_free_resources(alloc, bucket, struct_ptr);
       return NULL;
    }
 
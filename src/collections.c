@@ -32,6 +32,7 @@
 #include "internal/arrays.h"
 #include "internal/collections.h"
 #include "internal/memory_internal.h"
+#include "internal/trace.h"
 #include "sigcore/memory.h"
 #include <string.h>
 
@@ -46,14 +47,20 @@ void iter_dispose(iterator it);
 
 // create a collection view of array data
 collection collection_create_view(void *array, usize stride, usize length, bool owns_buffer) {
-   struct sc_collection *coll = scope_alloc(sizeof(struct sc_collection), false);
+   // Views of farray/parray share the array's allocator so an owned buffer is freed correctly
+   char array_handle = array ? ((char *)array)[0] : '\0';
+   allocator alloc = (array_handle == 'F' || array_handle == 'P')
+                         ? ((sc_array_base *)array)->alloc
+                         : scope_allocator();
+
+   struct sc_collection *coll = allocator_alloc(alloc, sizeof(struct sc_collection), false);
    if (!coll) {
       return NULL;
    }
+   coll->array.alloc = alloc;
 
    if (array) {
       // Copy handle from the array to determine storage type
-      char array_handle = ((char *)array)[0];
       coll->array.handle[0] = array_handle;
       coll->array.handle[1] = ((char *)array)[1];
 
@@ -129,11 +136,20 @@ inline void collection_set_length(collection coll, usize length) {
 
 // create a new collection with the specified capacity and stride
 collection collection_new(usize capacity, usize stride) {
+   return collection_new_with(capacity, stride, NULL);
+}
+
+// create a new collection whose struct and bucket come from the given allocator
+collection collection_new_with(usize capacity, usize stride, allocator alloc) {
    void *bucket;
    char *end;
 
+   if (!alloc) {
+      alloc = scope_allocator();
+   }
+
    struct sc_collection *coll = array_alloc_struct_with_bucket(
-       sizeof(struct sc_collection), 'P', stride, capacity, &bucket, &end);
+       alloc, sizeof(struct sc_collection), 'P', stride, capacity, &bucket, &end);
 
    if (!coll) {
       return NULL;
@@ -141,6 +157,7 @@ collection collection_new(usize capacity, usize stride) {
 
    coll->array.bucket = bucket;
    coll->array.end = end;
+   coll->array.alloc = alloc;
    coll->stride = stride;
    coll->length = 0;
    coll->owns_buffer = true;
@@ -154,9 +171,9 @@ void collection_dispose(collection coll) {
    }
 
    if (coll->owns_buffer && coll->array.bucket) {
-      Memory.dispose(coll->array.bucket);
+      allocator_free(coll->array.alloc, coll->array.bucket);
    }
-   Memory.dispose(coll);
+   allocator_free(coll->array.alloc, coll);
 }
 // get the count of elements in the collection
 usize collection_count(collection coll) {
@@ -177,15 +194,16 @@ int collection_grow(collection coll) {
    } else {
       new_capacity = current_capacity * 2;
    }
-   void *new_buffer = scope_alloc(coll->stride * new_capacity, false);
+   // Grow through the allocator that owns the bucket
+   void *new_buffer = allocator_realloc(coll->array.alloc, coll->array.bucket,
+                                        coll->stride * current_capacity, coll->stride * new_capacity);
    if (!new_buffer) {
       return ERR;
    }
 
-   memcpy(new_buffer, coll->array.bucket, coll->stride * current_capacity);
-   Memory.dispose(coll->array.bucket);
    coll->array.bucket = new_buffer;
    coll->array.end = (char *)new_buffer + coll->stride * new_capacity;
+   MEMORY_TRACE(TRACE_COLLECTION_GROW, new_buffer, coll->stride * new_capacity);
    return OK;
 }
 
@@ -265,9 +283,10 @@ usize collection_get_count(collection coll) {
 iterator collection_create_iterator(collection coll) {
    if (!coll)
       return NULL;
-   iterator it = scope_alloc(sizeof(struct iterator_s), false);
+   iterator it = allocator_alloc(coll->array.alloc, sizeof(struct iterator_s), false);
    if (!it)
       return NULL;
+   it->alloc = coll->array.alloc;
    it->coll = coll;
    it->current = 0;
    return it;
@@ -308,7 +327,7 @@ void iter_reset(iterator it) {
 /* Disposes the iterator */
 void iter_dispose(iterator it) {
    if (it)
-      Memory.dispose(it);
+      allocator_free(it->alloc, it);
 }
 
 const sc_iterator_i Iterator = {
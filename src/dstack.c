@@ -0,0 +1,287 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: dstack.c
+ * Description: SigmaCore double-ended stack allocator
+ *
+ * The dstack header sits at the start of its own reserved mapping, like a
+ * reserved arena page. The bottom end bumps upward from just past the
+ * header and the top end bumps downward from the end of the mapping. Each
+ * end commits its side of the mapping in VMEM_COMMIT_STEP steps; the two
+ * committed ranges are clamped so they never re-map each other's pages.
+ */
+#include "sigcore/dstack.h"
+#include "internal/memory_internal.h"
+#include "internal/vmem.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Alignment of every dstack allocation
+#define DSTACK_ALIGN _Alignof(max_align_t)
+
+// Internal dstack structure, stored at the start of its mapping
+struct sc_dstack {
+   usize size;                // Bytes of the mapping
+   usize base;                // Offset of the first bottom byte (past this header)
+   usize bottom;              // Offset one past the last bottom allocation
+   usize top;                 // Offset of the last top allocation
+   usize bottom_committed;    // Accessible bytes from the start of the mapping
+   usize top_committed;       // Offset where the accessible top range begins
+   sc_allocator allocators[2]; // Indexed by dstack_end
+};
+
+#if 1 // Region: Forward declarations
+// API functions
+static dstack dstack_create(usize capacity);
+static void dstack_dispose(dstack ds);
+static object dstack_alloc(dstack ds, dstack_end end, usize size, bool zero);
+static dstack_marker dstack_mark(dstack ds, dstack_end end);
+static int dstack_pop(dstack ds, dstack_end end, dstack_marker marker);
+static void dstack_reset(dstack ds, dstack_end end);
+static usize dstack_remaining(dstack ds);
+static allocator dstack_get_allocator(dstack ds, dstack_end end);
+
+// Helper/utility functions
+static bool dstack_commit_bottom(dstack ds, usize offset);
+static bool dstack_commit_top(dstack ds, usize offset);
+static usize dstack_round_up(usize size, usize step);
+
+// Allocator adapters
+static object dstack_bottom_alloc(void *ctx, usize size, bool zero);
+static object dstack_top_alloc(void *ctx, usize size, bool zero);
+static void dstack_allocator_free(void *ctx, object ptr);
+static object dstack_bottom_realloc(void *ctx, object ptr, usize old_size, usize new_size);
+static object dstack_top_realloc(void *ctx, object ptr, usize old_size, usize new_size);
+#endif
+
+// Create a double-ended stack over one reserved region
+static dstack dstack_create(usize capacity) {
+   usize base = dstack_round_up(sizeof(struct sc_dstack), DSTACK_ALIGN);
+   if (capacity == 0 || capacity > SIZE_MAX - base - VMEM_COMMIT_STEP)
+      return NULL;
+
+   usize size = dstack_round_up(base + capacity, VMEM_COMMIT_STEP);
+   dstack ds = vmem_reserve(size);
+   if (!ds)
+      return NULL;
+   if (vmem_commit(ds, VMEM_COMMIT_STEP, false, false) != OK) {
+      vmem_release(ds, size);
+      return NULL;
+   }
+
+   ds->size = size;
+   ds->base = base;
+   ds->bottom = base;
+   ds->top = size;
+   ds->bottom_committed = VMEM_COMMIT_STEP;
+   ds->top_committed = size;
+   ds->allocators[DSTACK_BOTTOM] = (sc_allocator){
+       .alloc = dstack_bottom_alloc,
+       .free = dstack_allocator_free,
+       .realloc = dstack_bottom_realloc,
+       .ctx = ds,
+   };
+   ds->allocators[DSTACK_TOP] = (sc_allocator){
+       .alloc = dstack_top_alloc,
+       .free = dstack_allocator_free,
+       .realloc = dstack_top_realloc,
+       .ctx = ds,
+   };
+   return ds;
+}
+
+// Release the region
+static void dstack_dispose(dstack ds) {
+   if (ds)
+      vmem_release(ds, ds->size);
+}
+
+// Allocate from one end
+static object dstack_alloc(dstack ds, dstack_end end, usize size, bool zero) {
+   if (!ds || size == 0)
+      return NULL;
+
+   char *region = (char *)ds;
+   object ptr;
+   if (end == DSTACK_BOTTOM) {
+      usize start = dstack_round_up(ds->bottom, DSTACK_ALIGN);
+      if (start > ds->top || size > ds->top - start || !dstack_commit_bottom(ds, start + size))
+         return NULL;
+      ptr = region + start;
+      ds->bottom = start + size;
+   } else {
+      if (size > ds->top - ds->bottom)
+         return NULL;
+      usize start = (ds->top - size) & ~(DSTACK_ALIGN - 1);
+      if (start < ds->bottom || !dstack_commit_top(ds, start))
+         return NULL;
+      ptr = region + start;
+      ds->top = start;
+   }
+
+   // Fresh pages are zero, but popped memory is reused as-is
+   if (zero)
+      memset(ptr, 0, size);
+   return ptr;
+}
+
+// Get the current position of one end
+static dstack_marker dstack_mark(dstack ds, dstack_end end) {
+   if (!ds)
+      return 0;
+   return end == DSTACK_BOTTOM ? ds->bottom : ds->top;
+}
+
+// Pop one end back to a marker
+static int dstack_pop(dstack ds, dstack_end end, dstack_marker marker) {
+   if (!ds)
+      return ERR;
+
+   if (end == DSTACK_BOTTOM) {
+      if (marker < ds->base || marker > ds->bottom)
+         return ERR;
+      ds->bottom = marker;
+   } else {
+      if (marker < ds->top || marker > ds->size)
+         return ERR;
+      ds->top = marker;
+   }
+   return OK;
+}
+
+// Release everything on one end
+static void dstack_reset(dstack ds, dstack_end end) {
+   if (!ds)
+      return;
+   if (end == DSTACK_BOTTOM)
+      ds->bottom = ds->base;
+   else
+      ds->top = ds->size;
+}
+
+// Free bytes between the ends
+static usize dstack_remaining(dstack ds) {
+   return ds ? ds->top - ds->bottom : 0;
+}
+
+// Get the allocator of one end
+static allocator dstack_get_allocator(dstack ds, dstack_end end) {
+   return ds ? &ds->allocators[end == DSTACK_BOTTOM ? DSTACK_BOTTOM : DSTACK_TOP] : NULL;
+}
+
+// Public interface
+const sc_dstack_i DStack = {
+    .create = dstack_create,
+    .dispose = dstack_dispose,
+    .alloc = dstack_alloc,
+    .mark = dstack_mark,
+    .pop = dstack_pop,
+    .reset = dstack_reset,
+    .remaining = dstack_remaining,
+    .allocator = dstack_get_allocator,
+};
+
+#if 1 // Region: Helper/utility function definitions
+// Make the bottom range accessible up to `offset`, without reaching the top's pages
+static bool dstack_commit_bottom(dstack ds, usize offset) {
+   if (offset <= ds->bottom_committed)
+      return true;
+
+   usize target = dstack_round_up(offset, VMEM_COMMIT_STEP);
+   if (target > ds->top_committed)
+      target = ds->top_committed;
+   if (target == ds->bottom_committed)
+      return true; // The rest is already committed by the top end
+   if (vmem_commit((char *)ds + ds->bottom_committed, target - ds->bottom_committed, false, false) != OK)
+      return false;
+
+   ds->bottom_committed = target;
+   return true;
+}
+
+// Make the top range accessible down to `offset`, without reaching the bottom's pages
+static bool dstack_commit_top(dstack ds, usize offset) {
+   if (offset >= ds->top_committed)
+      return true;
+
+   usize target = offset / VMEM_COMMIT_STEP * VMEM_COMMIT_STEP;
+   if (target < ds->bottom_committed)
+      target = ds->bottom_committed;
+   if (target == ds->top_committed)
+      return true; // The rest is already committed by the bottom end
+   if (vmem_commit((char *)ds + target, ds->top_committed - target, false, false) != OK)
+      return false;
+
+   ds->top_committed = target;
+   return true;
+}
+
+static usize dstack_round_up(usize size, usize step) {
+   return (size + step - 1) / step * step;
+}
+#endif
+
+#if 1 // Region: Allocator adapters
+static object dstack_bottom_alloc(void *ctx, usize size, bool zero) {
+   return dstack_alloc((dstack)ctx, DSTACK_BOTTOM, size, zero);
+}
+
+static object dstack_top_alloc(void *ctx, usize size, bool zero) {
+   return dstack_alloc((dstack)ctx, DSTACK_TOP, size, zero);
+}
+
+static void dstack_allocator_free(void *ctx, object ptr) {
+   // Dstack memory is released by popping to a marker
+   (void)ctx;
+   (void)ptr;
+}
+
+static object dstack_bottom_realloc(void *ctx, object ptr, usize old_size, usize new_size) {
+   dstack ds = (dstack)ctx;
+   char *region = (char *)ds;
+
+   // The last bottom allocation can grow in place
+   if (ptr && (char *)ptr + old_size == region + ds->bottom) {
+      usize start = (usize)((char *)ptr - region);
+      if (new_size <= ds->top - start && dstack_commit_bottom(ds, start + new_size)) {
+         ds->bottom = start + new_size;
+         return ptr;
+      }
+      return NULL;
+   }
+
+   object new_ptr = dstack_alloc(ds, DSTACK_BOTTOM, new_size, false);
+   if (new_ptr && ptr)
+      memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+   return new_ptr;
+}
+
+static object dstack_top_realloc(void *ctx, object ptr, usize old_size, usize new_size) {
+   // The top grows downward, so a resized block always moves
+   object new_ptr = dstack_alloc((dstack)ctx, DSTACK_TOP, new_size, false);
+   if (new_ptr && ptr)
+      memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+   return new_ptr;
+}
+#endif
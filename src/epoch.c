@@ -0,0 +1,433 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: epoch.c
+ * Description: SigmaCore epoch-based memory reclamation
+ *
+ * A domain holds a global epoch and a list of per-thread records. A record
+ * publishes the epoch its thread entered a read section in (or 0 outside
+ * one) and keeps three retire bags, one per epoch modulo 3. The global epoch
+ * advances only when every active record has seen it, so a bag retired in
+ * epoch e is safe to release once the global epoch reaches e + 2.
+ *
+ * Records are only ever added to a domain (a detached thread's record is
+ * reused by the next thread that registers), so readers walk the list
+ * without locks. Each thread finds its record through a small thread-local
+ * cache keyed by domain id. A thread's records are also linked into a
+ * thread-local list that a tss destructor walks when the thread exits, so a
+ * thread that never detaches (or exits inside a read section) cannot stall
+ * the epoch or leave records owned by a dead thread.
+ */
+#include "sigcore/epoch.h"
+#include "internal/memory_internal.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <threads.h>
+
+// Retire bags per record: the current epoch and the two before it
+#define EPOCH_BAGS 3
+// Retirements between a thread's attempts to advance and reclaim
+#define EPOCH_RECLAIM_BATCH 64
+// Domains a thread can use before its record lookups fall back to the list
+#define EPOCH_THREAD_CACHE 4
+// Low bit of a record's published epoch: the thread is inside a read section
+#define EPOCH_ACTIVE 1
+
+// Retired object waiting for its epoch to expire
+struct epoch_node {
+   struct epoch_node *next;
+   object ptr;
+   usize size;
+   scope_release_fn release;
+};
+
+// Objects retired by one thread in one epoch
+struct epoch_bag {
+   uint64_t epoch;          // Epoch the objects were retired in
+   struct epoch_node *head; // Most recently retired first
+   usize count;
+};
+
+// Per-thread state within a domain
+struct epoch_record {
+   _Atomic uint64_t local;            // (epoch << 1) | EPOCH_ACTIVE inside a read section, 0 outside
+   _Atomic(void *) owner;             // Token of the owning thread (NULL = free for reuse)
+   struct epoch_record *next;         // Next record (fixed once published)
+   struct epoch_record *thread_next;  // Next record owned by the same thread (under epoch_thread_lock)
+   struct epoch_record **thread_prev; // Link pointing at this record, NULL when not owned
+   usize depth;                       // Read section nesting
+   usize since_reclaim;               // Retirements since the last reclaim attempt
+   struct epoch_bag bags[EPOCH_BAGS]; // Indexed by epoch % EPOCH_BAGS
+   pool nodes;                        // Retire nodes; only the owning thread touches it
+};
+
+// Reclamation domain
+struct sc_epoch {
+   _Atomic uint64_t global;                  // Current epoch
+   _Atomic(struct epoch_record *) records;   // All records, newest first
+   _Atomic usize pending;                    // Retired objects not yet released
+   uint64_t id;                              // Unique id for the thread caches
+};
+
+// Thread-local record cache entry
+struct epoch_cache_entry {
+   uint64_t id;
+   struct epoch_record *record;
+};
+
+static _Atomic uint64_t epoch_next_id = 1;
+// Its address identifies the calling thread
+static _Thread_local char epoch_thread_token;
+static _Thread_local struct epoch_cache_entry epoch_cache[EPOCH_THREAD_CACHE];
+static _Thread_local usize epoch_cache_next = 0;
+// Records the calling thread owns; other threads only unlink from it under epoch_thread_lock
+static _Thread_local struct epoch_record *epoch_thread_records = NULL;
+static mtx_t epoch_thread_lock;
+static tss_t epoch_thread_key;
+
+#if 1 // Region: Forward declarations
+// API functions
+static epoch epoch_create(void);
+static void epoch_dispose(epoch domain);
+static int epoch_enter(epoch domain);
+static void epoch_exit(epoch domain);
+static int epoch_retire(epoch domain, object ptr, usize size, scope_release_fn release);
+static usize epoch_reclaim(epoch domain);
+static usize epoch_synchronize(epoch domain);
+static void epoch_detach(epoch domain);
+static usize epoch_pending(epoch domain);
+
+// Helper functions
+static struct epoch_record *epoch_record_get(epoch domain, bool create);
+static struct epoch_record *epoch_record_create(epoch domain);
+static void epoch_try_advance(epoch domain);
+static usize epoch_bag_release(epoch domain, struct epoch_record *record, struct epoch_bag *bag);
+static usize epoch_record_reclaim(epoch domain, struct epoch_record *record);
+static bool epoch_record_idle(struct epoch_record *record);
+static void epoch_thread_attach(struct epoch_record *record);
+static void epoch_thread_unlink(struct epoch_record *record);
+static void epoch_thread_exit(void *token);
+static void epoch_release_memory(object ptr, usize size);
+#endif
+
+const sc_epoch_i Epoch = {
+    .create = epoch_create,
+    .dispose = epoch_dispose,
+    .enter = epoch_enter,
+    .exit = epoch_exit,
+    .retire = epoch_retire,
+    .reclaim = epoch_reclaim,
+    .synchronize = epoch_synchronize,
+    .detach = epoch_detach,
+    .pending = epoch_pending,
+};
+
+#if 1 // Region: API functions
+static epoch epoch_create(void) {
+   epoch domain = memory_alloc(sizeof(struct sc_epoch), true);
+   if (!domain)
+      return NULL;
+
+   // Epochs start at EPOCH_BAGS so a fresh bag's epoch (0) never looks current
+   atomic_init(&domain->global, EPOCH_BAGS);
+   atomic_init(&domain->records, NULL);
+   atomic_init(&domain->pending, 0);
+   domain->id = atomic_fetch_add(&epoch_next_id, 1);
+   return domain;
+}
+
+static void epoch_dispose(epoch domain) {
+   if (!domain)
+      return;
+
+   struct epoch_record *record = atomic_load(&domain->records);
+   mtx_lock(&epoch_thread_lock);
+   for (struct epoch_record *r = record; r; r = r->next)
+      epoch_thread_unlink(r);
+   mtx_unlock(&epoch_thread_lock);
+   while (record) {
+      struct epoch_record *next = record->next;
+      for (usize i = 0; i < EPOCH_BAGS; i++)
+         epoch_bag_release(domain, record, &record->bags[i]);
+      pool_dispose(record->nodes);
+      memory_dispose(record);
+      record = next;
+   }
+   memory_dispose(domain);
+}
+
+static int epoch_enter(epoch domain) {
+   struct epoch_record *record = epoch_record_get(domain, true);
+   if (!record)
+      return ERR;
+
+   if (record->depth++ == 0) {
+      // Publish before reading anything shared; writers check this when advancing
+      uint64_t global = atomic_load(&domain->global);
+      atomic_store(&record->local, (global << 1) | EPOCH_ACTIVE);
+      atomic_thread_fence(memory_order_seq_cst);
+   }
+   return OK;
+}
+
+static void epoch_exit(epoch domain) {
+   struct epoch_record *record = epoch_record_get(domain, false);
+   if (!record || record->depth == 0)
+      return;
+
+   if (--record->depth == 0)
+      atomic_store_explicit(&record->local, 0, memory_order_release);
+}
+
+static int epoch_retire(epoch domain, object ptr, usize size, scope_release_fn release) {
+   if (!ptr)
+      return ERR;
+   struct epoch_record *record = epoch_record_get(domain, true);
+   if (!record)
+      return ERR;
+
+   // A bag still holding an older epoch with the same index is at least three epochs old
+   uint64_t global = atomic_load(&domain->global);
+   struct epoch_bag *bag = &record->bags[global % EPOCH_BAGS];
+   if (bag->epoch != global) {
+      epoch_bag_release(domain, record, bag);
+      bag->epoch = global;
+   }
+
+   struct epoch_node *node = pool_alloc(record->nodes, sizeof(struct epoch_node), false);
+   if (!node)
+      return ERR;
+   node->ptr = ptr;
+   node->size = size;
+   node->release = release ? release : epoch_release_memory;
+   node->next = bag->head;
+   bag->head = node;
+   bag->count++;
+   atomic_fetch_add_explicit(&domain->pending, 1, memory_order_relaxed);
+
+   if (++record->since_reclaim >= EPOCH_RECLAIM_BATCH) {
+      record->since_reclaim = 0;
+      epoch_try_advance(domain);
+      epoch_record_reclaim(domain, record);
+   }
+   return OK;
+}
+
+static usize epoch_reclaim(epoch domain) {
+   struct epoch_record *record = epoch_record_get(domain, false);
+   if (!record)
+      return 0;
+
+   epoch_try_advance(domain);
+   record->since_reclaim = 0;
+   return epoch_record_reclaim(domain, record);
+}
+
+static usize epoch_synchronize(epoch domain) {
+   struct epoch_record *record = epoch_record_get(domain, false);
+   if (!record || record->depth)
+      return 0; // Waiting inside a read section would wait for ourselves
+
+   usize released = 0;
+   while (!epoch_record_idle(record)) {
+      epoch_try_advance(domain);
+      released += epoch_record_reclaim(domain, record);
+      if (!epoch_record_idle(record))
+         sched_yield();
+   }
+   record->since_reclaim = 0;
+   return released;
+}
+
+static void epoch_detach(epoch domain) {
+   struct epoch_record *record = epoch_record_get(domain, false);
+   if (!record)
+      return;
+
+   for (usize i = 0; i < EPOCH_THREAD_CACHE; i++) {
+      if (epoch_cache[i].id == domain->id)
+         epoch_cache[i] = (struct epoch_cache_entry){0};
+   }
+   mtx_lock(&epoch_thread_lock);
+   epoch_thread_unlink(record);
+   mtx_unlock(&epoch_thread_lock);
+   record->depth = 0;
+   atomic_store(&record->local, 0);
+   atomic_store_explicit(&record->owner, NULL, memory_order_release);
+}
+
+static usize epoch_pending(epoch domain) {
+   return domain ? atomic_load_explicit(&domain->pending, memory_order_relaxed) : 0;
+}
+#endif
+
+#if 1 // Region: Helper functions
+// Find the calling thread's record, registering the thread if asked to
+static struct epoch_record *epoch_record_get(epoch domain, bool create) {
+   if (!domain)
+      return NULL;
+
+   for (usize i = 0; i < EPOCH_THREAD_CACHE; i++) {
+      if (epoch_cache[i].id == domain->id)
+         return epoch_cache[i].record;
+   }
+
+   // Not cached: a record this thread owns, else a free one, else a new one
+   void *self = &epoch_thread_token;
+   struct epoch_record *found = NULL;
+   for (struct epoch_record *r = atomic_load(&domain->records); r && !found; r = r->next) {
+      if (atomic_load_explicit(&r->owner, memory_order_acquire) == self)
+         found = r;
+   }
+   for (struct epoch_record *r = atomic_load(&domain->records); r && !found && create; r = r->next) {
+      void *expected = NULL;
+      if (atomic_compare_exchange_strong(&r->owner, &expected, self))
+         epoch_thread_attach(found = r);
+   }
+   if (!found && create && (found = epoch_record_create(domain)))
+      epoch_thread_attach(found);
+   if (!found)
+      return NULL;
+
+   epoch_cache[epoch_cache_next] = (struct epoch_cache_entry){domain->id, found};
+   epoch_cache_next = (epoch_cache_next + 1) % EPOCH_THREAD_CACHE;
+   return found;
+}
+
+// Allocate a record owned by the calling thread and publish it
+static struct epoch_record *epoch_record_create(epoch domain) {
+   struct epoch_record *record = memory_alloc(sizeof(struct epoch_record), true);
+   if (!record)
+      return NULL;
+   record->nodes = pool_create(1);
+   if (!record->nodes) {
+      memory_dispose(record);
+      return NULL;
+   }
+   atomic_init(&record->local, 0);
+   atomic_init(&record->owner, &epoch_thread_token);
+
+   record->next = atomic_load(&domain->records);
+   while (!atomic_compare_exchange_weak(&domain->records, &record->next, record))
+      ;
+   return record;
+}
+
+// Move the global epoch on if every thread in a read section has seen it
+static void epoch_try_advance(epoch domain) {
+   uint64_t global = atomic_load(&domain->global);
+   for (struct epoch_record *r = atomic_load(&domain->records); r; r = r->next) {
+      uint64_t local = atomic_load(&r->local);
+      if ((local & EPOCH_ACTIVE) && (local >> 1) != global)
+         return;
+   }
+   atomic_compare_exchange_strong(&domain->global, &global, global + 1);
+}
+
+// Release every object in a bag
+static usize epoch_bag_release(epoch domain, struct epoch_record *record, struct epoch_bag *bag) {
+   usize released = bag->count;
+   struct epoch_node *node = bag->head;
+   while (node) {
+      struct epoch_node *next = node->next;
+      node->release(node->ptr, node->size);
+      pool_free(record->nodes, node);
+      node = next;
+   }
+   bag->head = NULL;
+   bag->count = 0;
+   if (released)
+      atomic_fetch_sub_explicit(&domain->pending, released, memory_order_relaxed);
+   return released;
+}
+
+// Release a record's bags from epochs no reader can still be in
+static usize epoch_record_reclaim(epoch domain, struct epoch_record *record) {
+   uint64_t global = atomic_load(&domain->global);
+   usize released = 0;
+   for (usize i = 0; i < EPOCH_BAGS; i++) {
+      struct epoch_bag *bag = &record->bags[i];
+      if (bag->head && bag->epoch + 2 <= global)
+         released += epoch_bag_release(domain, record, bag);
+   }
+   return released;
+}
+
+static bool epoch_record_idle(struct epoch_record *record) {
+   for (usize i = 0; i < EPOCH_BAGS; i++) {
+      if (record->bags[i].head)
+         return false;
+   }
+   return true;
+}
+
+// Link a record the calling thread just took ownership of into its exit list
+static void epoch_thread_attach(struct epoch_record *record) {
+   mtx_lock(&epoch_thread_lock);
+   record->thread_next = epoch_thread_records;
+   if (record->thread_next)
+      record->thread_next->thread_prev = &record->thread_next;
+   record->thread_prev = &epoch_thread_records;
+   epoch_thread_records = record;
+   mtx_unlock(&epoch_thread_lock);
+   tss_set(epoch_thread_key, &epoch_thread_token);
+}
+
+// Remove a record from its owner's exit list (epoch_thread_lock held)
+static void epoch_thread_unlink(struct epoch_record *record) {
+   if (!record->thread_prev)
+      return;
+   *record->thread_prev = record->thread_next;
+   if (record->thread_next)
+      record->thread_next->thread_prev = record->thread_prev;
+   record->thread_next = NULL;
+   record->thread_prev = NULL;
+}
+
+// Thread-exit destructor registered through tss_create: detach every record the thread still owns
+static void epoch_thread_exit(void *token) {
+   (void)token;
+   mtx_lock(&epoch_thread_lock);
+   while (epoch_thread_records) {
+      struct epoch_record *record = epoch_thread_records;
+      epoch_thread_unlink(record);
+      record->depth = 0;
+      atomic_store(&record->local, 0);
+      atomic_store_explicit(&record->owner, NULL, memory_order_release);
+   }
+   mtx_unlock(&epoch_thread_lock);
+   for (usize i = 0; i < EPOCH_THREAD_CACHE; i++)
+      epoch_cache[i] = (struct epoch_cache_entry){0};
+}
+
+// Default release: memory from Memory.alloc
+static void epoch_release_memory(object ptr, usize size) {
+   (void)size;
+   memory_dispose(ptr);
+}
+#endif
+
+__attribute__((constructor)) static void epoch_auto_init(void) {
+   mtx_init(&epoch_thread_lock, mtx_plain);
+   tss_create(&epoch_thread_key, epoch_thread_exit);
+}
@@ -44,11 +44,13 @@ struct sc_flex_array {
    char handle[2]; // {'F', '\0'} - type identifier
    void *bucket;   // pointer to first element (raw bytes)
    void *end;      // one past allocated memory
+   allocator alloc; // allocator owning the struct and bucket
 };
 
 #if 1 // Region: Forward declarations
 // API functions
 static farray farray_new(usize, usize);
+static farray farray_new_with(usize, usize, allocator);
 static void farray_init(farray *, usize, usize);
 static void farray_dispose(farray);
 static int farray_capacity(farray, usize);
@@ -64,11 +66,19 @@ static collection farray_to_collection(farray arr, usize stride);
 
 // API function implementations
 static farray farray_new(usize capacity, usize stride) {
+   return farray_new_with(capacity, stride, NULL);
+}
+
+static farray farray_new_with(usize capacity, usize stride, allocator alloc) {
    void *bucket;
    char *end;
 
+   if (!alloc) {
+      alloc = scope_allocator();
+   }
+
    struct sc_flex_array *arr = array_alloc_struct_with_bucket(
-       sizeof(struct sc_flex_array), 'F', stride, capacity, &bucket, &end);
+       alloc, sizeof(struct sc_flex_array), 'F', stride, capacity, &bucket, &end);
 
    if (!arr) {
       return NULL;
@@ -76,6 +86,7 @@ static farray farray_new(usize capacity, usize stride) {
 
    arr->bucket = bucket;
    arr->end = end;
+   arr->alloc = alloc;
 
    farray_clear(arr, stride);
    return (farray)arr;
@@ -90,9 +101,9 @@ static void farray_init(farray *arr, usize capacity, usize stride) {
       // what to do about an farray that's already initialized?
       // for now, we just reallocate the bucket
       if ((*arr)->bucket) {
-         Memory.dispose((*arr)->bucket);
+         allocator_free((*arr)->alloc, (*arr)->bucket);
       }
-      (*arr)->bucket = scope_alloc(stride * capacity, false);
+      (*arr)->bucket = allocator_alloc((*arr)->alloc, stride * capacity, false);
       if (!(*arr)->bucket) {
          // allocation ERRed, handle error as needed
          return;
@@ -107,7 +118,7 @@ static void farray_dispose(farray arr) {
    }
 
    //  free the bucket and the farray structure itself
-   array_free_resources(arr->bucket, arr);
+   array_free_resources(arr->alloc, arr->bucket, arr);
 }
 
 static void farray_clear(farray arr, usize stride) {
@@ -156,7 +167,7 @@ static collection farray_to_collection(farray arr, usize stride) {
    }
 
    usize capacity = FArray.capacity(arr, stride);
-   collection coll = collection_new(capacity, stride);
+   collection coll = collection_new_with(capacity, stride, arr->alloc);
    if (!coll) {
       return NULL;
    }
@@ -175,6 +186,7 @@ static collection farray_to_collection(farray arr, usize stride) {
 //  public interface implementation
 const sc_farray_i FArray = {
     .new = farray_new,
+    .new_with = farray_new_with,
     .init = farray_init,
     .dispose = farray_dispose,
     .capacity = farray_capacity,
@@ -38,20 +38,26 @@
 //  declare the List struct: derived from Collection
 struct sc_list {
    collection coll; // underlying collection
+   allocator alloc; // allocator owning the list and its collection
 };
 
-//  create new list with specified initial capacity and stride
-static list list_new(usize capacity, usize stride) {
+//  create new list with specified initial capacity, stride and allocator
+static list list_new_with(usize capacity, usize stride, allocator alloc) {
+   if (!alloc) {
+      alloc = scope_allocator();
+   }
+
    //  allocate memory for the list structure
-   struct sc_list *lst = scope_alloc(sizeof(struct sc_list), false);
+   struct sc_list *lst = allocator_alloc(alloc, sizeof(struct sc_list), false);
    if (!lst) {
       return NULL; // allocation ERRed
    }
+   lst->alloc = alloc;
 
    //  create the underlying collection with the specified stride
-   lst->coll = collection_new(capacity, stride);
+   lst->coll = collection_new_with(capacity, stride, alloc);
    if (!lst->coll) {
-      Memory.dispose(lst);
+      allocator_free(alloc, lst);
       return NULL; // allocation ERRed
    }
 
@@ -60,6 +66,10 @@ static list list_new(usize capacity, usize stride) {
 
    return lst;
 }
+//  create new list with specified initial capacity and stride
+static list list_new(usize capacity, usize stride) {
+   return list_new_with(capacity, stride, NULL);
+}
 //  dispose of the list
 static void list_dispose(list lst) {
    if (!lst) {
@@ -70,7 +80,7 @@ static void list_dispose(list lst) {
    collection_dispose(lst->coll);
 
    //  free the list structure itself
-   Memory.dispose(lst);
+   allocator_free(lst->alloc, lst);
 }
 
 //  get the current capacity of the list
@@ -183,9 +193,35 @@ static void list_clear(list lst) {
    collection_clear(lst->coll);
 }
 
+// visit the pointer slots of a list for image relocation; a NULL visit only validates
+int list_image_slots(list lst, bool elements, image_slot_fn visit, void *ctx) {
+   if (!lst || !lst->coll) {
+      return ERR; // invalid list
+   }
+   collection coll = lst->coll;
+   // Only a list of pointers has element slots to relocate
+   if (elements && (coll->stride != sizeof(object) || coll->array.handle[0] == 'F')) {
+      return ERR;
+   }
+   if (!visit) {
+      return OK;
+   }
+
+   visit(&lst->coll, ctx);
+   visit(&lst->alloc, ctx);
+   visit(&coll->array.bucket, ctx);
+   visit(&coll->array.end, ctx);
+   visit(&coll->array.alloc, ctx);
+   for (usize i = 0; elements && i < coll->length; i++) {
+      visit((char *)coll->array.bucket + i * coll->stride, ctx);
+   }
+   return OK;
+}
+
 //  public interface implementation
 const sc_list_i List = {
     .new = list_new,
+    .new_with = list_new_with,
     .dispose = list_dispose,
     .capacity = list_capacity,
     .size = list_size,
@@ -26,6 +26,9 @@
  */
 #include "sigcore/memory.h"
 #include "internal/memory_internal.h"
+#include "internal/page_cache.h"
+#include "internal/trace.h"
+#include "internal/vmem.h"
 #include "sigcore/arena.h"
 #include "sigcore/parray.h"
 #include "sigcore/scope.h"
@@ -33,9 +36,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
 
 // Forward declarations for arena functions
 extern arena arena_create(usize initial_pages);
+extern arena arena_create_ex(const arena_opts *opts);
+extern arena arena_load(const char *path, object *root);
 extern void arena_dispose(arena arena);
 
 // Forward declarations for scope functions
@@ -44,40 +50,103 @@ extern void scope_set_current(void *scope);
 extern int scope_move_scopes(void *from, void *to, object obj);
 extern object scope_import(void *scope, const void *data, usize size);
 extern object scope_export(void *scope, const void *data, usize size);
+extern int scope_adopt(void *scope, object ptr, usize size, scope_release_fn release);
+extern int scope_push(void *scope);
+extern void *scope_pop(void);
+extern arena scope_thread_arena(void);
+extern frame scope_scratch(arena conflict);
+extern int scope_init(sc_scope *scope, const scope_ops *ops);
+
+static void *sysmem_default_aligned_alloc(size_t alignment, size_t size);
 
 // Memory allocation hooks - used internally for page management
 sysmem_alloc_fn sysmem_alloc = malloc;
 sysmem_free_fn sysmem_free = free;
 sysmem_calloc_fn sysmem_calloc = calloc;
 sysmem_realloc_fn sysmem_realloc = realloc;
+sysmem_aligned_alloc_fn sysmem_aligned_alloc = sysmem_default_aligned_alloc;
 
 struct sc_pool {
-   char handle[4];
+   sc_scope scope; // Scope header: "POL"
    struct sc_page *pages;
+   struct sc_page *pages_tail; // Oldest page (pages are prepended)
    struct block *free_head;
    usize total_bytes;
    usize used_bytes;
+   int numa_node; // NUMA node new pages are bound to (-1 = not bound)
+   scope_budget budget; // Limits on total_bytes (zeroed = unlimited)
+   usize charged_bytes; // Live bytes charged to scope.tag (root pool blocks carry their own tag)
 };
 
+// Longest tag name kept by Memory.Tag.define, terminator included
+#define MEMORY_TAG_NAME_SIZE 32
+
+// Size of a pool page; the data is OS-page aligned and the header lives out of line
+#define POOL_PAGE_SIZE 4096
+// Start of the pool page holding an address (valid because page data is aligned)
+#define POOL_PAGE_OF(p) ((addr)(p) & ~(addr)(POOL_PAGE_SIZE - 1))
+
 struct sc_page {
    struct sc_page *next;
-   char data[4096];
+   char *data; // POOL_PAGE_SIZE bytes from the page cache
+   int node;   // NUMA node the data is bound to (-1 = default policy)
 };
 
 static struct sc_pool root_pool;
+static mtx_t root_lock; // Serializes the shared root pool across threads
+
+// Current scope for allocations, per thread (NULL means use global Memory.alloc)
+_Thread_local void *current_scope = NULL;
 
-// Current scope for allocations (NULL means use global Memory.alloc)
-void *current_scope = NULL;
+// Allocation tag of the calling thread, its counter shard, and the tag names (see Memory.Tag)
+_Thread_local memory_tag current_tag = 0;
+_Thread_local struct memory_tag_shard *memory_tag_shard = NULL;
+static struct memory_tag_shard tag_spare_shard; // Shared fallback when a shard cannot be allocated
+static _Atomic(struct memory_tag_shard *) tag_shards = &tag_spare_shard;
+static tss_t tag_shard_key;
+static char tag_names[MEMORY_TAG_MAX][MEMORY_TAG_NAME_SIZE] = {"untagged"};
+static usize tag_count = 1;
 
 // Forward declaration for utility function
 static void memory_free_page_if_possible(struct block *b);
+static struct sc_page *pool_page_create(int node);
+static void pool_page_destroy(struct sc_page *pg);
+static int memory_set_budget(const scope_budget *budget);
+static void memory_report_tags(void);
+static memory_tag tag_define(const char *name);
+static memory_tag tag_set(memory_tag tag);
+static memory_tag tag_get(void);
+static int tag_stats(memory_tag tag, memory_tag_stats *stats);
+static void tag_shard_exit(void *shard);
+
+// Scope operations for the root pool and for pools made current
+static object memory_scope_alloc(void *scope, usize size, bool zero);
+static void memory_scope_free(void *scope, object ptr);
+static object memory_scope_realloc(void *scope, object ptr, usize old_size, usize new_size);
+static object pool_scope_alloc(void *scope, usize size, bool zero);
+static void pool_scope_free(void *scope, object ptr);
+static object pool_scope_realloc(void *scope, object ptr, usize old_size, usize new_size);
+
+static const scope_ops root_scope_ops = {
+    .alloc = memory_scope_alloc,
+    .free = memory_scope_free,
+    .realloc = memory_scope_realloc,
+};
+
+// Pools free individual blocks but do not track foreign objects
+static const scope_ops pool_scope_ops = {
+    .alloc = pool_scope_alloc,
+    .free = pool_scope_free,
+    .realloc = pool_scope_realloc,
+};
 
 // Find and allocate a block from the free list that fits the total_size
 static object memory_alloc_from_free(usize total_size, usize size, bool zero) {
    struct block *b = root_pool.free_head;
    while (b) {
       if (b->size >= total_size) {
-         if (b->size > total_size) {
+         // Only split when the remainder can hold a block header of its own
+         if (b->size >= total_size + sizeof(struct block)) {
             // Split the block
             struct block *split = (struct block *)((char *)b + total_size);
             split->size = b->size - total_size;
@@ -91,7 +160,7 @@ static object memory_alloc_from_free(usize total_size, usize size, bool zero) {
                b->next_free->prev_free = split;
             b->size = total_size;
          } else {
-            // Exact fit - remove from free list
+            // Close fit - hand out the whole block and remove it from the free list
             if (b->prev_free)
                b->prev_free->next_free = b->next_free;
             else
@@ -101,7 +170,9 @@ static object memory_alloc_from_free(usize total_size, usize size, bool zero) {
          }
          b->next_free = NULL;
          b->prev_free = NULL;
-         root_pool.used_bytes += total_size - sizeof(struct block);
+         b->tag = current_tag;
+         root_pool.used_bytes += b->size - sizeof(struct block);
+         memory_tag_charge(b->tag, b->size - sizeof(struct block));
          object ptr = (char *)b + sizeof(struct block);
          if (zero)
             memset(ptr, 0, size);
@@ -114,14 +185,19 @@ static object memory_alloc_from_free(usize total_size, usize size, bool zero) {
 
 // Grow the pool by allocating a new page
 static void memory_grow_pool(void) {
-   struct sc_page *new_pg = (struct sc_page *)sysmem_alloc(sizeof(struct sc_page));
-   memset(new_pg, 0, sizeof(*new_pg));
+   if (!scope_budget_admit(&root_pool.budget, &root_pool, root_pool.total_bytes, POOL_PAGE_SIZE))
+      return;
+
+   struct sc_page *new_pg = pool_page_create(root_pool.numa_node);
+   if (!new_pg)
+      return;
+
    new_pg->next = root_pool.pages;
    root_pool.pages = new_pg;
-   root_pool.total_bytes += 4096;
+   root_pool.total_bytes += POOL_PAGE_SIZE;
 
    struct block *new_b = (struct block *)new_pg->data;
-   new_b->size = 4096;
+   new_b->size = POOL_PAGE_SIZE;
    new_b->next_free = NULL;
    new_b->prev_free = NULL;
 
@@ -155,28 +231,27 @@ object memory_alloc(usize size, bool zero) {
    usize total_size = size + sizeof(struct block);
    total_size = (total_size + 7) & ~7; // Align to 8 bytes
 
+   mtx_lock(&root_lock);
+
    // Try to allocate from existing free blocks
    object ptr = memory_alloc_from_free(total_size, size, zero);
-   if (ptr)
-      return ptr;
-
-   // No suitable free block found, grow the pool
-   memory_grow_pool();
+   if (!ptr) {
+      // No suitable free block found, grow the pool and try again with the new page
+      memory_grow_pool();
+      ptr = memory_alloc_from_free(total_size, size, zero);
+   }
 
-   // Try again with the new page
-   return memory_alloc_from_free(total_size, size, zero);
+   mtx_unlock(&root_lock);
+   if (ptr)
+      MEMORY_TRACE(TRACE_ALLOC, ptr, size);
+   return ptr;
 }
 
 // Allocate from current scope if set, otherwise use global memory
 object scope_alloc(usize size, bool zero) {
-   if (current_scope) {
-      // Check if current scope is an arena
-      const char *handle = (const char *)current_scope;
-      if (memcmp(handle, "ARN", 4) == 0) {
-         return Arena.alloc((arena)current_scope, size, zero);
-      }
-      // TODO: Add support for frame scopes
-   }
+   sc_scope *scope = (sc_scope *)current_scope;
+   if (scope)
+      return scope->ops->alloc(scope, size, zero);
    // Fall back to global memory allocation
    return memory_alloc(size, zero);
 }
@@ -185,9 +260,12 @@ object scope_alloc(usize size, bool zero) {
 void memory_dispose(object ptr) {
    if (!ptr)
       return;
+   MEMORY_TRACE(TRACE_DISPOSE, ptr, 0);
+   mtx_lock(&root_lock);
    struct block *b = (struct block *)((char *)ptr - sizeof(struct block));
    memset(ptr, 0, b->size - sizeof(struct block));
    root_pool.used_bytes -= b->size - sizeof(struct block);
+   memory_tag_release(b->tag, b->size - sizeof(struct block));
    b->next_free = NULL;
    b->prev_free = NULL;
    struct block *curr = root_pool.free_head;
@@ -204,13 +282,14 @@ void memory_dispose(object ptr) {
       root_pool.free_head = b;
    if (curr)
       curr->prev_free = b;
-   if (curr && (char *)b + b->size == (char *)curr) {
+   // Aligned pages can be adjacent in memory; never coalesce across a page boundary
+   if (curr && (char *)b + b->size == (char *)curr && POOL_PAGE_OF(b) == POOL_PAGE_OF(curr)) {
       b->size += curr->size;
       b->next_free = curr->next_free;
       if (curr->next_free)
          curr->next_free->prev_free = b;
    }
-   if (prev && (char *)prev + prev->size == (char *)b) {
+   if (prev && (char *)prev + prev->size == (char *)b && POOL_PAGE_OF(prev) == POOL_PAGE_OF(b)) {
       prev->size += b->size;
       prev->next_free = b->next_free;
       if (b->next_free)
@@ -219,6 +298,7 @@ void memory_dispose(object ptr) {
    }
 
    memory_free_page_if_possible(b);
+   mtx_unlock(&root_lock);
 }
 
 // reallocate memory
@@ -242,11 +322,82 @@ static object memory_realloc(object ptr, usize new_size) {
    return new_ptr;
 }
 
+#if 1 // Region: Scope operations
+static object memory_scope_alloc(void *scope, usize size, bool zero) {
+   (void)scope;
+   return memory_alloc(size, zero);
+}
+
+static void memory_scope_free(void *scope, object ptr) {
+   (void)scope;
+   memory_dispose(ptr);
+}
+
+static object memory_scope_realloc(void *scope, object ptr, usize old_size, usize new_size) {
+   (void)scope;
+   (void)old_size; // Root pool blocks know their own size
+   return memory_realloc(ptr, new_size);
+}
+
+static object pool_scope_alloc(void *scope, usize size, bool zero) {
+   return pool_alloc((pool)scope, size, zero);
+}
+
+static void pool_scope_free(void *scope, object ptr) {
+   pool_free((pool)scope, ptr);
+}
+
+static object pool_scope_realloc(void *scope, object ptr, usize old_size, usize new_size) {
+   object new_ptr = pool_alloc((pool)scope, new_size, false);
+   if (new_ptr && ptr) {
+      memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+      pool_free((pool)scope, ptr);
+   }
+   return new_ptr;
+}
+#endif
+
+// get the allocator backed by the root pool
+allocator memory_get_allocator(void) {
+   return &root_pool.scope.allocator;
+}
+
+// get the allocator of the current scope (root pool when no scope is active)
+allocator scope_allocator(void) {
+   sc_scope *scope = (sc_scope *)current_scope;
+   return scope ? &scope->allocator : &root_pool.scope.allocator;
+}
+
+// allocate through an allocator (NULL uses the current scope's allocator)
+object allocator_alloc(allocator alloc, usize size, bool zero) {
+   if (!alloc)
+      alloc = scope_allocator();
+   return alloc ? alloc->alloc(alloc->ctx, size, zero) : NULL;
+}
+
+// release a block back to the allocator it came from
+void allocator_free(allocator alloc, object ptr) {
+   if (alloc && ptr)
+      alloc->free(alloc->ctx, ptr);
+}
+
+// resize a block through the allocator it came from
+object allocator_realloc(allocator alloc, object ptr, usize old_size, usize new_size) {
+   if (!alloc)
+      return NULL;
+   return alloc->realloc(alloc->ctx, ptr, old_size, new_size);
+}
+
 // create a new arena
 static arena memory_create_arena(usize initial_pages) {
    return arena_create(initial_pages);
 }
 
+// create a new arena with a page growth policy
+static arena memory_create_arena_ex(const arena_opts *opts) {
+   return arena_create_ex(opts);
+}
+
 // dispose an arena
 static void memory_dispose_arena(arena arena) {
    arena_dispose(arena);
@@ -261,30 +412,34 @@ void pool_dispose(pool p) {
    struct sc_page *pg = p->pages;
    while (pg) {
       struct sc_page *next = pg->next;
-      sysmem_free(pg);
+      pool_page_destroy(pg);
       pg = next;
    }
 
+   // Blocks still live are released with their pages
+   memory_tag_release(p->scope.tag, p->charged_bytes);
+
    // Free the pool structure
    sysmem_free(p);
 }
 
 // Grow a pool by allocating a new page
 static void pool_grow(pool p) {
-   if (!p)
+   if (!p || !scope_budget_admit(&p->budget, p, p->total_bytes, POOL_PAGE_SIZE))
       return;
 
-   struct sc_page *new_pg = (struct sc_page *)sysmem_alloc(sizeof(struct sc_page));
+   struct sc_page *new_pg = pool_page_create(p->numa_node);
    if (!new_pg)
       return;
 
-   memset(new_pg, 0, sizeof(*new_pg));
+   if (!p->pages_tail)
+      p->pages_tail = new_pg;
    new_pg->next = p->pages;
    p->pages = new_pg;
-   p->total_bytes += 4096;
+   p->total_bytes += POOL_PAGE_SIZE;
 
    struct block *new_b = (struct block *)new_pg->data;
-   new_b->size = 4096;
+   new_b->size = POOL_PAGE_SIZE;
    new_b->next_free = p->free_head;
    new_b->prev_free = NULL;
    if (p->free_head)
@@ -305,7 +460,8 @@ static struct block *pool_find_suitable_block(pool p, usize total_size) {
 }
 
 static void pool_split_block(struct block *b, usize total_size, pool p) {
-   if (b->size > total_size) {
+   // Only split when the remainder can hold a block header of its own
+   if (b->size >= total_size + sizeof(struct block)) {
       // Split the block
       struct block *split = (struct block *)((char *)b + total_size);
       split->size = b->size - total_size;
@@ -319,7 +475,7 @@ static void pool_split_block(struct block *b, usize total_size, pool p) {
          b->next_free->prev_free = split;
       b->size = total_size;
    } else {
-      // Exact fit - remove from free list
+      // Close fit - hand out the whole block and remove it from the free list
       if (b->prev_free)
          b->prev_free->next_free = b->next_free;
       else
@@ -333,6 +489,8 @@ static void pool_split_block(struct block *b, usize total_size, pool p) {
 
 static object pool_initialize_allocated_block(struct block *b, usize size, bool zero, pool p) {
    p->used_bytes += b->size - sizeof(struct block);
+   p->charged_bytes += b->size - sizeof(struct block);
+   memory_tag_charge(p->scope.tag, b->size - sizeof(struct block));
    object ptr = (char *)b + sizeof(struct block);
    // Initialize allocation tracking
    b->ptr = ptr;
@@ -341,6 +499,7 @@ static object pool_initialize_allocated_block(struct block *b, usize size, bool
    b->prev_alloc = NULL;
    if (zero)
       memset(ptr, 0, size);
+   MEMORY_TRACE(TRACE_ALLOC, ptr, size);
    return ptr;
 }
 
@@ -349,7 +508,7 @@ object pool_alloc(pool p, usize size, bool zero) {
    if (!p || size == 0)
       return NULL;
 
-   usize total_size = size + sizeof(struct block);
+   usize total_size = (size + sizeof(struct block) + 7) & ~(usize)7; // Align to 8 bytes, like the root pool
    if (total_size < size) // Overflow check
       return NULL;
 
@@ -378,6 +537,7 @@ object pool_alloc(pool p, usize size, bool zero) {
 void pool_free(pool p, object ptr) {
    if (!p || !ptr)
       return;
+   MEMORY_TRACE(TRACE_DISPOSE, ptr, 0);
 
    // Get the block header
    struct block *b = (struct block *)((char *)ptr - sizeof(struct block));
@@ -395,11 +555,75 @@ void pool_free(pool p, object ptr) {
       p->free_head->prev_free = b;
    p->free_head = b;
    p->used_bytes -= b->size - sizeof(struct block);
+   p->charged_bytes -= b->size - sizeof(struct block);
+   memory_tag_release(p->scope.tag, b->size - sizeof(struct block));
+}
+
+// Charge a pool's live blocks to a new tag
+void pool_retag(pool p, memory_tag tag) {
+   if (!p)
+      return;
+   memory_tag_move(p->scope.tag, tag, p->charged_bytes);
+   p->scope.tag = tag;
+}
+
+// Set or clear a pool's byte budget
+int pool_set_budget(pool p, const scope_budget *budget) {
+   if (!p)
+      return ERR;
+   p->budget = budget ? *budget : (scope_budget){0};
+   return OK;
+}
+
+// Set or clear the root pool's byte budget
+static int memory_set_budget(const scope_budget *budget) {
+   mtx_lock(&root_lock);
+   int result = pool_set_budget(&root_pool, budget);
+   mtx_unlock(&root_lock);
+   return result;
+}
+
+// Count a pool's resident OS pages per NUMA node
+usize pool_placement(pool p, usize *pages_per_node, usize nodes) {
+   if (!p)
+      return 0;
+   if (pages_per_node)
+      memset(pages_per_node, 0, nodes * sizeof(usize));
+
+   usize found = 0;
+   for (struct sc_page *pg = p->pages; pg; pg = pg->next)
+      found += vmem_numa_placement(pg->data, POOL_PAGE_SIZE, pages_per_node, nodes);
+   return found;
+}
+
+// Take over another pool's pages (live blocks stay valid) and free the emptied pool
+void pool_absorb(pool into, pool from) {
+   if (!into || !from || into == from)
+      return;
+
+   if (from->pages) {
+      from->pages_tail->next = into->pages;
+      into->pages = from->pages;
+      if (!into->pages_tail)
+         into->pages_tail = from->pages_tail;
+   }
+
+   // The absorbed free list is dropped rather than walked; its space comes back on dispose
+   into->total_bytes += from->total_bytes;
+   into->used_bytes += from->total_bytes;
+   memory_tag_move(from->scope.tag, into->scope.tag, from->charged_bytes);
+   into->charged_bytes += from->charged_bytes;
+   sysmem_free(from);
 }
 
 // create a new memory pool
 pool pool_create(usize initial_pages) {
-   if (initial_pages == 0)
+   return pool_create_ex(&(pool_opts){.initial_pages = initial_pages});
+}
+
+// create a new memory pool with placement options
+pool pool_create_ex(const pool_opts *opts) {
+   if (!opts || opts->initial_pages == 0)
       return NULL;
 
    // Allocate the pool structure
@@ -408,23 +632,25 @@ pool pool_create(usize initial_pages) {
       return NULL;
 
    memset(p, 0, sizeof(*p));
-   memcpy(p->handle, "POL", 4);
+   scope_init_header(&p->scope, "POL", &pool_scope_ops);
+   p->numa_node = opts->numa_bind ? vmem_numa_resolve(opts->numa_node) : -1;
 
    // Allocate initial pages
-   for (usize i = 0; i < initial_pages; i++) {
-      struct sc_page *pg = (struct sc_page *)sysmem_alloc(sizeof(struct sc_page));
+   for (usize i = 0; i < opts->initial_pages; i++) {
+      struct sc_page *pg = pool_page_create(p->numa_node);
       if (!pg) {
          // Cleanup on failure
          pool_dispose(p);
          return NULL;
       }
-      memset(pg, 0, sizeof(*pg));
+      if (!p->pages_tail)
+         p->pages_tail = pg;
       pg->next = p->pages;
       p->pages = pg;
-      p->total_bytes += 4096;
+      p->total_bytes += POOL_PAGE_SIZE;
 
       struct block *b = (struct block *)pg->data;
-      b->size = 4096;
+      b->size = POOL_PAGE_SIZE;
       b->next_free = p->free_head;
       b->prev_free = NULL;
       if (p->free_head)
@@ -438,15 +664,21 @@ pool pool_create(usize initial_pages) {
 // Automatic initialization and teardown using GCC constructor/destructor
 __attribute__((constructor)) static void memory_auto_init(void) {
    memset(&root_pool, 0, sizeof(root_pool));
-   memcpy(root_pool.handle, "POL\0", 4);
+   scope_init_header(&root_pool.scope, "POL", &root_scope_ops);
+   root_pool.numa_node = -1;
+   mtx_init(&root_lock, mtx_plain);
+   tss_create(&tag_shard_key, tag_shard_exit);
    for (usize i = 0; i < 16; i++) {
+      // The page cache is not initialized yet, so take pages straight from the system
       struct sc_page *pg = (struct sc_page *)sysmem_alloc(sizeof(struct sc_page));
-      memset(pg, 0, sizeof(*pg));
+      pg->data = (char *)sysmem_aligned_alloc(vmem_page_size(), POOL_PAGE_SIZE);
+      pg->node = -1;
+      memset(pg->data, 0, POOL_PAGE_SIZE);
       pg->next = root_pool.pages;
       root_pool.pages = pg;
-      root_pool.total_bytes += 4096;
+      root_pool.total_bytes += POOL_PAGE_SIZE;
       struct block *b = (struct block *)pg->data;
-      b->size = 4096;
+      b->size = POOL_PAGE_SIZE;
       b->next_free = root_pool.free_head;
       b->prev_free = NULL;
       if (root_pool.free_head)
@@ -457,12 +689,12 @@ __attribute__((constructor)) static void memory_auto_init(void) {
 
 // Free a page if the block is a full page and we have excess pages
 static void memory_free_page_if_possible(struct block *b) {
-   if (b->size == 4096 && root_pool.total_bytes > 16 * 4096) {
-      // Find and free the page
+   if (b->size == POOL_PAGE_SIZE && root_pool.total_bytes > 16 * POOL_PAGE_SIZE) {
+      // A whole-page block starts its page, so the page is found by its data address
       struct sc_page *pg = root_pool.pages;
       struct sc_page *prev_pg = NULL;
       while (pg) {
-         if ((char *)pg->data <= (char *)b && (char *)b < (char *)pg->data + 4096) {
+         if (pg->data == (char *)b) {
             // Remove from list
             if (prev_pg)
                prev_pg->next = pg->next;
@@ -476,8 +708,8 @@ static void memory_free_page_if_possible(struct block *b) {
             if (b->next_free)
                b->next_free->prev_free = b->prev_free;
             // Free page
-            root_pool.total_bytes -= 4096;
-            sysmem_free(pg);
+            root_pool.total_bytes -= POOL_PAGE_SIZE;
+            pool_page_destroy(pg);
             break;
          }
          prev_pg = pg;
@@ -486,6 +718,124 @@ static void memory_free_page_if_possible(struct block *b) {
    }
 }
 
+// Take a pool page: header from the system, zeroed data from the page cache
+static struct sc_page *pool_page_create(int node) {
+   struct sc_page *pg = (struct sc_page *)sysmem_alloc(sizeof(struct sc_page));
+   if (!pg)
+      return NULL;
+   pg->next = NULL;
+   pg->data = (char *)page_cache_acquire(POOL_PAGE_SIZE);
+   if (!pg->data) {
+      sysmem_free(pg);
+      return NULL;
+   }
+   // Bind before zeroing so the first touch already happens on the node (best effort)
+   pg->node = node >= 0 && vmem_numa_bind(pg->data, POOL_PAGE_SIZE, node) == OK ? node : -1;
+   memset(pg->data, 0, POOL_PAGE_SIZE);
+   MEMORY_TRACE(TRACE_PAGE_GROW, pg->data, POOL_PAGE_SIZE);
+   return pg;
+}
+
+// Return a pool page's data to the page cache and free its header
+static void pool_page_destroy(struct sc_page *pg) {
+   MEMORY_TRACE(TRACE_PAGE_RELEASE, pg->data, POOL_PAGE_SIZE);
+   if (pg->node >= 0)
+      vmem_numa_bind(pg->data, POOL_PAGE_SIZE, -1); // Cached chunks are shared
+   page_cache_release(pg->data, POOL_PAGE_SIZE);
+   sysmem_free(pg);
+}
+
+// C11 aligned_alloc wants the size to be a multiple of the alignment
+static void *sysmem_default_aligned_alloc(size_t alignment, size_t size) {
+   return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+}
+
+#if 1 // Region: Allocation tags
+// Register a tag name; ids are handed out in order and never reused
+static memory_tag tag_define(const char *name) {
+   if (!name)
+      return 0;
+
+   mtx_lock(&root_lock);
+   memory_tag tag = 0;
+   if (tag_count < MEMORY_TAG_MAX) {
+      tag = (memory_tag)tag_count++;
+      snprintf(tag_names[tag], MEMORY_TAG_NAME_SIZE, "%s", name);
+   }
+   mtx_unlock(&root_lock);
+   return tag;
+}
+
+// Make a tag current for the calling thread
+static memory_tag tag_set(memory_tag tag) {
+   memory_tag previous = current_tag;
+   current_tag = tag < MEMORY_TAG_MAX ? tag : 0;
+   return previous;
+}
+
+static memory_tag tag_get(void) {
+   return current_tag;
+}
+
+// Snapshot one tag's counters, folding every thread's shard
+static int tag_stats(memory_tag tag, memory_tag_stats *stats) {
+   if (tag >= MEMORY_TAG_MAX || !stats)
+      return ERR;
+   stats->live_bytes = 0;
+   stats->allocations = 0;
+   for (struct memory_tag_shard *shard = atomic_load(&tag_shards); shard; shard = shard->next) {
+      stats->live_bytes += atomic_load_explicit(&shard->tags[tag].live_bytes, memory_order_relaxed);
+      stats->allocations += atomic_load_explicit(&shard->tags[tag].allocations, memory_order_relaxed);
+   }
+   return OK;
+}
+
+// Claim a shard for the calling thread: one left by an exited thread, or a new one.
+// Shards keep their counts when reused, so the folded totals never lose history.
+struct memory_tag_shard *memory_tag_shard_acquire(void) {
+   struct memory_tag_shard *shard;
+   for (shard = atomic_load(&tag_shards); shard; shard = shard->next) {
+      bool idle = false;
+      if (shard != &tag_spare_shard && atomic_compare_exchange_strong(&shard->in_use, &idle, true))
+         break;
+   }
+   if (!shard) {
+      shard = sysmem_aligned_alloc(MEMORY_TAG_LINE, sizeof(struct memory_tag_shard));
+      if (!shard)
+         return &tag_spare_shard; // Shared by such threads; concurrent updates there may be lost
+      memset(shard, 0, sizeof(*shard));
+      atomic_init(&shard->in_use, true);
+      shard->next = atomic_load(&tag_shards);
+      while (!atomic_compare_exchange_weak(&tag_shards, &shard->next, shard))
+         ;
+   }
+   memory_tag_shard = shard;
+   tss_set(tag_shard_key, shard);
+   return shard;
+}
+
+// Thread-exit destructor registered through tss_create: hand the shard to the next thread
+static void tag_shard_exit(void *shard) {
+   memory_tag_shard = NULL;
+   if (shard)
+      atomic_store(&((struct memory_tag_shard *)shard)->in_use, false);
+}
+
+// Print live bytes and allocation counts of every defined tag
+static void memory_report_tags(void) {
+   mtx_lock(&root_lock);
+   usize count = tag_count;
+   mtx_unlock(&root_lock);
+
+   printf("%-24s %16s %16s\n", "tag", "live bytes", "allocations");
+   for (usize tag = 0; tag < count; tag++) {
+      memory_tag_stats stats;
+      tag_stats((memory_tag)tag, &stats);
+      printf("%-24s %16zu %16zu\n", tag_names[tag], stats.live_bytes, stats.allocations);
+   }
+}
+#endif
+
 // Backdoor functions for testing
 struct memory_page *memory_get_current_page(void) {
    // Gutted: return NULL
@@ -506,19 +856,52 @@ const sc_memory_i Memory = {
     .alloc = memory_alloc,
     .dispose = memory_dispose,
     .realloc = memory_realloc,
+    .allocator = memory_get_allocator,
+    .set_budget = memory_set_budget,
+    .report_tags = memory_report_tags,
     .Scope = {
         .get_current = scope_get_current,
         .set_current = scope_set_current,
         .move = scope_move_scopes,
         .import = scope_import,
         .export = scope_export,
+        .adopt = scope_adopt,
+        .push = scope_push,
+        .pop = scope_pop,
+        .thread_arena = scope_thread_arena,
+        .scratch = scope_scratch,
+        .allocator = scope_allocator,
+        .init = scope_init,
+    },
+    .Tag = {
+        .define = tag_define,
+        .set = tag_set,
+        .get = tag_get,
+        .set_scope = scope_set_tag,
+        .stats = tag_stats,
+    },
+    .Trace = {
+        .start = memory_trace_start,
+        .stop = memory_trace_stop,
+        .clear = memory_trace_clear,
+        .dump = memory_trace_dump,
     },
     .Pool = {
         .create = pool_create,
+        .create_ex = pool_create_ex,
+        .placement = pool_placement,
+        .set_budget = pool_set_budget,
         .dispose = pool_dispose,
     },
     .Arena = {
         .create = memory_create_arena,
+        .create_ex = memory_create_arena_ex,
+        .load = arena_load,
         .dispose = memory_dispose_arena,
     },
+    .Cache = {
+        .configure = page_cache_configure,
+        .stats = page_cache_get_stats,
+        .trim = page_cache_trim,
+    },
 };
\ No newline at end of file
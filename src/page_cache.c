@@ -0,0 +1,267 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: page_cache.c
+ * Description: SigmaCore process-wide page cache implementation
+ *
+ * Arena and pool pages are recycled through two cache levels instead of going
+ * straight back to the system allocator. Each thread keeps a small lock-free
+ * stash; overflow spills into a global cache guarded by a mutex. A chunk is
+ * only ever reused for a request of exactly the same size, so callers never
+ * see a chunk smaller (or larger) than they asked for.
+ */
+#include "internal/page_cache.h"
+#include "internal/memory_internal.h"
+#include "internal/vmem.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <threads.h>
+
+// Intrusive link stored in the first bytes of a cached chunk
+struct cached_chunk {
+   struct cached_chunk *next;
+};
+
+// One list of equally sized chunks
+struct cache_class {
+   usize size;                 // Chunk size served by this class (0 = unused)
+   struct cached_chunk *head;  // Free chunks of this size
+   usize count;                // Number of chunks in the list
+};
+
+// A cache level (global or per-thread)
+struct cache_level {
+   struct cache_class classes[PAGE_CACHE_CLASSES];
+   usize bytes; // Bytes currently held across all classes
+};
+
+static struct cache_level global_cache;
+static mtx_t global_lock;
+static tss_t thread_key;
+static _Thread_local struct cache_level thread_cache;
+static _Thread_local bool thread_registered = false;
+
+static usize global_limit = PAGE_CACHE_GLOBAL_LIMIT;
+static usize thread_limit = PAGE_CACHE_THREAD_LIMIT;
+
+static atomic_size_t stat_hits;
+static atomic_size_t stat_misses;
+static atomic_size_t stat_releases;
+static atomic_size_t stat_evictions;
+
+#if 1 // Region: Forward declarations
+// Helper/utility functions
+static struct cache_class *cache_find_class(struct cache_level *level, usize size, bool claim);
+static object cache_pop(struct cache_level *level, usize size);
+static bool cache_push(struct cache_level *level, object chunk, usize size, usize limit);
+static void cache_drain(struct cache_level *level);
+static void cache_spill_thread(struct cache_level *level);
+static void cache_thread_exit(void *level);
+static void cache_register_thread(void);
+#endif
+
+// Take a chunk from the thread cache, then the global cache, then the system
+object page_cache_acquire(usize size) {
+   if (size < sizeof(struct cached_chunk))
+      return NULL;
+
+   object chunk = cache_pop(&thread_cache, size);
+   if (!chunk) {
+      mtx_lock(&global_lock);
+      chunk = cache_pop(&global_cache, size);
+      mtx_unlock(&global_lock);
+   }
+
+   if (chunk) {
+      atomic_fetch_add_explicit(&stat_hits, 1, memory_order_relaxed);
+      return chunk;
+   }
+
+   atomic_fetch_add_explicit(&stat_misses, 1, memory_order_relaxed);
+   return sysmem_aligned_alloc(vmem_page_size(), size);
+}
+
+// Return a chunk to the thread cache, spilling to the global cache when full
+void page_cache_release(object chunk, usize size) {
+   if (!chunk)
+      return;
+
+   atomic_fetch_add_explicit(&stat_releases, 1, memory_order_relaxed);
+   cache_register_thread();
+   if (cache_push(&thread_cache, chunk, size, thread_limit))
+      return;
+
+   mtx_lock(&global_lock);
+   bool cached = cache_push(&global_cache, chunk, size, global_limit);
+   mtx_unlock(&global_lock);
+
+   if (!cached) {
+      atomic_fetch_add_explicit(&stat_evictions, 1, memory_order_relaxed);
+      sysmem_free(chunk);
+   }
+}
+
+// Set byte limits for both cache levels; surplus is released on the next trim
+void page_cache_configure(usize global_bytes, usize thread_bytes) {
+   mtx_lock(&global_lock);
+   global_limit = global_bytes;
+   thread_limit = thread_bytes;
+   mtx_unlock(&global_lock);
+}
+
+// Snapshot cache counters
+void page_cache_get_stats(page_cache_stats *stats) {
+   if (!stats)
+      return;
+
+   stats->hits = atomic_load_explicit(&stat_hits, memory_order_relaxed);
+   stats->misses = atomic_load_explicit(&stat_misses, memory_order_relaxed);
+   stats->releases = atomic_load_explicit(&stat_releases, memory_order_relaxed);
+   stats->evictions = atomic_load_explicit(&stat_evictions, memory_order_relaxed);
+   stats->thread_bytes = thread_cache.bytes;
+
+   mtx_lock(&global_lock);
+   stats->global_bytes = global_cache.bytes;
+   usize chunks = 0;
+   for (usize i = 0; i < PAGE_CACHE_CLASSES; i++)
+      chunks += global_cache.classes[i].count;
+   stats->global_chunks = chunks;
+   mtx_unlock(&global_lock);
+}
+
+// Release the calling thread's cache and the global cache to the system
+void page_cache_trim(void) {
+   cache_drain(&thread_cache);
+
+   mtx_lock(&global_lock);
+   cache_drain(&global_cache);
+   mtx_unlock(&global_lock);
+}
+
+// Automatic initialization and teardown using GCC constructor/destructor
+__attribute__((constructor)) static void page_cache_auto_init(void) {
+   mtx_init(&global_lock, mtx_plain);
+   tss_create(&thread_key, cache_thread_exit);
+}
+
+__attribute__((destructor)) static void page_cache_auto_teardown(void) {
+   page_cache_trim();
+}
+
+#if 1 // Region: Helper/utility function definitions
+// Find the class holding chunks of `size`, optionally claiming an unused slot
+static struct cache_class *cache_find_class(struct cache_level *level, usize size, bool claim) {
+   struct cache_class *unused = NULL;
+   for (usize i = 0; i < PAGE_CACHE_CLASSES; i++) {
+      struct cache_class *cls = &level->classes[i];
+      if (cls->size == size)
+         return cls;
+      if (!unused && cls->count == 0)
+         unused = cls;
+   }
+
+   if (claim && unused) {
+      unused->size = size;
+      return unused;
+   }
+   return NULL;
+}
+
+static object cache_pop(struct cache_level *level, usize size) {
+   struct cache_class *cls = cache_find_class(level, size, false);
+   if (!cls || !cls->head)
+      return NULL;
+
+   struct cached_chunk *chunk = cls->head;
+   cls->head = chunk->next;
+   cls->count--;
+   level->bytes -= size;
+   return chunk;
+}
+
+static bool cache_push(struct cache_level *level, object chunk, usize size, usize limit) {
+   if (level->bytes + size > limit)
+      return false;
+
+   struct cache_class *cls = cache_find_class(level, size, true);
+   if (!cls)
+      return false;
+
+   struct cached_chunk *link = chunk;
+   link->next = cls->head;
+   cls->head = link;
+   cls->count++;
+   level->bytes += size;
+   return true;
+}
+
+static void cache_drain(struct cache_level *level) {
+   for (usize i = 0; i < PAGE_CACHE_CLASSES; i++) {
+      struct cache_class *cls = &level->classes[i];
+      while (cls->head) {
+         struct cached_chunk *next = cls->head->next;
+         sysmem_free(cls->head);
+         cls->head = next;
+      }
+      cls->count = 0;
+      cls->size = 0;
+   }
+   level->bytes = 0;
+}
+
+// Move a thread's cached chunks into the global cache (or back to the system)
+static void cache_spill_thread(struct cache_level *level) {
+   mtx_lock(&global_lock);
+   for (usize i = 0; i < PAGE_CACHE_CLASSES; i++) {
+      struct cache_class *cls = &level->classes[i];
+      while (cls->head) {
+         struct cached_chunk *chunk = cls->head;
+         cls->head = chunk->next;
+         if (!cache_push(&global_cache, chunk, cls->size, global_limit)) {
+            atomic_fetch_add_explicit(&stat_evictions, 1, memory_order_relaxed);
+            sysmem_free(chunk);
+         }
+      }
+      cls->count = 0;
+      cls->size = 0;
+   }
+   level->bytes = 0;
+   mtx_unlock(&global_lock);
+}
+
+// Thread-exit destructor registered through tss_create
+static void cache_thread_exit(void *level) {
+   if (level)
+      cache_spill_thread((struct cache_level *)level);
+   // Pages released by later thread-exit destructors re-register the cache
+   thread_registered = false;
+}
+
+// Make sure the thread-exit destructor runs for this thread's cache
+static void cache_register_thread(void) {
+   if (thread_registered)
+      return;
+   tss_set(thread_key, &thread_cache);
+   thread_registered = true;
+}
+#endif
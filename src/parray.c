@@ -43,11 +43,13 @@ struct sc_pointer_array {
    char handle[2]; // {'P', '\0'} - type identifier
    addr *bucket;   // pointer to first element (array of addr)
    addr end;       // one past allocated memory (as raw addr)
+   allocator alloc; // allocator owning the struct and bucket
 };
 
 #if 1 // Region: Forward declarations
 // API functions
 static parray array_new(usize);
+static parray array_new_with(usize, allocator);
 static void array_init(parray *, usize);
 static void array_dispose(parray);
 static int array_capacity(parray);
@@ -63,11 +65,19 @@ static collection parray_to_collection(parray arr);
 
 // API function implementations
 static parray array_new(usize capacity) {
+   return array_new_with(capacity, NULL);
+}
+
+static parray array_new_with(usize capacity, allocator alloc) {
    void *bucket;
    char *end;
 
+   if (!alloc) {
+      alloc = scope_allocator();
+   }
+
    struct sc_pointer_array *arr = array_alloc_struct_with_bucket(
-       sizeof(struct sc_pointer_array), 'P', sizeof(addr), capacity, &bucket, &end);
+       alloc, sizeof(struct sc_pointer_array), 'P', sizeof(addr), capacity, &bucket, &end);
 
    if (!arr) {
       return NULL;
@@ -75,6 +85,7 @@ static parray array_new(usize capacity) {
 
    arr->bucket = (addr *)bucket;
    arr->end = (addr)end;
+   arr->alloc = alloc;
 
    PArray.clear((parray)arr);
    return (parray)arr;
@@ -89,9 +100,9 @@ static void array_init(parray *arr, usize capacity) {
       // what to do about an array that's already initialized?
       // for now, we just reallocate the bucket
       if ((*arr)->bucket) {
-         Memory.dispose((*arr)->bucket);
+         allocator_free((*arr)->alloc, (*arr)->bucket);
       }
-      (*arr)->bucket = scope_alloc(sizeof(addr) * capacity, false);
+      (*arr)->bucket = allocator_alloc((*arr)->alloc, sizeof(addr) * capacity, false);
       if (!(*arr)->bucket) {
          // allocation ERRed, handle error as needed
          return;
@@ -106,7 +117,7 @@ static void array_dispose(parray arr) {
    }
 
    //  free the bucket and the array structure itself
-   array_free_resources(arr->bucket, arr);
+   array_free_resources(arr->alloc, arr->bucket, arr);
 }
 
 static int array_capacity(parray arr) {
@@ -174,7 +185,7 @@ static collection parray_to_collection(parray arr) {
    }
 
    usize capacity = PArray.capacity(arr);
-   collection coll = collection_new(capacity, sizeof(addr));
+   collection coll = collection_new_with(capacity, sizeof(addr), arr->alloc);
    if (!coll) {
       return NULL;
    }
@@ -189,6 +200,7 @@ static collection parray_to_collection(parray arr) {
 //  public interface implementation
 const sc_parray_i PArray = {
     .new = array_new,
+    .new_with = array_new_with,
     .init = array_init,
     .dispose = array_dispose,
     .capacity = array_capacity,
@@ -33,47 +33,56 @@
  * by SigmaCore's scoped system.
  */
 #include "sigcore/scope.h"
-#include "internal/arena_internal.h"
 #include "internal/memory_internal.h"
 #include "sigcore/arena.h"
 #include "sigcore/memory.h"
 #include <string.h>
+#include <threads.h>
 
-// Extern declaration for current scope (defined in memory.c)
-extern void *current_scope;
+// Maximum number of scopes saved by Memory.Scope.push on one thread
+#define SCOPE_STACK_DEPTH 16
 
-// Forward declarations for internal structs
-struct sc_frame;
+// Extern declaration for current scope (defined in memory.c, one per thread)
+extern _Thread_local void *current_scope;
+
+// Arenas owned by a thread, disposed when it exits
+struct scope_thread_arenas {
+   arena default_arena; // Memory.Scope.thread_arena
+   arena scratch[2];    // Rotating pair handed out by Memory.Scope.scratch
+};
+
+// Per-thread scope stack and arenas
+static _Thread_local void *scope_stack[SCOPE_STACK_DEPTH];
+static _Thread_local usize scope_depth = 0;
+static _Thread_local struct scope_thread_arenas thread_arenas;
+static tss_t thread_arenas_key;
 
 // Forward declarations for helper functions
-static bool is_arena_scope(void *scope);
-static bool is_frame_scope(void *scope);
-static int scope_add_object(void *scope, object obj);
-static int scope_remove_object(void *scope, object obj);
+static bool scope_validate(void *scope);
+static arena scope_thread_arena_create(arena *slot);
+static void scope_thread_exit(void *arenas);
 
 // API function definitions
 // Transfer ownership between scopes
 int scope_move_scopes(void *from, void *to, object obj) {
-   if (!from || !to || !obj)
+   if (!scope_validate(from) || !scope_validate(to) || !obj)
       return ERR;
 
-   // Validate scope types (only arenas and frames supported)
-   bool from_valid = is_arena_scope(from) || is_frame_scope(from);
-   bool to_valid = is_arena_scope(to) || is_frame_scope(to);
-
-   if (!from_valid || !to_valid) {
-      return ERR;
-   }
+   sc_scope *source = (sc_scope *)from;
+   sc_scope *target = (sc_scope *)to;
+   if (!source->ops->untrack || !target->ops->track)
+      return ERR; // Scope cannot own foreign objects
 
    // Remove from source scope
-   if (scope_remove_object(from, obj) != OK) {
+   if (source->ops->untrack(source, obj) != OK) {
       return ERR; // Object not owned by source
    }
 
    // Add to destination scope
-   if (scope_add_object(to, obj) != OK) {
+   if (target->ops->track(target, obj) != OK) {
       // Rollback - add back to source
-      scope_add_object(from, obj);
+      if (source->ops->track)
+         source->ops->track(source, obj);
       return ERR;
    }
 
@@ -82,30 +91,27 @@ int scope_move_scopes(void *from, void *to, object obj) {
 
 // Import external data into a scope
 object scope_import(void *scope, const void *data, usize size) {
-   if (!scope || !data || size == 0)
+   if (!scope_validate(scope) || !data || size == 0)
       return NULL;
 
-   if (is_arena_scope(scope)) {
-      // Import into arena - allocate and copy
-      object ptr = Arena.alloc((arena)scope, size, false);
-      if (!ptr)
-         return NULL;
-      memcpy(ptr, data, size);
-      return ptr;
-   } else if (is_frame_scope(scope)) {
-      // Import into frame's arena - allocate and copy
-      arena frame_arena = frame_get_arena((frame)scope);
-      if (!frame_arena)
-         return NULL;
-      object ptr = Arena.alloc(frame_arena, size, false);
-      if (!ptr)
-         return NULL;
-      memcpy(ptr, data, size);
-      return ptr;
-   }
+   // Allocate in the scope and copy
+   sc_scope *target = (sc_scope *)scope;
+   object ptr = target->ops->alloc(target, size, false);
+   if (!ptr)
+      return NULL;
+   memcpy(ptr, data, size);
+   return ptr;
+}
 
-   // Unsupported scope type
-   return NULL;
+// Hand an external buffer to a scope without copying it
+int scope_adopt(void *scope, object ptr, usize size, scope_release_fn release) {
+   if (!scope_validate(scope) || !ptr || !release)
+      return ERR;
+
+   sc_scope *target = (sc_scope *)scope;
+   if (!target->ops->adopt)
+      return ERR; // Scope cannot release foreign buffers
+   return target->ops->adopt(target, ptr, size, release);
 }
 
 // Export data from a scope to external memory
@@ -133,64 +139,137 @@ void scope_set_current(void *scope) {
    current_scope = scope;
 }
 
-// Add object to scope tracking
-static int scope_add_object(void *scope, object obj) {
-   if (!scope || !obj)
+// Set up a user-defined scope
+int scope_init(sc_scope *scope, const scope_ops *ops) {
+   if (!scope || !ops || !ops->alloc)
       return ERR;
 
-   if (is_arena_scope(scope)) {
-      Arena.track((arena)scope, obj);
-      return OK;
-   } else if (is_frame_scope(scope)) {
-      // Frames use arena tracking
-      arena frame_arena = frame_get_arena((frame)scope);
-      if (frame_arena) {
-         Arena.track(frame_arena, obj);
-         return OK;
-      }
+   scope_init_header(scope, SCOPE_HANDLE_USER, ops);
+   return OK;
+}
+
+// Set up a scope header; the allocator binds the scope's ops to the scope itself
+void scope_init_header(sc_scope *scope, const char *handle, const scope_ops *ops) {
+   memcpy(scope->handle, handle, sizeof(scope->handle));
+   scope->tag = current_tag;
+   scope->ops = ops;
+   scope->allocator = (sc_allocator){
+       .alloc = ops->alloc,
+       .free = ops->free,
+       .realloc = ops->realloc,
+       .ctx = scope,
+   };
+}
+
+// Charge a scope to a tag; arenas and pools move the bytes they already hold
+int scope_set_tag(void *scope, memory_tag tag) {
+   if (!scope_validate(scope) || tag >= MEMORY_TAG_MAX)
       return ERR;
-   }
 
-   return ERR;
+   sc_scope *header = (sc_scope *)scope;
+   if (memcmp(header->handle, "ARN", 4) == 0)
+      arena_retag((arena)scope, tag);
+   else if (memcmp(header->handle, "POL", 4) == 0)
+      pool_retag((pool)scope, tag);
+   else if (memcmp(header->handle, "FRM", 4) == 0)
+      return ERR; // Frames are charged through their arena
+   else
+      header->tag = tag;
+   return OK;
 }
 
-// Remove object from scope tracking
-static int scope_remove_object(void *scope, object obj) {
-   if (!scope || !obj)
+// Check growth against a budget: false past the hard limit, on_soft when crossing the soft one
+bool scope_budget_admit(const scope_budget *budget, void *scope, usize reserved, usize growth) {
+   usize after = reserved + growth;
+   if (budget->hard && (after < reserved || after > budget->hard))
+      return false;
+   if (budget->soft && budget->on_soft && reserved <= budget->soft && after > budget->soft)
+      budget->on_soft(scope, after, budget->soft);
+   return true;
+}
+
+// Make a scope current, saving the previous one on the thread's stack
+int scope_push(void *scope) {
+   if (scope_depth >= SCOPE_STACK_DEPTH)
       return ERR;
 
-   if (is_arena_scope(scope)) {
-      if (Arena.is_tracking((arena)scope, obj)) {
-         Arena.untrack((arena)scope, obj);
-         return OK;
-      }
-      return ERR; // Not owned by this scope
-   } else if (is_frame_scope(scope)) {
-      // Frames use arena tracking
-      arena frame_arena = frame_get_arena((frame)scope);
-      if (frame_arena && Arena.is_tracking(frame_arena, obj)) {
-         Arena.untrack(frame_arena, obj);
-         return OK;
-      }
-      return ERR; // Not owned by this scope
-   }
+   scope_stack[scope_depth++] = current_scope;
+   current_scope = scope;
+   return OK;
+}
+
+// Restore the scope saved by the matching push
+void *scope_pop(void) {
+   if (scope_depth == 0)
+      return NULL;
+
+   void *popped = current_scope;
+   current_scope = scope_stack[--scope_depth];
+   return popped;
+}
+
+// Get the calling thread's default arena, creating it on first use
+arena scope_thread_arena(void) {
+   return scope_thread_arena_create(&thread_arenas.default_arena);
+}
+
+// Begin a frame on a thread-local scratch arena that is not `conflict`
+frame scope_scratch(arena conflict) {
+   // Of the two scratch arenas at most one can be the caller's output arena
+   arena *slot = &thread_arenas.scratch[0];
+   if (conflict && conflict == thread_arenas.scratch[0])
+      slot = &thread_arenas.scratch[1];
+
+   arena scratch = scope_thread_arena_create(slot);
+   return scratch ? Arena.begin_frame(scratch) : (frame){0};
+}
 
-   return ERR;
+// Automatic initialization and teardown using GCC constructor/destructor
+__attribute__((constructor)) static void scope_auto_init(void) {
+   tss_create(&thread_arenas_key, scope_thread_exit);
+}
+
+__attribute__((destructor)) static void scope_auto_teardown(void) {
+   // The main thread never runs its tss destructor
+   scope_thread_exit(&thread_arenas);
 }
 
 // Helper/utility function definitions
-// Check if scope is Arena
-static bool is_arena_scope(void *scope) {
-   if (!scope)
-      return false;
-   const char *handle = (const char *)scope;
-   return memcmp(handle, "ARN", 4) == 0;
+// Lazily create one of the calling thread's arenas
+static arena scope_thread_arena_create(arena *slot) {
+   if (!*slot) {
+      *slot = arena_create(1);
+      if (*slot)
+         tss_set(thread_arenas_key, &thread_arenas);
+   }
+   return *slot;
 }
 
-// Check if scope is Frame
-static bool is_frame_scope(void *scope) {
+// Dispose the exiting thread's arenas
+static void scope_thread_exit(void *arenas) {
+   struct scope_thread_arenas *owned = (struct scope_thread_arenas *)arenas;
+   if (!owned)
+      return;
+
+   arena *slots[] = {&owned->default_arena, &owned->scratch[0], &owned->scratch[1]};
+   for (usize i = 0; i < sizeof(slots) / sizeof(slots[0]); i++) {
+      if (!*slots[i])
+         continue;
+      if (current_scope == *slots[i])
+         current_scope = NULL;
+      arena_dispose(*slots[i]);
+      *slots[i] = NULL;
+   }
+}
+
+// Check that a pointer carries a known scope handle before reading its ops
+static bool scope_validate(void *scope) {
    if (!scope)
       return false;
-   const char *handle = (const char *)scope;
-   return memcmp(handle, "FRM", 4) == 0;
-}
\ No newline at end of file
+   static const char *handles[] = {"ARN", "FRM", "POL", SCOPE_HANDLE_USER};
+   for (usize i = 0; i < sizeof(handles) / sizeof(handles[0]); i++) {
+      if (memcmp(scope, handles[i], 4) == 0)
+         return ((sc_scope *)scope)->ops != NULL;
+   }
+   return false;
+}
@@ -0,0 +1,132 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: sharedbuf.c
+ * Description: SigmaCore reference-counted shared buffers
+ *
+ * The buffer header comes from the root pool, which is safe to free from
+ * any thread; the shared bytes stay where they were allocated and go back to
+ * their own allocator when the count drops to zero.
+ */
+#include "sigcore/sharedbuf.h"
+#include "internal/array_base.h"
+#include "internal/memory_internal.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// Shared buffer header
+struct sc_shared_buffer {
+   _Atomic usize refs; // Holders of the buffer
+   object data;        // Shared bytes (owned)
+   usize size;         // Bytes visible through the buffer
+   allocator alloc;    // Allocator data is returned to
+};
+
+#if 1 // Region: Forward declarations
+static shared_buffer sharedbuf_wrap(object data, usize size, allocator alloc);
+static shared_buffer sharedbuf_from_farray(farray arr);
+static shared_buffer sharedbuf_from_string(string str, allocator alloc);
+static shared_buffer sharedbuf_retain(shared_buffer buf);
+static void sharedbuf_release(shared_buffer buf);
+static const void *sharedbuf_data(shared_buffer buf);
+static usize sharedbuf_size(shared_buffer buf);
+static usize sharedbuf_refs(shared_buffer buf);
+#endif
+
+const sc_shared_buffer_i SharedBuffer = {
+    .wrap = sharedbuf_wrap,
+    .from_farray = sharedbuf_from_farray,
+    .from_string = sharedbuf_from_string,
+    .retain = sharedbuf_retain,
+    .release = sharedbuf_release,
+    .data = sharedbuf_data,
+    .size = sharedbuf_size,
+    .refs = sharedbuf_refs,
+};
+
+#if 1 // Region: API functions
+static shared_buffer sharedbuf_wrap(object data, usize size, allocator alloc) {
+   if (!data)
+      return NULL;
+
+   shared_buffer buf = memory_alloc(sizeof(struct sc_shared_buffer), false);
+   if (!buf)
+      return NULL;
+   atomic_init(&buf->refs, 1);
+   buf->data = data;
+   buf->size = size;
+   buf->alloc = alloc ? alloc : memory_get_allocator();
+   return buf;
+}
+
+static shared_buffer sharedbuf_from_farray(farray arr) {
+   sc_array_base *base = (sc_array_base *)arr;
+   if (!base || !base->bucket)
+      return NULL;
+
+   shared_buffer buf = sharedbuf_wrap(base->bucket, (usize)((char *)base->end - (char *)base->bucket), base->alloc);
+   if (!buf)
+      return NULL;
+
+   // The bucket now belongs to the buffer; only the array header goes
+   allocator_free(base->alloc, base);
+   return buf;
+}
+
+// Strings come from the scope current when they were made, not necessarily the root pool
+static shared_buffer sharedbuf_from_string(string str, allocator alloc) {
+   if (!str)
+      return NULL;
+   return sharedbuf_wrap(str, strlen(str) + 1, alloc ? alloc : scope_allocator());
+}
+
+static shared_buffer sharedbuf_retain(shared_buffer buf) {
+   if (buf)
+      atomic_fetch_add_explicit(&buf->refs, 1, memory_order_relaxed);
+   return buf;
+}
+
+static void sharedbuf_release(shared_buffer buf) {
+   if (!buf)
+      return;
+   // Holders' reads happen before the free that follows the last release
+   if (atomic_fetch_sub_explicit(&buf->refs, 1, memory_order_release) != 1)
+      return;
+   atomic_thread_fence(memory_order_acquire);
+
+   allocator_free(buf->alloc, buf->data);
+   memory_dispose(buf);
+}
+
+static const void *sharedbuf_data(shared_buffer buf) {
+   return buf ? buf->data : NULL;
+}
+
+static usize sharedbuf_size(shared_buffer buf) {
+   return buf ? buf->size : 0;
+}
+
+static usize sharedbuf_refs(shared_buffer buf) {
+   return buf ? atomic_load_explicit(&buf->refs, memory_order_relaxed) : 0;
+}
+#endif
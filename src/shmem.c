@@ -0,0 +1,540 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: shmem.c
+ * Description: SigmaCore cross-process shared memory regions and offset collections
+ *
+ * A region starts with a small header (magic, capacity, bump offset, root
+ * offset) followed by bump-allocated data. The bump offset is advanced with
+ * a compare-and-swap on the shared mapping, so processes can allocate from
+ * the same region concurrently. Fresh memfd/shm pages read as zero and
+ * region memory is never reused, so allocations need no clearing.
+ *
+ * Collection headers live in the region too and hold only offsets; every
+ * access resolves them against the calling process's own mapping.
+ */
+#include "sigcore/shmem.h"
+#include "internal/memory_internal.h"
+#include "internal/vmem.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+// Alignment of every region allocation
+#define SHM_ALIGN _Alignof(max_align_t)
+// Identifies a mapping as a region
+#define SHM_MAGIC "SCSHMEM1"
+
+// Region header, stored at offset 0 of the shared object
+struct shm_region_header {
+   char magic[8];            // SHM_MAGIC
+   uint64_t capacity;        // Bytes of the region
+   _Atomic uint64_t bump;    // Offset of the first free byte
+   _Atomic uint64_t root;    // Offset published with ShmRegion.set_root
+};
+
+// Process-local view of a region
+struct sc_shm_region {
+   char *base; // This process's mapping
+   usize size; // Bytes mapped
+   int fd;     // Shared memory object
+};
+
+// Collection headers (inside the region)
+struct shm_farray_header {
+   uint64_t capacity;
+   uint64_t stride;
+   shm_offset data;
+};
+struct shm_list_header {
+   uint64_t count;
+   uint64_t capacity;
+   shm_offset items; // capacity shm_offset entries
+};
+struct shm_slotarray_header {
+   uint64_t capacity;
+   shm_offset slots; // capacity shm_offset entries (0 = empty)
+};
+
+#if 1 // Region: Forward declarations
+// API functions
+static shm_region shm_create(const char *name, usize capacity);
+static shm_region shm_open_name(const char *name);
+static shm_region shm_open_fd(int fd);
+static void shm_close(shm_region region);
+static int shm_unlink_name(const char *name);
+static int shm_get_fd(shm_region region);
+static shm_offset shm_alloc(shm_region region, usize size);
+static object shm_at(shm_region region, shm_offset offset);
+static shm_offset shm_offset_of(shm_region region, object ptr);
+static void shm_set_root(shm_region region, shm_offset offset);
+static shm_offset shm_root(shm_region region);
+static usize shm_used(shm_region region);
+
+static shm_farray shm_farray_new(shm_region region, usize capacity, usize stride);
+static usize shm_farray_capacity(shm_region region, shm_farray arr);
+static int shm_farray_set(shm_region region, shm_farray arr, usize index, const void *value);
+static int shm_farray_get(shm_region region, shm_farray arr, usize index, object out);
+static object shm_farray_at(shm_region region, shm_farray arr, usize index);
+
+static shm_list shm_list_new(shm_region region, usize capacity);
+static usize shm_list_size(shm_region region, shm_list lst);
+static usize shm_list_capacity(shm_region region, shm_list lst);
+static int shm_list_append(shm_region region, shm_list lst, shm_offset value);
+static int shm_list_get(shm_region region, shm_list lst, usize index, shm_offset *out);
+static int shm_list_set(shm_region region, shm_list lst, usize index, shm_offset value);
+static int shm_list_remove(shm_region region, shm_list lst, usize index);
+static void shm_list_clear(shm_region region, shm_list lst);
+
+static shm_slotarray shm_slotarray_new(shm_region region, usize capacity);
+static int shm_slotarray_add(shm_region region, shm_slotarray slots, shm_offset value);
+static int shm_slotarray_get_at(shm_region region, shm_slotarray slots, usize index, shm_offset *out);
+static int shm_slotarray_remove_at(shm_region region, shm_slotarray slots, usize index);
+static bool shm_slotarray_is_empty_slot(shm_region region, shm_slotarray slots, usize index);
+static usize shm_slotarray_capacity(shm_region region, shm_slotarray slots);
+static void shm_slotarray_clear(shm_region region, shm_slotarray slots);
+
+// Helper functions
+static shm_region shm_map(int fd);
+static struct shm_region_header *shm_header(shm_region region);
+static object shm_resolve(shm_region region, shm_offset offset, usize size);
+static shm_offset *shm_list_items(shm_region region, struct shm_list_header *header);
+static shm_offset *shm_slotarray_slots(shm_region region, struct shm_slotarray_header *header);
+#endif
+
+#if 1 // Region: Region API
+// Create and map a region, writing its header
+static shm_region shm_create(const char *name, usize capacity) {
+   if (capacity <= sizeof(struct shm_region_header))
+      return NULL;
+
+   int fd = vmem_shared_create(name, capacity);
+   if (fd < 0)
+      return NULL;
+
+   shm_region region = sysmem_alloc(sizeof(struct sc_shm_region));
+   char *base = vmem_map_fd(fd, capacity, false);
+   if (!region || !base) {
+      if (base)
+         vmem_release(base, capacity);
+      sysmem_free(region);
+      vmem_close_fd(fd);
+      if (name)
+         vmem_shared_unlink(name);
+      return NULL;
+   }
+
+   region->base = base;
+   region->size = capacity;
+   region->fd = fd;
+
+   struct shm_region_header *header = shm_header(region);
+   header->capacity = capacity;
+   atomic_store(&header->bump, (sizeof(struct shm_region_header) + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN);
+   atomic_store(&header->root, 0);
+   // The magic goes last: a process opening the name early sees no region yet
+   atomic_thread_fence(memory_order_release);
+   memcpy(header->magic, SHM_MAGIC, sizeof(header->magic));
+   return region;
+}
+
+static shm_region shm_open_name(const char *name) {
+   int fd = vmem_shared_open(name);
+   if (fd < 0)
+      return NULL;
+   shm_region region = shm_map(fd);
+   if (!region)
+      vmem_close_fd(fd);
+   return region;
+}
+
+static shm_region shm_open_fd(int fd) {
+   int own = vmem_dup_fd(fd);
+   if (own < 0)
+      return NULL;
+   shm_region region = shm_map(own);
+   if (!region)
+      vmem_close_fd(own);
+   return region;
+}
+
+static void shm_close(shm_region region) {
+   if (!region)
+      return;
+   vmem_release(region->base, region->size);
+   vmem_close_fd(region->fd);
+   sysmem_free(region);
+}
+
+static int shm_unlink_name(const char *name) {
+   return vmem_shared_unlink(name);
+}
+
+static int shm_get_fd(shm_region region) {
+   return region ? region->fd : -1;
+}
+
+// Bump-allocate with a CAS so concurrent processes never hand out the same bytes
+static shm_offset shm_alloc(shm_region region, usize size) {
+   if (!region || size == 0)
+      return 0;
+
+   struct shm_region_header *header = shm_header(region);
+   uint64_t old = atomic_load_explicit(&header->bump, memory_order_relaxed);
+   uint64_t start, end;
+   do {
+      start = (old + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN;
+      end = start + size;
+      if (end < start || end > header->capacity)
+         return 0;
+   } while (!atomic_compare_exchange_weak_explicit(&header->bump, &old, end, memory_order_acq_rel,
+                                                   memory_order_relaxed));
+   return start;
+}
+
+static object shm_at(shm_region region, shm_offset offset) {
+   return shm_resolve(region, offset, 0);
+}
+
+static shm_offset shm_offset_of(shm_region region, object ptr) {
+   if (!region || (char *)ptr <= region->base || (char *)ptr >= region->base + region->size)
+      return 0;
+   return (shm_offset)((char *)ptr - region->base);
+}
+
+static void shm_set_root(shm_region region, shm_offset offset) {
+   if (region)
+      atomic_store_explicit(&shm_header(region)->root, offset, memory_order_release);
+}
+
+static shm_offset shm_root(shm_region region) {
+   return region ? atomic_load_explicit(&shm_header(region)->root, memory_order_acquire) : 0;
+}
+
+static usize shm_used(shm_region region) {
+   return region ? atomic_load_explicit(&shm_header(region)->bump, memory_order_relaxed) : 0;
+}
+#endif
+
+#if 1 // Region: ShmFArray
+static shm_farray shm_farray_new(shm_region region, usize capacity, usize stride) {
+   if (capacity == 0 || stride == 0 || capacity > SIZE_MAX / stride)
+      return 0;
+
+   shm_farray arr = shm_alloc(region, sizeof(struct shm_farray_header));
+   shm_offset data = arr ? shm_alloc(region, capacity * stride) : 0;
+   if (!data)
+      return 0;
+
+   struct shm_farray_header *header = shm_at(region, arr);
+   header->capacity = capacity;
+   header->stride = stride;
+   header->data = data;
+   return arr;
+}
+
+static usize shm_farray_capacity(shm_region region, shm_farray arr) {
+   struct shm_farray_header *header = shm_resolve(region, arr, sizeof(*header));
+   return header ? header->capacity : 0;
+}
+
+static int shm_farray_set(shm_region region, shm_farray arr, usize index, const void *value) {
+   object slot = shm_farray_at(region, arr, index);
+   if (!slot || !value)
+      return ERR;
+   memcpy(slot, value, ((struct shm_farray_header *)shm_at(region, arr))->stride);
+   return OK;
+}
+
+static int shm_farray_get(shm_region region, shm_farray arr, usize index, object out) {
+   object slot = shm_farray_at(region, arr, index);
+   if (!slot || !out)
+      return ERR;
+   memcpy(out, slot, ((struct shm_farray_header *)shm_at(region, arr))->stride);
+   return OK;
+}
+
+static object shm_farray_at(shm_region region, shm_farray arr, usize index) {
+   struct shm_farray_header *header = shm_resolve(region, arr, sizeof(*header));
+   if (!header || index >= header->capacity)
+      return NULL;
+   char *data = shm_resolve(region, header->data, header->capacity * header->stride);
+   return data ? data + index * header->stride : NULL;
+}
+#endif
+
+#if 1 // Region: ShmList
+static shm_list shm_list_new(shm_region region, usize capacity) {
+   if (capacity == 0 || capacity > SIZE_MAX / sizeof(shm_offset))
+      return 0;
+
+   shm_list lst = shm_alloc(region, sizeof(struct shm_list_header));
+   shm_offset items = lst ? shm_alloc(region, capacity * sizeof(shm_offset)) : 0;
+   if (!items)
+      return 0;
+
+   struct shm_list_header *header = shm_at(region, lst);
+   header->count = 0;
+   header->capacity = capacity;
+   header->items = items;
+   return lst;
+}
+
+static usize shm_list_size(shm_region region, shm_list lst) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   return header ? header->count : 0;
+}
+
+static usize shm_list_capacity(shm_region region, shm_list lst) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   return header ? header->capacity : 0;
+}
+
+// Items of a list in this process's mapping
+static shm_offset *shm_list_items(shm_region region, struct shm_list_header *header) {
+   return shm_resolve(region, header->items, header->capacity * sizeof(shm_offset));
+}
+
+static int shm_list_append(shm_region region, shm_list lst, shm_offset value) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   if (!header)
+      return ERR;
+
+   if (header->count == header->capacity) {
+      // Move to storage twice the size; the old items stay behind in the region
+      usize capacity = header->capacity * 2;
+      shm_offset items = shm_alloc(region, capacity * sizeof(shm_offset));
+      if (!items)
+         return ERR;
+      memcpy(shm_at(region, items), shm_list_items(region, header), header->count * sizeof(shm_offset));
+      header->items = items;
+      header->capacity = capacity;
+   }
+
+   shm_list_items(region, header)[header->count] = value;
+   header->count++;
+   return OK;
+}
+
+static int shm_list_get(shm_region region, shm_list lst, usize index, shm_offset *out) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   if (!header || !out || index >= header->count)
+      return ERR;
+   *out = shm_list_items(region, header)[index];
+   return OK;
+}
+
+static int shm_list_set(shm_region region, shm_list lst, usize index, shm_offset value) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   if (!header || index >= header->count)
+      return ERR;
+   shm_list_items(region, header)[index] = value;
+   return OK;
+}
+
+static int shm_list_remove(shm_region region, shm_list lst, usize index) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   if (!header || index >= header->count)
+      return ERR;
+   shm_offset *items = shm_list_items(region, header);
+   memmove(&items[index], &items[index + 1], (header->count - index - 1) * sizeof(shm_offset));
+   header->count--;
+   return OK;
+}
+
+static void shm_list_clear(shm_region region, shm_list lst) {
+   struct shm_list_header *header = shm_resolve(region, lst, sizeof(*header));
+   if (header)
+      header->count = 0;
+}
+#endif
+
+#if 1 // Region: ShmSlotArray
+static shm_slotarray shm_slotarray_new(shm_region region, usize capacity) {
+   if (capacity == 0 || capacity > SIZE_MAX / sizeof(shm_offset))
+      return 0;
+
+   shm_slotarray slots = shm_alloc(region, sizeof(struct shm_slotarray_header));
+   shm_offset storage = slots ? shm_alloc(region, capacity * sizeof(shm_offset)) : 0;
+   if (!storage)
+      return 0;
+
+   struct shm_slotarray_header *header = shm_at(region, slots);
+   header->capacity = capacity;
+   header->slots = storage;
+   return slots;
+}
+
+// Slots of a slot array in this process's mapping
+static shm_offset *shm_slotarray_slots(shm_region region, struct shm_slotarray_header *header) {
+   return shm_resolve(region, header->slots, header->capacity * sizeof(shm_offset));
+}
+
+static int shm_slotarray_add(shm_region region, shm_slotarray slots, shm_offset value) {
+   struct shm_slotarray_header *header = shm_resolve(region, slots, sizeof(*header));
+   if (!header || value == 0)
+      return ERR;
+
+   shm_offset *entries = shm_slotarray_slots(region, header);
+   for (usize i = 0; i < header->capacity; i++) {
+      if (entries[i] == 0) {
+         entries[i] = value;
+         return (int)i;
+      }
+   }
+
+   // All slots taken: double, keeping indices (new slots are zero, i.e. empty)
+   usize index = header->capacity;
+   usize capacity = header->capacity * 2;
+   shm_offset storage = shm_alloc(region, capacity * sizeof(shm_offset));
+   if (!storage)
+      return ERR;
+   memcpy(shm_at(region, storage), entries, header->capacity * sizeof(shm_offset));
+   header->slots = storage;
+   header->capacity = capacity;
+   shm_slotarray_slots(region, header)[index] = value;
+   return (int)index;
+}
+
+static int shm_slotarray_get_at(shm_region region, shm_slotarray slots, usize index, shm_offset *out) {
+   struct shm_slotarray_header *header = shm_resolve(region, slots, sizeof(*header));
+   if (!header || !out || index >= header->capacity)
+      return ERR;
+   shm_offset value = shm_slotarray_slots(region, header)[index];
+   if (value == 0)
+      return ERR;
+   *out = value;
+   return OK;
+}
+
+static int shm_slotarray_remove_at(shm_region region, shm_slotarray slots, usize index) {
+   struct shm_slotarray_header *header = shm_resolve(region, slots, sizeof(*header));
+   if (!header || index >= header->capacity)
+      return ERR;
+   shm_slotarray_slots(region, header)[index] = 0;
+   return OK;
+}
+
+static bool shm_slotarray_is_empty_slot(shm_region region, shm_slotarray slots, usize index) {
+   struct shm_slotarray_header *header = shm_resolve(region, slots, sizeof(*header));
+   if (!header || index >= header->capacity)
+      return true;
+   return shm_slotarray_slots(region, header)[index] == 0;
+}
+
+static usize shm_slotarray_capacity(shm_region region, shm_slotarray slots) {
+   struct shm_slotarray_header *header = shm_resolve(region, slots, sizeof(*header));
+   return header ? header->capacity : 0;
+}
+
+static void shm_slotarray_clear(shm_region region, shm_slotarray slots) {
+   struct shm_slotarray_header *header = shm_resolve(region, slots, sizeof(*header));
+   if (header)
+      memset(shm_slotarray_slots(region, header), 0, header->capacity * sizeof(shm_offset));
+}
+#endif
+
+#if 1 // Region: Helper functions
+// Map a descriptor and check that it holds a region; takes ownership of fd on success
+static shm_region shm_map(int fd) {
+   usize size = vmem_fd_size(fd);
+   if (size <= sizeof(struct shm_region_header))
+      return NULL;
+
+   char *base = vmem_map_fd(fd, size, false);
+   if (!base)
+      return NULL;
+
+   struct shm_region_header *header = (struct shm_region_header *)base;
+   if (memcmp(header->magic, SHM_MAGIC, sizeof(header->magic)) != 0 || header->capacity != size) {
+      vmem_release(base, size);
+      return NULL;
+   }
+   atomic_thread_fence(memory_order_acquire);
+
+   shm_region region = sysmem_alloc(sizeof(struct sc_shm_region));
+   if (!region) {
+      vmem_release(base, size);
+      return NULL;
+   }
+   region->base = base;
+   region->size = size;
+   region->fd = fd;
+   return region;
+}
+
+static struct shm_region_header *shm_header(shm_region region) {
+   return (struct shm_region_header *)region->base;
+}
+
+// Resolve an offset, checking that `size` bytes from it lie inside the region
+static object shm_resolve(shm_region region, shm_offset offset, usize size) {
+   if (!region || offset == 0 || offset >= region->size || size > region->size - offset)
+      return NULL;
+   return region->base + offset;
+}
+#endif
+
+const sc_shm_region_i ShmRegion = {
+    .create = shm_create,
+    .open = shm_open_name,
+    .open_fd = shm_open_fd,
+    .close = shm_close,
+    .unlink = shm_unlink_name,
+    .fd = shm_get_fd,
+    .alloc = shm_alloc,
+    .at = shm_at,
+    .offset_of = shm_offset_of,
+    .set_root = shm_set_root,
+    .root = shm_root,
+    .used = shm_used,
+};
+
+const sc_shm_farray_i ShmFArray = {
+    .new = shm_farray_new,
+    .capacity = shm_farray_capacity,
+    .set = shm_farray_set,
+    .get = shm_farray_get,
+    .at = shm_farray_at,
+};
+
+const sc_shm_list_i ShmList = {
+    .new = shm_list_new,
+    .size = shm_list_size,
+    .capacity = shm_list_capacity,
+    .append = shm_list_append,
+    .get = shm_list_get,
+    .set = shm_list_set,
+    .remove = shm_list_remove,
+    .clear = shm_list_clear,
+};
+
+const sc_shm_slotarray_i ShmSlotArray = {
+    .new = shm_slotarray_new,
+    .add = shm_slotarray_add,
+    .get_at = shm_slotarray_get_at,
+    .remove_at = shm_slotarray_remove_at,
+    .is_empty_slot = shm_slotarray_is_empty_slot,
+    .capacity = shm_slotarray_capacity,
+    .clear = shm_slotarray_clear,
+};
@@ -43,36 +43,46 @@
 struct sc_slotarray {
    parray array;    // underlying parray for storage
    usize next_slot; // next slot to check for reuse
+   allocator alloc; // allocator owning the slotarray and its parray
 };
 
 // forward declaration of internal functions
 // (none needed)
 
-// create new slotarray with specified initial capacity
-static slotarray slotarray_new(usize capacity) {
+// create new slotarray with specified initial capacity and allocator
+static slotarray slotarray_new_with(usize capacity, allocator alloc) {
+   if (!alloc) {
+      alloc = scope_allocator();
+   }
+
    //  allocate memory for the slotarray structure
-   slotarray sa = scope_alloc(sizeof(struct sc_slotarray), false);
+   slotarray sa = allocator_alloc(alloc, sizeof(struct sc_slotarray), false);
    if (!sa) {
       return NULL; // allocation ERRed
    }
 
    // create underlying parray
-   sa->array = PArray.new(capacity);
+   sa->array = PArray.new_with(capacity, alloc);
    if (!sa->array) {
-      Memory.dispose(sa);
+      allocator_free(alloc, sa);
       return NULL;
    }
 
    sa->next_slot = 0;
+   sa->alloc = alloc;
    return sa;
 }
+// create new slotarray with specified initial capacity
+static slotarray slotarray_new(usize capacity) {
+   return slotarray_new_with(capacity, NULL);
+}
 // dispose of the slotarray and free its resources
 static void slotarray_dispose(slotarray sa) {
    if (!sa) {
       return; // nothing to dispose
    }
    PArray.dispose(sa->array);
-   Memory.dispose(sa);
+   allocator_free(sa->alloc, sa);
 }
 // add a value to the slotarray, reusing empty slots if available
 static int slotarray_add(slotarray sa, object value) {
@@ -97,6 +107,28 @@ static int slotarray_add(slotarray sa, object value) {
    return ERR;
 }
 
+// visit the slotarray's pointer fields, its parray header and optionally the stored pointers
+int slotarray_image_slots(slotarray sa, bool elements, image_slot_fn visit, void *ctx) {
+   if (!sa || !sa->array || ((sc_array_base *)sa->array)->handle[0] != 'P') {
+      return ERR; // invalid slotarray
+   }
+   if (!visit) {
+      return OK;
+   }
+
+   sc_array_base *arr = (sc_array_base *)sa->array;
+   visit(&sa->array, ctx);
+   visit(&sa->alloc, ctx);
+   visit(&arr->bucket, ctx);
+   visit(&arr->end, ctx);
+   visit(&arr->alloc, ctx);
+   // empty slots hold ADDR_EMPTY, which is never relocated
+   for (addr *slot = arr->bucket; elements && slot < (addr *)arr->end; slot++) {
+      visit(slot, ctx);
+   }
+   return OK;
+}
+
 // get the value at the specified index in the slotarray
 static int slotarray_get_at(slotarray sa, usize index, object *out_value) {
    if (!sa || !out_value) {
@@ -196,6 +228,7 @@ static slotarray slotarray_from_value_array(farray arr, usize stride) {
 // public interface implementation
 const sc_slotarray_i SlotArray = {
     .new = slotarray_new,
+    .new_with = slotarray_new_with,
     .dispose = slotarray_dispose,
     .add = slotarray_add,
     .get_at = slotarray_get_at,
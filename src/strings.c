@@ -32,6 +32,7 @@
  */
 
 #include "sigcore/strings.h"
+#include "internal/array_base.h"
 #include "internal/collections.h"
 #include "internal/memory_internal.h"
 #include "sigcore/collections.h"
@@ -146,19 +147,34 @@ struct string_builder_s {
    char *buffer;    /* Direct pointer to the buffer for efficiency */
    size_t capacity; /* Current buffer capacity */
    size_t length;   /* Current string length (excluding null terminator) */
+   allocator alloc; /* Allocator owning the builder and its buffers */
 };
 
-/* Initializes a string builder with the given capacity */
-string_builder stringbuilder_new(size_t capacity) {
+/* Grows the buffer through its allocator (in place when an arena allows it) */
+static int stringbuilder_grow(string_builder sb, size_t new_capacity) {
+   sc_array_base *array = (sc_array_base *)sb->array;
+   if (array_base_resize(array, 1, new_capacity) != OK)
+      return ERR;
+
+   sb->buffer = (char *)array->bucket;
+   sb->capacity = new_capacity - 1;
+   return OK;
+}
+
+/* Initializes a string builder with the given capacity and allocator */
+string_builder stringbuilder_new_with(size_t capacity, allocator alloc) {
    if (capacity == 0)
       capacity = 16;
-   string_builder sb = scope_alloc(sizeof(struct string_builder_s), false);
+   if (!alloc)
+      alloc = scope_allocator();
+   string_builder sb = allocator_alloc(alloc, sizeof(struct string_builder_s), false);
    if (!sb)
       return NULL;
 
-   sb->array = FArray.new(capacity + 1, 1); /* +1 for null terminator */
+   sb->alloc = alloc;
+   sb->array = FArray.new_with(capacity + 1, 1, alloc); /* +1 for null terminator */
    if (!sb->array) {
-      Memory.dispose(sb);
+      allocator_free(alloc, sb);
       return NULL;
    }
 
@@ -172,6 +188,11 @@ string_builder stringbuilder_new(size_t capacity) {
    return sb;
 }
 
+/* Initializes a string builder with the given capacity */
+string_builder stringbuilder_new(size_t capacity) {
+   return stringbuilder_new_with(capacity, NULL);
+}
+
 /* Initializes a new string builder from char* buffer. */
 string_builder stringbuilder_from_string(string str) {
    if (!str)
@@ -190,23 +211,8 @@ void stringbuilder_append(string_builder sb, string str) {
    size_t len = strlen(str);
    size_t needed_capacity = sb->length + len + 1;
 
-   if (needed_capacity > sb->capacity) {
-      size_t new_capacity = needed_capacity;
-
-      farray new_array = FArray.new(new_capacity, 1);
-      if (!new_array)
-         return;
-
-      collection new_coll = FArray.as_collection(new_array, 1);
-      char *new_buffer = (char *)collection_get_buffer(new_coll);
-      memcpy(new_buffer, sb->buffer, sb->length + 1);
-      Collections.dispose(new_coll);
-
-      FArray.dispose(sb->array);
-      sb->array = new_array;
-      sb->buffer = new_buffer;
-      sb->capacity = new_capacity - 1;
-   }
+   if (needed_capacity > sb->capacity && stringbuilder_grow(sb, needed_capacity) != OK)
+      return;
 
    memcpy(sb->buffer + sb->length, str, len);
    sb->length += len;
@@ -231,24 +237,9 @@ void stringbuilder_appendf(string_builder sb, string format, ...) {
    size_t required_len = (size_t)len;
    size_t needed_capacity = sb->length + required_len + 1;
 
-   if (needed_capacity > sb->capacity) {
-      size_t new_capacity = needed_capacity;
-
-      farray new_array = FArray.new(new_capacity, 1);
-      if (!new_array) {
-         va_end(args);
-         return;
-      }
-
-      collection new_coll = FArray.as_collection(new_array, 1);
-      char *new_buffer = (char *)collection_get_buffer(new_coll);
-      memcpy(new_buffer, sb->buffer, sb->length + 1);
-      Collections.dispose(new_coll);
-
-      FArray.dispose(sb->array);
-      sb->array = new_array;
-      sb->buffer = new_buffer;
-      sb->capacity = new_capacity - 1;
+   if (needed_capacity > sb->capacity && stringbuilder_grow(sb, needed_capacity) != OK) {
+      va_end(args);
+      return;
    }
 
    vsnprintf(sb->buffer + sb->length, required_len + 1, format, args);
@@ -350,11 +341,12 @@ void stringbuilder_dispose(string_builder sb) {
       return;
    if (sb->array)
       FArray.dispose(sb->array);
-   Memory.dispose(sb);
+   allocator_free(sb->alloc, sb);
 }
 
 const sc_stringbuilder_i StringBuilder = {
     .new = stringbuilder_new,
+    .new_with = stringbuilder_new_with,
     .snew = stringbuilder_from_string,
     .append = stringbuilder_append,
     .appendf = stringbuilder_appendf,
@@ -0,0 +1,233 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: trace.c
+ * Description: SigmaCore allocator event trace rings and Chrome trace export
+ *
+ * Every thread that records an event while tracing is on gets its own ring of
+ * fixed-size events. Only the owning thread writes a ring, so recording is a
+ * timestamp, a store and a release increment of the ring's head; when the ring
+ * is full the oldest events are overwritten. Rings are linked into a global
+ * list (push-only) so Memory.Trace.dump can walk them; they live until the
+ * process exits. When a thread exits its ring is marked idle and the next new
+ * thread takes it over (keeping its events and thread number), so thread-pool
+ * churn does not grow the list. Memory.Trace.clear only bumps a generation:
+ * each owner resets its own head when it next records, and dump skips rings
+ * that have not recorded since. A dump taken while other threads record may
+ * contain a few torn events at the ring boundary.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "internal/trace.h"
+#include "internal/memory_internal.h"
+#include <stdio.h>
+#include <threads.h>
+#include <time.h>
+#include <unistd.h>
+
+// Events per thread when Memory.Trace.start is given 0
+#define TRACE_DEFAULT_EVENTS 4096
+
+// One recorded event
+struct trace_event {
+   uint64_t ts;      // CLOCK_MONOTONIC nanoseconds
+   const void *addr; // Address the event refers to
+   usize size;       // Size the event refers to
+   int kind;         // enum trace_event_kind
+};
+
+// A thread's event ring
+struct trace_ring {
+   struct trace_ring *next;      // Next ring in trace_rings
+   _Atomic bool in_use;          // Owned by a live thread
+   _Atomic uint64_t generation;  // trace_generation the head counts from
+   _Atomic uint64_t head;        // Events recorded (the next slot is head & mask)
+   usize mask;                   // Capacity - 1 (capacity is a power of two)
+   uint32_t tid;                 // Thread number shown in the trace
+   struct trace_event events[];  // Ring storage
+};
+
+_Atomic bool memory_trace_on = false;
+static _Atomic(struct trace_ring *) trace_rings = NULL;
+static _Atomic usize trace_capacity = TRACE_DEFAULT_EVENTS;
+static _Atomic uint32_t trace_next_tid = 1;
+static _Atomic uint64_t trace_origin = 0;     // Timestamp the dump counts from
+static _Atomic uint64_t trace_generation = 0; // Bumped by Memory.Trace.clear
+static _Thread_local struct trace_ring *thread_ring = NULL;
+static tss_t trace_ring_key;
+
+// Chrome trace event names by kind (frame begin and end share one name)
+static const char *const trace_names[TRACE_EVENT_KINDS] = {
+    "alloc", "dispose", "page_grow", "page_release", "frame", "frame", "collection_grow",
+};
+
+#if 1 // Region: Forward declarations
+static uint64_t trace_now(void);
+static struct trace_ring *trace_ring_acquire(void);
+static void trace_ring_exit(void *ring);
+static void trace_write_event(FILE *file, const struct trace_ring *ring, const struct trace_event *event, bool *first);
+#endif
+
+#if 1 // Region: Recording
+void memory_trace_record(int kind, const void *addr, usize size) {
+   struct trace_ring *ring = thread_ring;
+   if (!ring && !(ring = trace_ring_acquire()))
+      return;
+
+   uint64_t generation = atomic_load_explicit(&trace_generation, memory_order_acquire);
+   if (atomic_load_explicit(&ring->generation, memory_order_relaxed) != generation) {
+      // Cleared since this ring last recorded: start over before dump looks at it again
+      atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+      atomic_store_explicit(&ring->generation, generation, memory_order_release);
+   }
+   uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+   struct trace_event *event = &ring->events[head & ring->mask];
+   event->ts = trace_now();
+   event->addr = addr;
+   event->size = size;
+   event->kind = kind;
+   atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+static uint64_t trace_now(void) {
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+// Claim a ring for the calling thread: an idle one of the current capacity, or a new one
+static struct trace_ring *trace_ring_acquire(void) {
+   usize capacity = atomic_load(&trace_capacity);
+   struct trace_ring *ring;
+   for (ring = atomic_load(&trace_rings); ring; ring = ring->next) {
+      bool idle = false;
+      if (ring->mask + 1 == capacity && atomic_compare_exchange_strong(&ring->in_use, &idle, true))
+         break;
+   }
+   if (!ring) {
+      ring = sysmem_alloc(sizeof(struct trace_ring) + capacity * sizeof(struct trace_event));
+      if (!ring)
+         return NULL;
+      atomic_init(&ring->in_use, true);
+      atomic_init(&ring->generation, atomic_load(&trace_generation));
+      atomic_init(&ring->head, 0);
+      ring->mask = capacity - 1;
+      ring->tid = atomic_fetch_add(&trace_next_tid, 1);
+      ring->next = atomic_load(&trace_rings);
+      while (!atomic_compare_exchange_weak(&trace_rings, &ring->next, ring))
+         ;
+   }
+   thread_ring = ring;
+   tss_set(trace_ring_key, ring);
+   return ring;
+}
+
+// Thread-exit destructor registered through tss_create: hand the ring to the next thread
+static void trace_ring_exit(void *ring) {
+   thread_ring = NULL;
+   if (ring)
+      atomic_store(&((struct trace_ring *)ring)->in_use, false);
+}
+#endif
+
+#if 1 // Region: Memory.Trace operations
+// Start recording; rings created from now on hold `events_per_thread` events (rounded up to a power of two)
+int memory_trace_start(usize events_per_thread) {
+   usize capacity = events_per_thread ? events_per_thread : TRACE_DEFAULT_EVENTS;
+   if (capacity > ((usize)1 << 30))
+      return ERR;
+   usize rounded = 1;
+   while (rounded < capacity)
+      rounded <<= 1;
+
+   atomic_store(&trace_capacity, rounded);
+   uint64_t zero = 0;
+   atomic_compare_exchange_strong(&trace_origin, &zero, trace_now());
+   atomic_store(&memory_trace_on, true);
+   return OK;
+}
+
+void memory_trace_stop(void) {
+   atomic_store(&memory_trace_on, false);
+}
+
+// Forget recorded events; owners reset their rings on their next event, so
+// clearing never races with a thread that is recording
+void memory_trace_clear(void) {
+   atomic_store(&trace_origin, trace_now());
+   atomic_fetch_add_explicit(&trace_generation, 1, memory_order_release);
+}
+
+// Write every ring's events as Chrome trace JSON (chrome://tracing, Perfetto)
+int memory_trace_dump(const char *path) {
+   if (!path)
+      return ERR;
+   FILE *file = fopen(path, "w");
+   if (!file)
+      return ERR;
+
+   fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+   bool first = true;
+   uint64_t generation = atomic_load_explicit(&trace_generation, memory_order_acquire);
+   for (struct trace_ring *ring = atomic_load(&trace_rings); ring; ring = ring->next) {
+      if (atomic_load_explicit(&ring->generation, memory_order_acquire) != generation)
+         continue; // Nothing recorded since the last clear
+      uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+      uint64_t count = head > ring->mask + 1 ? ring->mask + 1 : head;
+      for (uint64_t i = head - count; i < head; i++)
+         trace_write_event(file, ring, &ring->events[i & ring->mask], &first);
+   }
+   fprintf(file, "]}\n");
+   return fclose(file) == 0 ? OK : ERR;
+}
+
+// One Chrome trace event: frames are B/E durations, everything else thread-scoped instants
+static void trace_write_event(FILE *file, const struct trace_ring *ring, const struct trace_event *event, bool *first) {
+   if (event->kind < 0 || event->kind >= TRACE_EVENT_KINDS)
+      return; // Torn by a concurrent writer
+   uint64_t origin = atomic_load(&trace_origin);
+   double ts = event->ts > origin ? (double)(event->ts - origin) / 1000.0 : 0.0;
+   const char *phase = event->kind == TRACE_FRAME_BEGIN ? "B" : event->kind == TRACE_FRAME_END ? "E" : "i";
+
+   fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"memory\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,",
+           *first ? "" : ",", trace_names[event->kind], phase, ts, (int)getpid(), ring->tid);
+   if (*phase == 'i')
+      fprintf(file, "\"s\":\"t\",");
+   fprintf(file, "\"args\":{\"addr\":\"%p\",\"size\":%zu}}", event->addr, (size_t)event->size);
+   *first = false;
+}
+#endif
+
+__attribute__((constructor)) static void trace_auto_init(void) {
+   tss_create(&trace_ring_key, trace_ring_exit);
+}
+
+// Rings are only read by dump, so they are freed when the process exits
+__attribute__((destructor)) static void trace_auto_teardown(void) {
+   atomic_store(&memory_trace_on, false);
+   struct trace_ring *ring = atomic_exchange(&trace_rings, NULL);
+   while (ring) {
+      struct trace_ring *next = ring->next;
+      sysmem_free(ring);
+      ring = next;
+   }
+}
@@ -0,0 +1,385 @@
+/*
+ * SigmaCore
+ * Copyright (c) 2025 David Boarman (BadKraft) and contributors
+ * QuantumOverride [Q|]
+ * ----------------------------------------------
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * ----------------------------------------------
+ * File: vmem.c
+ * Description: SigmaCore virtual memory primitives (reserve/commit/decommit)
+ *
+ * Reserved arenas take one large PROT_NONE mapping up front and make it
+ * accessible in steps as the bump pointer advances. Committing and
+ * decommitting re-map the affected range in place (MAP_FIXED inside our own
+ * reservation), which also gives us MAP_POPULATE prefaulting on commit and
+ * an immediate return of the pages to the kernel on decommit. The new
+ * mapping does not inherit advice given to the reservation, so huge page
+ * advice is applied to each committed range instead.
+ */
+#define _GNU_SOURCE
+#include "internal/vmem.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0 // Older kernels: the hint is only advisory
+#endif
+
+// NUMA memory policy constants (linux/mempolicy.h); the syscalls are used directly so
+// there is no libnuma dependency, and every failure degrades to "no binding"
+#define VMEM_MPOL_DEFAULT 0
+#define VMEM_MPOL_BIND 2
+#define VMEM_MPOL_MF_MOVE (1 << 1)
+#define VMEM_MPOL_F_MEMS_ALLOWED (1 << 2)
+#define VMEM_NUMA_MAX_NODES 1024
+#define VMEM_NUMA_MASK_WORDS (VMEM_NUMA_MAX_NODES / (8 * sizeof(unsigned long)))
+#define VMEM_NUMA_QUERY_BATCH 64
+
+// Get the operating system page size
+usize vmem_page_size(void) {
+   static usize page_size = 0;
+   if (!page_size) {
+      long size = sysconf(_SC_PAGESIZE);
+      page_size = size > 0 ? (usize)size : 4096;
+   }
+   return page_size;
+}
+
+// Reserve address space only
+object vmem_reserve(usize size) {
+   if (size == 0)
+      return NULL;
+
+   void *base = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   return base == MAP_FAILED ? NULL : base;
+}
+
+// Reserve more than asked and trim the ends so the range starts on `align`
+object vmem_reserve_aligned(usize size, usize align) {
+   usize page = vmem_page_size();
+   if (align <= page)
+      return vmem_reserve(size);
+   if (size == 0 || size + align < size)
+      return NULL;
+
+   char *base = vmem_reserve(size + align);
+   if (!base)
+      return NULL;
+   char *start = (char *)(((uintptr_t)base + align - 1) & ~(uintptr_t)(align - 1));
+   if (start > base)
+      munmap(base, (usize)(start - base));
+   if (start + size < base + size + align)
+      munmap(start + size, (usize)(base + size + align - (start + size)));
+   return start;
+}
+
+// Fault in a committed range for writing
+static void vmem_populate(object addr, usize size) {
+#ifdef MADV_POPULATE_WRITE
+   if (madvise(addr, size, MADV_POPULATE_WRITE) == 0)
+      return;
+#endif
+   // Older kernels: touch every page (they are fresh, so writing zero changes nothing)
+   usize page = vmem_page_size();
+   for (usize offset = 0; offset < size; offset += page)
+      ((volatile char *)addr)[offset] = 0;
+}
+
+// Commit part of a reservation (fresh pages read as zero)
+int vmem_commit(object addr, usize size, bool prefault, bool huge) {
+   if (!addr || size == 0)
+      return ERR;
+
+   // With huge pages, populating waits for the advice, or the range faults in as small pages
+   int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+   if (prefault && !huge)
+      flags |= MAP_POPULATE;
+
+   void *mapped = mmap(addr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+   if (mapped == MAP_FAILED)
+      return ERR;
+
+   if (huge) {
+      vmem_advise_huge(addr, size); // Best effort; small pages work too
+      if (prefault)
+         vmem_populate(addr, size);
+   }
+   return OK;
+}
+
+// Drop the pages of a committed range, leaving it reserved
+int vmem_decommit(object addr, usize size) {
+   if (!addr || size == 0)
+      return ERR;
+
+   void *mapped = mmap(addr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+   return mapped == MAP_FAILED ? ERR : OK;
+}
+
+// Transparent huge page hint
+int vmem_advise_huge(object addr, usize size) {
+#ifdef MADV_HUGEPAGE
+   return madvise(addr, size, MADV_HUGEPAGE) == 0 ? OK : ERR;
+#else
+   (void)addr;
+   (void)size;
+   return ERR;
+#endif
+}
+
+// Map a file range copy-on-write, at `hint` when that range is free
+object vmem_map_file(const char *path, usize offset, usize size, object hint) {
+   if (!path || size == 0)
+      return NULL;
+
+   int fd = open(path, O_RDONLY);
+   if (fd < 0)
+      return NULL;
+
+   // A kernel without MAP_FIXED_NOREPLACE may place a hinted mapping elsewhere;
+   // the caller compares the result with the hint and relocates if needed
+   void *base = MAP_FAILED;
+   if (hint)
+      base = mmap(hint, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED_NOREPLACE, fd, (off_t)offset);
+   if (base == MAP_FAILED)
+      base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t)offset);
+
+   close(fd);
+   return base == MAP_FAILED ? NULL : base;
+}
+
+// Seal a range against writes
+int vmem_protect_read(object addr, usize size) {
+   return mprotect(addr, size, PROT_READ) == 0 ? OK : ERR;
+}
+
+// Release the whole reservation
+void vmem_release(object addr, usize size) {
+   if (addr && size)
+      munmap(addr, size);
+}
+
+// NUMA node of the calling thread's CPU
+int vmem_numa_current_node(void) {
+#ifdef SYS_getcpu
+   unsigned cpu = 0, node = 0;
+   if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0)
+      return (int)node;
+#endif
+   return -1;
+}
+
+// A node is usable when the kernel lists it among the nodes we may allocate from
+bool vmem_numa_node_valid(int node) {
+#ifdef SYS_get_mempolicy
+   if (node < 0 || node >= VMEM_NUMA_MAX_NODES)
+      return false;
+
+   unsigned long mask[VMEM_NUMA_MASK_WORDS] = {0};
+   if (syscall(SYS_get_mempolicy, NULL, mask, (unsigned long)VMEM_NUMA_MAX_NODES, NULL,
+               (unsigned long)VMEM_MPOL_F_MEMS_ALLOWED) != 0)
+      return false;
+   usize bits = 8 * sizeof(unsigned long);
+   return (mask[node / bits] >> (node % bits)) & 1;
+#else
+   (void)node;
+   return false;
+#endif
+}
+
+// Bind whole OS pages to a node; mbind needs a page-aligned start
+int vmem_numa_bind(object addr, usize size, int node) {
+#ifdef SYS_mbind
+   usize page = vmem_page_size();
+   uintptr_t start = ((uintptr_t)addr + page - 1) & ~(uintptr_t)(page - 1);
+   uintptr_t end = ((uintptr_t)addr + size) & ~(uintptr_t)(page - 1);
+   if (!addr || end <= start)
+      return OK; // No whole page to bind
+   if (node >= VMEM_NUMA_MAX_NODES)
+      return ERR;
+
+   unsigned long mask[VMEM_NUMA_MASK_WORDS] = {0};
+   int mode = VMEM_MPOL_DEFAULT;
+   if (node >= 0) {
+      usize bits = 8 * sizeof(unsigned long);
+      mask[node / bits] = 1UL << (node % bits);
+      mode = VMEM_MPOL_BIND;
+   }
+   long result = syscall(SYS_mbind, (void *)start, (unsigned long)(end - start), mode,
+                         node >= 0 ? mask : NULL, node >= 0 ? (unsigned long)VMEM_NUMA_MAX_NODES : 0UL,
+                         (unsigned)(node >= 0 ? VMEM_MPOL_MF_MOVE : 0));
+   return result == 0 ? OK : ERR;
+#else
+   (void)addr;
+   (void)size;
+   (void)node;
+   return ERR;
+#endif
+}
+
+// Ask the kernel where each resident page lives (move_pages without target nodes)
+usize vmem_numa_placement(object addr, usize size, usize *pages_per_node, usize nodes) {
+#ifdef SYS_move_pages
+   if (!addr || size == 0)
+      return 0;
+
+   usize page = vmem_page_size();
+   uintptr_t start = (uintptr_t)addr & ~(uintptr_t)(page - 1);
+   uintptr_t end = (uintptr_t)addr + size;
+   usize found = 0;
+
+   while (start < end) {
+      void *pages[VMEM_NUMA_QUERY_BATCH];
+      int status[VMEM_NUMA_QUERY_BATCH];
+      usize count = 0;
+      for (; count < VMEM_NUMA_QUERY_BATCH && start < end; count++, start += page)
+         pages[count] = (void *)start;
+
+      if (syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, status, 0) != 0)
+         return found;
+
+      for (usize i = 0; i < count; i++) {
+         if (status[i] < 0)
+            continue; // Not resident (never touched) or not queryable
+         if (pages_per_node && (usize)status[i] < nodes)
+            pages_per_node[status[i]]++;
+         found++;
+      }
+   }
+   return found;
+#else
+   (void)addr;
+   (void)size;
+   (void)pages_per_node;
+   (void)nodes;
+   return 0;
+#endif
+}
+
+// Requested node (or the caller's) if it can be bound to, otherwise -1
+int vmem_numa_resolve(int node) {
+   if (node < 0)
+      node = vmem_numa_current_node();
+   return vmem_numa_node_valid(node) ? node : -1;
+}
+
+// Anonymous memfd or named POSIX shared memory, sized up front
+int vmem_shared_create(const char *name, usize size) {
+   if (size == 0)
+      return -1;
+
+   int fd = name ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600) : memfd_create("sigcore-shm", MFD_CLOEXEC);
+   if (fd < 0)
+      return -1;
+   if (ftruncate(fd, (off_t)size) != 0) {
+      close(fd);
+      if (name)
+         shm_unlink(name);
+      return -1;
+   }
+   return fd;
+}
+
+int vmem_shared_open(const char *name) {
+   return name ? shm_open(name, O_RDWR, 0) : -1;
+}
+
+int vmem_shared_unlink(const char *name) {
+   return name && shm_unlink(name) == 0 ? OK : ERR;
+}
+
+usize vmem_fd_size(int fd) {
+   struct stat st;
+   return fstat(fd, &st) == 0 && st.st_size > 0 ? (usize)st.st_size : 0;
+}
+
+// Map a descriptor shared, or copy-on-write for a private view
+object vmem_map_fd(int fd, usize size, bool private_copy) {
+   if (fd < 0 || size == 0)
+      return NULL;
+   void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, private_copy ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+   return base == MAP_FAILED ? NULL : base;
+}
+
+void vmem_close_fd(int fd) {
+   if (fd >= 0)
+      close(fd);
+}
+
+int vmem_dup_fd(int fd) {
+   return fd >= 0 ? dup(fd) : -1;
+}
+
+// Map a descriptor over an existing range, replacing whatever was mapped there
+int vmem_remap_fd(object addr, usize size, int fd, bool private_copy) {
+   if (!addr || size == 0 || fd < 0)
+      return ERR;
+   int flags = private_copy ? MAP_PRIVATE | MAP_NORESERVE : MAP_SHARED;
+   void *mapped = mmap(addr, size, PROT_READ | PROT_WRITE, flags | MAP_FIXED, fd, 0);
+   return mapped == MAP_FAILED ? ERR : OK;
+}
+
+// Write the pages of a private file mapping that were copied on write back to the file.
+// /proc/self/pagemap tells them apart: a copied page is present or swapped but no longer
+// file-backed (bit 61 clear). Without pagemap the whole range is written.
+int vmem_write_back(object addr, usize size, int fd) {
+   if (!addr || size == 0 || fd < 0)
+      return ERR;
+
+   usize page_size = vmem_page_size();
+   usize pages = (size + page_size - 1) / page_size;
+   int pagemap = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+   if (pagemap < 0)
+      return pwrite(fd, addr, size, 0) == (ssize_t)size ? OK : ERR;
+
+   uint64_t entries[512];
+   off_t index = (off_t)((uintptr_t)addr / page_size);
+   int result = OK;
+   for (usize first = 0; first < pages && result == OK; first += 512) {
+      usize count = pages - first < 512 ? pages - first : 512;
+      ssize_t got = pread(pagemap, entries, count * sizeof(uint64_t), (index + (off_t)first) * (off_t)sizeof(uint64_t));
+      if (got != (ssize_t)(count * sizeof(uint64_t))) {
+         result = pwrite(fd, addr, size, 0) == (ssize_t)size ? OK : ERR;
+         break;
+      }
+      for (usize i = 0; i < count; i++) {
+         uint64_t entry = entries[i];
+         bool resident = entry & ((uint64_t)3 << 62); // Present or swapped
+         if (!resident || (entry & ((uint64_t)1 << 61)))
+            continue; // Untouched since the private mapping was made
+         usize offset = (first + i) * page_size;
+         usize length = offset + page_size > size ? size - offset : page_size;
+         if (pwrite(fd, (char *)addr + offset, length, (off_t)offset) != (ssize_t)length) {
+            result = ERR;
+            break;
+         }
+      }
+   }
+   close(pagemap);
+   return result;
+}
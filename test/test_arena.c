@@ -4,10 +4,15 @@
  */
 
 #include "sigcore/arena.h"
+#include "sigcore/farray.h"
+#include "sigcore/list.h"
 #include "sigcore/memory.h"
+#include "sigcore/slotarray.h"
+#include "sigcore/strings.h"
 #include <sigtest/sigtest.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static void set_config(FILE **log_stream) {
    *log_stream = fopen("logs/test_arena.log", "w");
@@ -344,7 +349,7 @@ void test_frame_basic(void) {
 
    // Begin a frame
    frame test_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(test_frame, "Arena.begin_frame() should succeed");
+   Assert.isNotNull(test_frame.slot, "Arena.begin_frame() should succeed");
 
    // Allocate some memory in the frame
    object ptr1 = Arena.alloc(arena, 64, false);
@@ -383,14 +388,14 @@ void test_frame_nested(void) {
 
    // Begin outer frame
    frame outer_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(outer_frame, "Outer frame creation should succeed");
+   Assert.isNotNull(outer_frame.slot, "Outer frame creation should succeed");
 
    object outer_ptr = Arena.alloc(arena, 100, false);
    Assert.isNotNull(outer_ptr, "Outer frame allocation should succeed");
 
    // Begin inner frame
    frame inner_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(inner_frame, "Inner frame creation should succeed");
+   Assert.isNotNull(inner_frame.slot, "Inner frame creation should succeed");
 
    object inner_ptr = Arena.alloc(arena, 50, false);
    Assert.isNotNull(inner_ptr, "Inner frame allocation should succeed");
@@ -422,7 +427,7 @@ void test_frame_page_growth(void) {
 
    // Begin frame
    frame test_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(test_frame, "Frame creation should succeed");
+   Assert.isNotNull(test_frame.slot, "Frame creation should succeed");
 
    usize initial_pages = Arena.get_page_count(arena);
 
@@ -465,14 +470,14 @@ void test_frame_edge_cases(void) {
 
    // Test begin_frame on NULL arena
    frame null_frame = Arena.begin_frame(NULL);
-   Assert.isNull(null_frame, "begin_frame(NULL) should return NULL");
+   Assert.isNull(null_frame.slot, "begin_frame(NULL) should return an empty handle");
 
    // Test end_frame on NULL frame
-   Arena.end_frame(NULL); // Should not crash
+   Arena.end_frame((frame){0}); // Should not crash
 
    // Test empty frame (no allocations)
    frame empty_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(empty_frame, "Empty frame creation should succeed");
+   Assert.isNotNull(empty_frame.slot, "Empty frame creation should succeed");
 
    usize alloc_before = Arena.get_total_allocated(arena);
    Arena.end_frame(empty_frame);
@@ -489,6 +494,54 @@ void test_frame_edge_cases(void) {
    Memory.Arena.dispose(arena);
 }
 
+static void stale_defer(object arg) {
+   (void)arg;
+}
+
+// test handles of ended frames stay rejected after their slot is reused
+void test_frame_stale_handles(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   Assert.isNotNull(arena, "Arena setup should succeed");
+
+   frame first = Arena.begin_frame(arena);
+   Memory.Scope.push(Arena.get_frame_scope(first));
+   allocator captured = Memory.Scope.allocator();
+   Memory.Scope.pop();
+   Assert.isNotNull(captured->alloc(captured->ctx, 16, false), "Live frame allocator should allocate");
+   Arena.end_frame(first);
+
+   // A new frame at the same depth must not revive the old handle
+   frame second = Arena.begin_frame(arena);
+   Assert.isNotNull(second.slot, "Frame after an ended one should begin");
+   Assert.isTrue(second.slot == first.slot, "Frames at the same depth should share a slot");
+   Assert.isNull(Arena.get_frame_arena(first), "Ended frame handle should be rejected");
+   Assert.isNull(Arena.get_frame_scope(first), "Ended frame should have no scope");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.defer(first, stale_defer, NULL)}, INT, "Ended frame should not take deferred calls");
+   object kept = Arena.alloc(arena, 32, false);
+   Arena.end_frame(first); // Must not roll back the live frame
+   Assert.isTrue(Arena.get_frame_arena(second) == arena, "Live frame should survive a stale end_frame");
+   Assert.isTrue(Arena.contains(arena, kept), "Live frame's allocations should survive a stale end_frame");
+
+   // The allocator is the arena's, so it keeps allocating from the arena
+   Assert.isTrue(Arena.contains(arena, captured->alloc(captured->ctx, 16, false)), "Allocator from an ended frame should fall back to its arena");
+   Arena.end_frame(second);
+
+   // Stale handles stay rejected however often the slot is reused
+   for (int i = 0; i < 100; i++) {
+      frame live = Arena.begin_frame(arena);
+      object data = Arena.alloc(arena, 64, false);
+      Assert.isTrue(live.slot == first.slot, "Frame should reuse the slot (round %d)", i);
+      Assert.isNull(Arena.get_frame_arena(first), "Ended frame handle should stay rejected (round %d)", i);
+      Assert.areEqual(&(int){ERR}, &(int){Arena.promote_all(first)}, INT, "Ended frame should not promote (round %d)", i);
+      Arena.end_frame(first);
+      Arena.end_frame(second);
+      Assert.isTrue(Arena.get_frame_arena(live) == arena && Arena.contains(arena, data),
+                    "Stale end_frame should not roll back the live frame (round %d)", i);
+      Arena.end_frame(live);
+   }
+   Memory.Arena.dispose(arena);
+}
+
 // test frame early exit (outer ended before inner)
 void test_frame_early_exit(void) {
    sc_arena *arena = Memory.Arena.create(1);
@@ -496,14 +549,14 @@ void test_frame_early_exit(void) {
 
    // Begin outer frame
    frame outer_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(outer_frame, "Outer frame creation should succeed");
+   Assert.isNotNull(outer_frame.slot, "Outer frame creation should succeed");
 
    object outer_ptr = Arena.alloc(arena, 100, false);
    Assert.isNotNull(outer_ptr, "Outer allocation should succeed");
 
    // Begin inner frame
    frame inner_frame = Arena.begin_frame(arena);
-   Assert.isNotNull(inner_frame, "Inner frame creation should succeed");
+   Assert.isNotNull(inner_frame.slot, "Inner frame creation should succeed");
 
    object inner_ptr = Arena.alloc(arena, 50, false);
    Assert.isNotNull(inner_ptr, "Inner allocation should succeed");
@@ -528,6 +581,891 @@ void test_frame_early_exit(void) {
    Memory.Arena.dispose(arena);
 }
 
+// test frames are inline markers with a bounded nesting depth
+void test_frame_inline_stack(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   Assert.isNotNull(arena, "Arena setup should succeed");
+
+   frame frames[64];
+   usize depth = 0;
+   while (depth < 64) {
+      frames[depth] = Arena.begin_frame(arena);
+      if (!frames[depth].slot)
+         break;
+      Assert.isNotNull(Arena.alloc(arena, 32, false), "Allocation at depth %zu should succeed", depth);
+      depth++;
+   }
+   Assert.isTrue(depth > 1 && depth < 64, "Frame nesting should be bounded (reached %zu)", depth);
+
+   // Unwinding the full stack makes room for new frames again
+   Arena.end_frame(frames[0]);
+   usize after = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){0}, &after, LONG, "Ending the outermost frame should roll back all nested allocations");
+   frame again = Arena.begin_frame(arena);
+   Assert.isNotNull(again.slot, "Frame should be available after the stack unwinds");
+   Arena.end_frame(again);
+
+   Memory.Arena.dispose(arena);
+}
+
+// test repeated multi-page frames reuse the pages they left behind
+void test_frame_page_reuse(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   Assert.isNotNull(arena, "Arena setup should succeed");
+
+   object keep = Arena.alloc(arena, 100, false);
+   Assert.isNotNull(keep, "Allocation before frame should succeed");
+
+   usize pages_after_first = 0;
+   for (int round = 0; round < 5; round++) {
+      frame f = Arena.begin_frame(arena);
+      Assert.isNotNull(f.slot, "Frame %d creation should succeed", round);
+      for (int i = 0; i < 12; i++) {
+         Assert.isNotNull(Arena.alloc(arena, 1024, false), "Frame %d allocation %d should succeed", round, i);
+      }
+      Arena.end_frame(f);
+
+      usize total = Arena.get_total_allocated(arena);
+      Assert.areEqual(&(usize){100}, &total, LONG, "Frame %d should roll back to the pre-frame allocation", round);
+      if (round == 0)
+         pages_after_first = Arena.get_page_count(arena);
+   }
+
+   usize pages_final = Arena.get_page_count(arena);
+   Assert.areEqual(&pages_after_first, &pages_final, LONG, "Later frames should reuse pages emptied by earlier frames");
+   Assert.isTrue(Arena.is_tracking(arena, keep), "Pre-frame allocation should stay tracked");
+
+   Memory.Arena.dispose(arena);
+}
+
+// test a rollback after an allocation skipped an empty page resets every later page
+void test_frame_skip_rollback(void) {
+   arena_opts opts = {.initial_pages = 1, .page_size = 4096, .max_page_size = 64 * 1024};
+   sc_arena *arena = Memory.Arena.create_ex(&opts);
+   Assert.isNotNull(arena, "Growing arena creation should succeed");
+
+   // First frame grows the chain to 4, 8, 16 and 32 KB pages
+   frame first = Arena.begin_frame(arena);
+   for (int i = 0; i < 30; i++) {
+      Assert.isNotNull(Arena.alloc(arena, 1000, false), "First frame allocation %d should succeed", i);
+   }
+   Arena.end_frame(first);
+   usize pages = Arena.get_page_count(arena);
+
+   // Second frame fills the first page, then skips the empty 8 KB page for the 16 KB one
+   char *skipped = NULL;
+   for (int round = 0; round < 2; round++) {
+      frame second = Arena.begin_frame(arena);
+      for (int i = 0; i < 4; i++) {
+         Assert.isNotNull(Arena.alloc(arena, 1000, false), "Round %d allocation %d should succeed", round, i);
+      }
+      char *large = Arena.alloc(arena, 12000, false);
+      Assert.isNotNull(large, "Round %d large allocation should succeed", round);
+      for (int i = 0; i < 3; i++) {
+         Assert.isNotNull(Arena.alloc(arena, 1000, false), "Round %d trailing allocation %d should succeed", round, i);
+      }
+      Arena.end_frame(second);
+
+      // The page after the skipped one must be empty again, so the pattern repeats exactly
+      if (round == 0)
+         skipped = large;
+      else
+         Assert.isTrue(large == skipped, "Rolled-back page should be reused from its start");
+      usize used = Arena.get_total_allocated(arena);
+      Assert.areEqual(&(usize){0}, &used, LONG, "Round %d should roll back every allocation", round);
+   }
+   usize pages_final = Arena.get_page_count(arena);
+   Assert.areEqual(&pages, &pages_final, LONG, "Rolled-back pages should be reused, not replaced");
+   Memory.Arena.dispose(arena);
+}
+
+// test geometric page growth policy
+void test_arena_geometric_growth(void) {
+   arena_opts opts = {.initial_pages = 1, .page_size = 4096, .max_page_size = 64 * 1024};
+   sc_arena *arena = Memory.Arena.create_ex(&opts);
+   Assert.isNotNull(arena, "Growing arena creation should succeed");
+
+   // 1 MB of 1 KB allocations: fixed 4 KB pages would need ~256 pages
+   for (int i = 0; i < 1024; i++) {
+      Assert.isNotNull(Arena.alloc(arena, 1024, false), "Allocation %d should succeed", i);
+   }
+   usize pages = Arena.get_page_count(arena);
+   Assert.isTrue(pages < 32, "Doubling pages should keep the chain short (actual: %zu)", pages);
+   usize total = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){1024 * 1024}, &total, LONG, "Total allocated should match requested bytes");
+
+   // Requests above the first page size are served once growth allows them
+   Assert.isNotNull(Arena.alloc(arena, 40000, false), "Allocation below the growth cap should succeed");
+   Assert.isNull(Arena.alloc(arena, 64 * 1024 + 1, false), "Allocation above the growth cap should fail");
+   Memory.Arena.dispose(arena);
+
+   // An explicit initial chunk size applies to the first page
+   arena_opts big = {.initial_pages = 1, .page_size = 256 * 1024};
+   sc_arena *chunked = Memory.Arena.create_ex(&big);
+   Assert.isNotNull(chunked, "Arena with a large initial chunk should succeed");
+   Assert.isNotNull(Arena.alloc(chunked, 200 * 1024, false), "Large allocation should fit the initial chunk");
+   usize chunked_pages = Arena.get_page_count(chunked);
+   Assert.areEqual(&(usize){1}, &chunked_pages, LONG, "Large allocation should not grow the arena");
+   Memory.Arena.dispose(chunked);
+
+   Assert.isNull(Memory.Arena.create_ex(NULL), "create_ex(NULL) should fail");
+}
+
+// test arena usage counters
+void test_arena_stats(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   arena_stats stats;
+   Assert.areEqual(&(int){OK}, &(int){Arena.stats(arena, &stats)}, INT, "Arena.stats should succeed");
+   Assert.areEqual(&(usize){0}, &stats.used, LONG, "New arena should have no bytes used");
+   Assert.areEqual(&(usize){4096}, &stats.reserved, LONG, "New arena should reserve one page");
+
+   Arena.alloc(arena, 3000, false);
+   Arena.alloc(arena, 3000, false); // does not fit: 1096 bytes of the first page are abandoned
+   frame f = Arena.begin_frame(arena);
+   Arena.alloc(arena, 2000, false);
+   Arena.alloc(arena, 2000, false);
+
+   Arena.stats(arena, &stats);
+   Assert.areEqual(&(usize){10000}, &stats.used, LONG, "Used should count every allocation");
+   Assert.areEqual(&(usize){3 * 4096}, &stats.reserved, LONG, "Reserved should cover three pages");
+   Assert.areEqual(&(usize){1096 + 1096}, &stats.tail_waste, LONG, "Tail waste should count skipped page ends");
+   Assert.areEqual(&(usize){3}, &stats.page_count, LONG, "Page count should match");
+   Assert.areEqual(&(usize){1}, &stats.frame_depth, LONG, "One frame should be open");
+   Assert.areEqual(&(usize){4}, &stats.tracked_blocks, LONG, "Each allocation should be tracked");
+
+   Arena.end_frame(f);
+   Arena.stats(arena, &stats);
+   Assert.areEqual(&(usize){6000}, &stats.used, LONG, "Frame rollback should restore used");
+   Assert.areEqual(&(usize){1096}, &stats.tail_waste, LONG, "Frame rollback should restore tail waste");
+   Assert.areEqual(&(usize){10000}, &stats.peak, LONG, "Peak should survive the rollback");
+   Assert.areEqual(&(usize){0}, &stats.frame_depth, LONG, "No frame should be open");
+   Assert.areEqual(&(usize){2}, &stats.tracked_blocks, LONG, "Frame allocations should be untracked");
+
+   usize total = Arena.get_total_allocated(arena);
+   Assert.areEqual(&stats.used, &total, LONG, "get_total_allocated should match stats.used");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.stats(NULL, &stats)}, INT, "Arena.stats(NULL) should fail");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.stats(arena, NULL)}, INT, "Arena.stats without output should fail");
+   Memory.Arena.dispose(arena);
+}
+
+// test reserved (virtual memory) arenas
+void test_arena_reserved(void) {
+   arena_opts opts = {.reserve = 64 * 1024 * 1024};
+   sc_arena *arena = Memory.Arena.create_ex(&opts);
+   Assert.isNotNull(arena, "Reserved arena creation should succeed");
+
+   arena_stats stats;
+   Arena.stats(arena, &stats);
+   usize initial_commit = stats.reserved;
+   Assert.isTrue(initial_commit < 128 * 1024, "Only the first commit step should be committed");
+
+   // Allocations are contiguous and grow the commit in place
+   char *first = Arena.alloc(arena, 1024 * 1024, false);
+   char *second = Arena.alloc(arena, 1024 * 1024, true);
+   Assert.isNotNull(first, "Large allocation should succeed");
+   Assert.isTrue(second == first + 1024 * 1024, "Reserved arena allocations should be contiguous");
+   Assert.isTrue(second[1024 * 1024 - 1] == 0, "Zeroed allocation should be readable to its end");
+   first[0] = 42;
+
+   usize pages = Arena.get_page_count(arena);
+   Assert.areEqual(&(usize){1}, &pages, LONG, "Reserved arena should never chain pages");
+   Arena.stats(arena, &stats);
+   Assert.isTrue(stats.reserved >= 2 * 1024 * 1024, "Commit should cover the allocations");
+
+   Assert.isTrue(Arena.contains(arena, first), "Arena should contain its allocation");
+   Assert.isTrue(Arena.contains(arena, second + 100), "Arena should contain interior pointers");
+   Assert.isFalse(Arena.contains(arena, second + 2 * 1024 * 1024), "Arena should not contain unused space");
+   Assert.isFalse(Arena.contains(arena, &stats), "Arena should not contain foreign pointers");
+
+   // Frames roll back within the single range
+   frame f = Arena.begin_frame(arena);
+   char *temp = Arena.alloc(arena, 4096, false);
+   Arena.end_frame(f);
+   char *reuse = Arena.alloc(arena, 4096, false);
+   Assert.isTrue(temp == reuse, "Frame rollback should reuse the same range");
+
+   Assert.isNull(Arena.alloc(arena, 64 * 1024 * 1024, false), "Allocation beyond the reservation should fail");
+
+   // Reset decommits the tail
+   Arena.reset(arena);
+   Arena.stats(arena, &stats);
+   Assert.areEqual(&(usize){0}, &stats.used, LONG, "Reset should discard all allocations");
+   Assert.areEqual(&initial_commit, &stats.reserved, LONG, "Reset should decommit past the first step");
+   Assert.isFalse(Arena.contains(arena, first), "Reset arena should contain nothing");
+   char *again = Arena.alloc(arena, 16, true);
+   Assert.isTrue(again == first, "Allocation after reset should start at the base");
+
+   Memory.Arena.dispose(arena);
+}
+
+// Find the /proc/self/smaps entry covering addr: 1 if its VmFlags include flag,
+// 0 if not, -1 if smaps cannot be read
+static int smaps_has_flag(const void *addr, const char *flag) {
+   FILE *smaps = fopen("/proc/self/smaps", "r");
+   if (!smaps)
+      return -1;
+
+   char line[512];
+   bool inside = false;
+   int found = -1;
+   while (found < 0 && fgets(line, sizeof(line), smaps)) {
+      unsigned long start, end;
+      if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+         inside = (uintptr_t)addr >= start && (uintptr_t)addr < end;
+      } else if (inside && strncmp(line, "VmFlags:", 8) == 0) {
+         found = 0;
+         for (char *word = strtok(line + 8, " \n"); word; word = strtok(NULL, " \n"))
+            if (strcmp(word, flag) == 0)
+               found = 1;
+      }
+   }
+   fclose(smaps);
+   return found;
+}
+
+// test that committed ranges of a huge page arena keep the huge page advice
+void test_arena_huge_pages(void) {
+   sc_arena *arena = Memory.Arena.create_ex(&(arena_opts){.reserve = 16 * 1024 * 1024, .huge_pages = true});
+   Assert.isNotNull(arena, "Huge page arena creation should succeed");
+
+   // The first commit step is 2MB; the second allocation commits another step
+   char *first = Arena.alloc(arena, 64, false);
+   char *second = Arena.alloc(arena, 3 * 1024 * 1024, false);
+   Assert.isNotNull(second, "Allocation past the first commit step should succeed");
+   second[3 * 1024 * 1024 - 1] = 1;
+
+   // Without THP (or smaps) there is no advice to check
+   FILE *thp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+   char mode[128] = {0};
+   bool supported = thp && fgets(mode, sizeof(mode), thp) && !strstr(mode, "[never]");
+   if (thp)
+      fclose(thp);
+   if (supported && smaps_has_flag(first, "hg") >= 0) {
+      Assert.areEqual(&(int){1}, &(int){smaps_has_flag(first, "hg")}, INT, "First commit step should be advised");
+      Assert.areEqual(&(int){1}, &(int){smaps_has_flag(second + 3 * 1024 * 1024 - 1, "hg")}, INT,
+                      "Later commit steps should be advised");
+   }
+
+   // Committing again after a reset keeps the advice
+   Arena.reset(arena);
+   char *again = Arena.alloc(arena, 3 * 1024 * 1024, false);
+   again[3 * 1024 * 1024 - 1] = 1;
+   if (supported && smaps_has_flag(again, "hg") >= 0)
+      Assert.areEqual(&(int){1}, &(int){smaps_has_flag(again + 3 * 1024 * 1024 - 1, "hg")}, INT,
+                      "Recommitted steps should be advised");
+
+   Memory.Arena.dispose(arena);
+}
+
+// test contains/reset on a page chain arena
+void test_arena_contains_reset(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   char *a = Arena.alloc(arena, 3000, false);
+   char *b = Arena.alloc(arena, 3000, false);
+   Assert.isTrue(Arena.contains(arena, a) && Arena.contains(arena, b), "Arena should contain both allocations");
+   Assert.isFalse(Arena.contains(arena, a + 3000), "Unused page tail should not be contained");
+
+   Arena.reset(arena);
+   usize total = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){0}, &total, LONG, "Reset should clear the total");
+   Assert.isFalse(Arena.is_tracking(arena, a), "Reset should drop tracking");
+   Assert.isTrue(Arena.alloc(arena, 3000, false) == a, "Reset should reuse the first page");
+   usize pages = Arena.get_page_count(arena);
+   Assert.areEqual(&(usize){2}, &pages, LONG, "Reset should keep pages for reuse");
+   Memory.Arena.dispose(arena);
+}
+
+// test promoting frame allocations to the parent scope
+void test_arena_frame_promotion(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   char *parent = Arena.alloc(arena, 100, false);
+
+   frame outer = Arena.begin_frame(arena);
+   char *first = Arena.alloc(arena, 64, false);
+   Arena.alloc(arena, 3000, false);
+   char *result = Arena.alloc(arena, 3000, false); // Starts a new page
+   char *temp = Arena.alloc(arena, 16, false);
+
+   Assert.areEqual(&(int){OK}, &(int){Arena.promote(outer, result)}, INT, "Promoting a frame allocation should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.promote(outer, first)}, INT, "Earlier allocations are already promoted");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.promote(outer, parent)}, INT, "Parent allocations cannot be promoted");
+
+   frame inner = Arena.begin_frame(arena);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.promote(outer, temp)}, INT, "Only the innermost frame can promote");
+   Arena.end_frame(inner);
+
+   Arena.end_frame(outer);
+   usize used = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){100 + 64 + 3000 + 3000}, &used, LONG, "Promoted range should survive the frame");
+   Assert.isTrue(Arena.is_tracking(arena, result), "Promoted object should stay tracked");
+   Assert.isFalse(Arena.is_tracking(arena, temp), "Later allocations should be rolled back");
+   Assert.isTrue(Arena.alloc(arena, 16, false) == result + 3008, "Allocation should resume (aligned) after the promoted object");
+
+   frame all = Arena.begin_frame(arena);
+   Arena.alloc(arena, 10, false);
+   Arena.alloc(arena, 10, false);
+   Assert.areEqual(&(int){OK}, &(int){Arena.promote_all(all)}, INT, "Promoting everything should succeed");
+   Arena.alloc(arena, 20, false);
+   Arena.end_frame(all);
+   used = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){100 + 64 + 3000 + 3000 + 16 + 20}, &used, LONG, "Only allocations after promote_all should roll back");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.promote_all(all)}, INT, "Ended frame cannot promote");
+
+   Memory.Arena.dispose(arena);
+}
+
+// test collections created in a frame keep growing after promote_all and end_frame
+void test_arena_promoted_growth(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   frame f = Arena.begin_frame(arena);
+   Memory.Scope.push(Arena.get_frame_scope(f));
+   list lst = List.new(2, sizeof(object));
+   Memory.Scope.pop();
+   Assert.isNotNull(lst, "List in a frame should be created");
+   for (usize i = 0; i < 2; i++)
+      List.append(lst, (object)(i + 1));
+   Assert.areEqual(&(int){OK}, &(int){Arena.promote_all(f)}, INT, "Promoting the list should succeed");
+   Arena.end_frame(f);
+
+   // Growth reallocates through the allocator captured in the frame
+   for (usize i = 2; i < 200; i++)
+      Assert.areEqual(&(int){OK}, &(int){List.append(lst, (object)(i + 1))}, INT, "Promoted list should grow (%zu)", i);
+   Assert.isTrue(List.capacity(lst) >= 200, "Promoted list should have grown");
+
+   // Later frames reuse the slot without taking the list's memory with them
+   for (int round = 0; round < 50; round++) {
+      frame later = Arena.begin_frame(arena);
+      Arena.alloc(arena, 256, false);
+      Arena.end_frame(later);
+   }
+   object value = NULL;
+   List.get(lst, 199, &value);
+   Assert.isTrue(value == (object)200, "Promoted list contents should survive later frames");
+   List.get(lst, 0, &value);
+   Assert.isTrue(value == (object)1, "Promoted list should keep its first element");
+
+   Memory.Arena.dispose(arena);
+}
+
+// Counts buffers released by merged arenas
+static int merge_releases = 0;
+
+static void merge_release(object ptr, usize size) {
+   (void)size;
+   merge_releases++;
+   free(ptr);
+}
+
+// test splicing a child arena into its parent
+void test_arena_merge(void) {
+   merge_releases = 0;
+   sc_arena *parent = Memory.Arena.create(1);
+   Arena.alloc(parent, 100, false);
+
+   // Build a result graph in a temporary arena
+   sc_arena *child = Memory.Arena.create(1);
+   Memory.Scope.push(child);
+   list results = List.new(2, sizeof(addr));
+   for (usize i = 0; i < 4; i++) {
+      List.append(results, (object)(i + 1));
+   }
+   Memory.Scope.pop();
+   char *big = Arena.alloc(child, 3000, false);
+   Memory.Scope.adopt(child, malloc(32), 32, merge_release);
+   usize expected = Arena.get_total_allocated(parent) + Arena.get_total_allocated(child);
+
+   Assert.areEqual(&(int){OK}, &(int){Arena.merge(parent, child)}, INT, "Merge should succeed");
+   usize used = Arena.get_total_allocated(parent);
+   Assert.areEqual(&expected, &used, LONG, "Parent should account for the child's bytes");
+   Assert.isTrue(Arena.contains(parent, big) && Arena.is_tracking(parent, big), "Parent should own the child's allocations");
+   Assert.isNull(Arena.alloc(child, 16, false), "Merged child handle should be invalid");
+
+   // Collections built in the child keep growing through the forwarded allocator
+   for (usize i = 4; i < 16; i++) {
+      List.append(results, (object)(i + 1));
+   }
+   object last = NULL;
+   List.get(results, 15, &last);
+   Assert.areEqual(&(addr){16}, &(addr){(addr)last}, LONG, "Child list should keep working after the merge");
+
+   // Merged arenas can be merged again
+   sc_arena *root = Memory.Arena.create(1);
+   Assert.areEqual(&(int){OK}, &(int){Arena.merge(root, parent)}, INT, "Second merge should succeed");
+   List.append(results, (object)17);
+   usize count = List.size(results);
+   Assert.areEqual(&(usize){17}, &count, LONG, "Forwarding should follow repeated merges");
+
+   Assert.areEqual(&(int){ERR}, &(int){Arena.merge(root, root)}, INT, "Self merge should fail");
+   sc_arena *reserved = Memory.Arena.create_ex(&(arena_opts){.reserve = 1024 * 1024});
+   Assert.areEqual(&(int){ERR}, &(int){Arena.merge(root, reserved)}, INT, "Reserved arenas cannot be merged");
+   sc_arena *framed = Memory.Arena.create(1);
+   frame open = Arena.begin_frame(framed);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.merge(root, framed)}, INT, "Child with open frames cannot be merged");
+   Arena.end_frame(open);
+   Memory.Arena.dispose(framed);
+   Memory.Arena.dispose(reserved);
+
+   Memory.Arena.dispose(child); // No-op: owned by root
+   Assert.areEqual(&(int){0}, &merge_releases, INT, "Adopted buffer should live until the owner ends");
+   Memory.Arena.dispose(root);
+   Assert.areEqual(&(int){1}, &merge_releases, INT, "Disposing the owner should release adopted buffers");
+}
+
+// test resizing the most recent allocation in place
+void test_arena_realloc(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   char *block = Arena.alloc(arena, 100, false);
+   memset(block, 'x', 100);
+
+   Assert.isTrue(Arena.realloc(arena, block, 100, 200) == block, "Top allocation should grow in place");
+   usize used = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){200}, &used, LONG, "Growing in place should extend the usage");
+   Assert.isTrue(Arena.realloc(arena, block, 200, 50) == block, "Top allocation should shrink in place");
+   used = Arena.get_total_allocated(arena);
+   Assert.areEqual(&(usize){50}, &used, LONG, "Shrinking in place should return the bytes");
+   Assert.isTrue(Arena.alloc(arena, 10, false) == block + 64, "Next allocation should follow the shrunk block, aligned");
+
+   // Anything but the top allocation is copied
+   char *moved = Arena.realloc(arena, block, 50, 80);
+   Assert.isTrue(moved != block && moved[49] == 'x', "Older allocation should be copied");
+
+   // A frame begun after the block protects it from in-place growth
+   frame outer = Arena.begin_frame(arena);
+   Assert.isTrue(Arena.realloc(arena, moved, 80, 120) != moved, "Block below a frame marker should be copied");
+   Arena.end_frame(outer);
+   Assert.isNull(Arena.realloc(arena, moved, 80, 8192), "Resizing past the page limit should fail");
+   Memory.Arena.dispose(arena);
+
+   // Builders in an arena grow without abandoning their buffers
+   sc_arena *text = Memory.Arena.create(1);
+   string_builder sb = StringBuilder.new_with(16, Arena.allocator(text));
+   for (int i = 0; i < 100; i++) {
+      StringBuilder.append(sb, "0123456789");
+   }
+   usize length = StringBuilder.length(sb);
+   Assert.areEqual(&(usize){1000}, &length, LONG, "Builder should hold every append");
+   used = Arena.get_total_allocated(text);
+   Assert.isTrue(used < 2048, "Builder growth should reuse its buffer in place (used %zu)", used);
+   Memory.Arena.dispose(text);
+}
+
+// root object of the image test
+typedef struct {
+   list names;
+   farray numbers;
+   slotarray tags;
+   string title;
+   uintptr_t cookie; // Integer that looks like a pointer into the arena
+} image_root;
+
+static image_root *build_image(sc_arena *arena) {
+   Memory.Scope.push(arena);
+   image_root *root = Arena.alloc(arena, sizeof(image_root), true);
+   root->title = String.dupe("lookup");
+   root->names = List.new(2, sizeof(addr));
+   static const char *names[] = {"alpha", "beta", "gamma", "delta", "epsilon"};
+   for (int i = 0; i < 5; i++) {
+      List.append(root->names, String.dupe(names[i]));
+   }
+   root->numbers = FArray.new(16, sizeof(int));
+   for (int i = 0; i < 16; i++) {
+      FArray.set(root->numbers, i, sizeof(int), &(int){i * 3});
+   }
+   root->tags = SlotArray.new(4);
+   SlotArray.add(root->tags, String.dupe("red"));
+   SlotArray.add(root->tags, String.dupe("green"));
+   SlotArray.add(root->tags, String.dupe("blue"));
+   SlotArray.remove_at(root->tags, 1); // An empty slot is saved as empty
+   root->cookie = (uintptr_t)root->numbers;
+   Memory.Scope.pop();
+
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin(arena, &root->title)}, INT, "Pinning the title should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin(arena, &root->names)}, INT, "Pinning the list field should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin(arena, &root->numbers)}, INT, "Pinning the farray field should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin_list(arena, root->names, true)}, INT, "Pinning the list should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin_farray(arena, root->numbers)}, INT, "Pinning the farray should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin(arena, &root->tags)}, INT, "Pinning the slotarray field should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin_slotarray(arena, root->tags, true)}, INT, "Pinning the slotarray should succeed");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.pin_slotarray(arena, NULL, true)}, INT, "NULL slotarray should not be pinned");
+   return root;
+}
+
+static void check_image(sc_arena *loaded, image_root *root, uintptr_t cookie, const char *label) {
+   Assert.isNotNull(root, "%s: root should be returned", label);
+   Assert.isTrue(Arena.contains(loaded, root), "%s: root should be inside the image", label);
+   Assert.isTrue(root->cookie == cookie, "%s: unpinned data should be saved byte for byte", label);
+   Assert.areEqual(&(int){0}, &(int){String.compare(root->title, "lookup")}, INT, "%s: title should survive", label);
+   usize count = List.size(root->names);
+   Assert.areEqual(&(usize){5}, &count, LONG, "%s: list size should survive", label);
+   object name = NULL;
+   List.get(root->names, 4, &name);
+   Assert.areEqual(&(int){0}, &(int){String.compare(name, "epsilon")}, INT, "%s: list strings should survive", label);
+   int number = 0;
+   FArray.get(root->numbers, 15, sizeof(int), &number);
+   Assert.areEqual(&(int){45}, &number, INT, "%s: farray values should survive", label);
+   object tag = NULL;
+   SlotArray.get_at(root->tags, 2, &tag);
+   Assert.areEqual(&(int){0}, &(int){String.compare(tag, "blue")}, INT, "%s: slotarray strings should survive", label);
+   Assert.isTrue(Arena.contains(loaded, root->tags) && Arena.contains(loaded, tag), "%s: slotarray should point into the image", label);
+   Assert.isTrue(SlotArray.is_empty_slot(root->tags, 1), "%s: empty slots should stay empty", label);
+   Assert.isNull(Arena.alloc(loaded, 16, false), "%s: loaded image should be read-only", label);
+   Assert.isNull(Arena.begin_frame(loaded).slot, "%s: loaded image should reject frames", label);
+}
+
+// copy an image, overwriting one 64-bit header field and optionally dropping the tail
+static bool corrupt_image(const char *from, const char *to, long field, uint64_t value, long truncate) {
+   FILE *in = fopen(from, "rb");
+   if (!in)
+      return false;
+   fseek(in, 0, SEEK_END);
+   long size = ftell(in);
+   fseek(in, 0, SEEK_SET);
+   char *bytes = malloc(size);
+   bool ok = bytes && fread(bytes, 1, size, in) == (usize)size;
+   fclose(in);
+   FILE *out = ok ? fopen(to, "wb") : NULL;
+   if (out) {
+      if (field >= 0)
+         memcpy(bytes + field, &value, sizeof(value));
+      ok = fwrite(bytes, 1, size - truncate, out) == (usize)(size - truncate);
+      fclose(out);
+   }
+   free(bytes);
+   return out && ok;
+}
+
+// test saving and loading arena images
+void test_arena_image(void) {
+   const char *path = "/tmp/sigcore_test_arena.img";
+   sc_arena *arena = Memory.Arena.create_ex(&(arena_opts){.reserve = 1024 * 1024});
+   image_root *root = build_image(arena);
+   uintptr_t cookie = root->cookie;
+   Assert.areEqual(&(int){OK}, &(int){Arena.save(arena, path, root)}, INT, "Saving a reserved arena should succeed");
+
+   // Original still mapped: the image must be relocated
+   object loaded_root = NULL;
+   sc_arena *relocated = Memory.Arena.load(path, &loaded_root);
+   Assert.isNotNull(relocated, "Loading the image should succeed");
+   Assert.isTrue(loaded_root != root, "Image should be relocated while the original is mapped");
+   check_image(relocated, loaded_root, cookie, "relocated");
+   Memory.Arena.dispose(relocated);
+
+   // Original gone: the image can map at its original base
+   Memory.Arena.dispose(arena);
+   sc_arena *in_place = Memory.Arena.load(path, &loaded_root);
+   Assert.isNotNull(in_place, "Loading the image again should succeed");
+   check_image(in_place, loaded_root, cookie, "in place");
+   Memory.Arena.dispose(in_place);
+
+   // Corrupt images are rejected before anything is mapped or patched
+   const char *bad = "/tmp/sigcore_test_arena_bad.img";
+   Assert.isTrue(corrupt_image(path, bad, -1, 0, 1), "Truncated copy should be written");
+   Assert.isNull(Memory.Arena.load(bad, NULL), "Truncated body should fail to load");
+   Assert.isTrue(corrupt_image(path, bad, 56, UINT64_MAX / 4, 0), "Copy with a huge relocation count should be written");
+   Assert.isNull(Memory.Arena.load(bad, NULL), "Relocation count past the file should fail to load");
+   Assert.isTrue(corrupt_image(path, bad, 48, UINT64_MAX - 1, 0), "Copy with a wild root should be written");
+   Assert.isNull(Memory.Arena.load(bad, NULL), "Root outside the image should fail to load");
+   Assert.isTrue(corrupt_image(path, bad, 64, 100, 0), "Copy with an unaligned body should be written");
+   Assert.isNull(Memory.Arena.load(bad, NULL), "Unaligned body offset should fail to load");
+   Assert.isTrue(corrupt_image(path, bad, 72, UINT64_MAX, 0), "Copy with a wild relocation should be written");
+   Assert.isNull(Memory.Arena.load(bad, NULL), "Relocation outside the image should fail to load");
+   remove(bad);
+
+   // Pins are only taken for reserved arenas, and die with the memory they point into
+   sc_arena *pinned = Memory.Arena.create_ex(&(arena_opts){.reserve = 1024 * 1024});
+   object *keep = Arena.alloc(pinned, sizeof(object), true);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.pin(pinned, (char *)keep + 1)}, INT, "Misaligned slot should not be pinned");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.pin(pinned, &cookie)}, INT, "Foreign slot should not be pinned");
+   frame scratch = Arena.begin_frame(pinned);
+   object *temp = Arena.alloc(pinned, sizeof(object), false);
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin(pinned, temp)}, INT, "Slot inside a frame should be pinned");
+   Arena.end_frame(scratch);
+   // The rolled-back slot is reused for plain data that must not be rebased
+   uintptr_t *data = Arena.alloc(pinned, sizeof(uintptr_t), false);
+   *data = (uintptr_t)keep;
+   *keep = data;
+   Assert.areEqual(&(int){OK}, &(int){Arena.pin(pinned, keep)}, INT, "Slot should be pinned");
+   Assert.areEqual(&(int){OK}, &(int){Arena.save(pinned, path, keep)}, INT, "Saving with pins should succeed");
+   sc_arena *reloaded = Memory.Arena.load(path, &loaded_root);
+   Assert.isNotNull(reloaded, "Loading the pinned image should succeed");
+   object *loaded_keep = loaded_root;
+   Assert.isTrue(Arena.contains(reloaded, *loaded_keep), "Pinned slot should be relocated");
+   Assert.isTrue(*(uintptr_t *)*loaded_keep == (uintptr_t)keep, "Rolled-back pin should not touch reused memory");
+   Memory.Arena.dispose(reloaded);
+   Memory.Arena.dispose(pinned);
+
+   // Page chain arenas cannot be saved
+   sc_arena *chained = Memory.Arena.create(1);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.pin(chained, Arena.alloc(chained, sizeof(object), true))}, INT, "Page chain arena should not take pins");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.save(chained, path, NULL)}, INT, "Page chain arena save should fail");
+   Memory.Arena.dispose(chained);
+   Assert.isNull(Memory.Arena.load("/tmp/sigcore_missing.img", NULL), "Missing image should fail to load");
+   remove(path);
+}
+
+// test page cache recycling of arena pages
+void test_arena_page_cache(void) {
+   Memory.Cache.trim();
+   page_cache_stats before;
+   Memory.Cache.stats(&before);
+   Assert.areEqual(&(usize){0}, &before.global_bytes, LONG, "Trimmed cache should hold no global bytes");
+
+   sc_arena *first = Memory.Arena.create(4);
+   Assert.isNotNull(first, "Arena setup should succeed");
+   Memory.Arena.dispose(first);
+
+   page_cache_stats released;
+   Memory.Cache.stats(&released);
+   Assert.isTrue(released.releases >= before.releases + 4, "Disposing an arena should release its pages to the cache");
+   Assert.isTrue(released.thread_bytes > 0, "Released pages should be held by the thread cache");
+
+   sc_arena *second = Memory.Arena.create(4);
+   Assert.isNotNull(second, "Arena re-creation should succeed");
+   page_cache_stats reused;
+   Memory.Cache.stats(&reused);
+   Assert.isTrue(reused.hits >= released.hits + 4, "Re-created arena should take its pages from the cache");
+   Assert.isNotNull(Arena.alloc(second, 128, true), "Recycled pages should be usable");
+   Memory.Arena.dispose(second);
+
+   // A zero limit sends released pages straight back to the system
+   Memory.Cache.trim();
+   Memory.Cache.configure(0, 0);
+   sc_arena *uncached = Memory.Arena.create(2);
+   Memory.Arena.dispose(uncached);
+   page_cache_stats evicted;
+   Memory.Cache.stats(&evicted);
+   Assert.isTrue(evicted.evictions >= reused.evictions + 2, "Pages over the cache limit should be evicted");
+   Assert.areEqual(&(usize){0}, &evicted.thread_bytes, LONG, "Zero-limit cache should hold nothing");
+   Memory.Cache.configure(4 * 1024 * 1024, 256 * 1024);
+}
+
+// test NUMA binding and placement (single-node machines bind to node 0 or stay unbound)
+void test_arena_numa_placement(void) {
+   usize per_node[64];
+   arena_stats stats;
+
+   // Heap pages bound to the creating thread's node
+   sc_arena *local = Memory.Arena.create_ex(&(arena_opts){.initial_pages = 1, .page_size = 16 * 1024, .numa_bind = true, .numa_node = NUMA_NODE_LOCAL});
+   Assert.isNotNull(local, "Arena with NUMA binding should be created even without NUMA support");
+   char *data = Arena.alloc(local, 16 * 1024, true);
+   Assert.isNotNull(data, "Allocation from a bound arena should succeed");
+   Arena.stats(local, &stats);
+   Assert.isTrue(stats.numa_node >= -1 && stats.numa_node < 64, "Bound node should be a real node or -1");
+
+   usize found = Arena.placement(local, per_node, 64);
+   usize sum = 0;
+   for (usize i = 0; i < 64; i++)
+      sum += per_node[i];
+   Assert.isTrue(found == 0 || found >= 4, "Touched page data should be resident (%zu pages)", found);
+   Assert.areEqual(&found, &sum, LONG, "Per-node counts should add up to the resident pages");
+   if (stats.numa_node >= 0 && found)
+      Assert.areEqual(&found, &per_node[stats.numa_node], LONG, "All resident pages should be on the bound node");
+   Memory.Arena.dispose(local);
+
+   // An unknown node degrades to an unbound arena that still works
+   sc_arena *bogus = Memory.Arena.create_ex(&(arena_opts){.initial_pages = 1, .numa_bind = true, .numa_node = 4000});
+   Assert.isNotNull(bogus, "Arena with an unavailable node should still be created");
+   Arena.stats(bogus, &stats);
+   Assert.areEqual(&(int){-1}, &stats.numa_node, INT, "Unavailable node should leave the arena unbound");
+   Assert.isNotNull(Arena.alloc(bogus, 64, true), "Unbound arena should allocate");
+   Memory.Arena.dispose(bogus);
+
+   // Reserved arenas rebind each committed step
+   sc_arena *reserved = Memory.Arena.create_ex(&(arena_opts){.reserve = 1024 * 1024, .numa_bind = true, .numa_node = NUMA_NODE_LOCAL});
+   Assert.isNotNull(reserved, "Reserved arena with NUMA binding should be created");
+   Assert.isNotNull(Arena.alloc(reserved, 200 * 1024, true), "Allocation across commit steps should succeed");
+   Arena.stats(reserved, &stats);
+   found = Arena.placement(reserved, per_node, 64);
+   if (stats.numa_node >= 0 && found)
+      Assert.areEqual(&found, &per_node[stats.numa_node], LONG, "Committed pages should be on the bound node");
+   Memory.Arena.dispose(reserved);
+
+   // Pools take the same options
+   pool bound_pool = Memory.Pool.create_ex(&(pool_opts){.initial_pages = 2, .numa_bind = true, .numa_node = NUMA_NODE_LOCAL});
+   Assert.isNotNull(bound_pool, "Pool with NUMA binding should be created");
+   found = Memory.Pool.placement(bound_pool, per_node, 64);
+   Assert.isTrue(found == 0 || found == 2, "Both zeroed pool pages should be resident (%zu)", found);
+   Memory.Pool.dispose(bound_pool);
+   Assert.isNull(Memory.Pool.create_ex(&(pool_opts){0}), "Pool without pages should be rejected");
+}
+
+// soft budget callback: remember the last crossing
+static usize arena_budget_crossed = 0;
+static void arena_budget_on_soft(void *scope, usize reserved, usize soft_limit) {
+   (void)scope;
+   (void)soft_limit;
+   arena_budget_crossed = reserved;
+}
+
+// test hard and soft byte budgets
+void test_arena_budgets(void) {
+   sc_arena *bounded = Memory.Arena.create_ex(&(arena_opts){.initial_pages = 1, .page_size = 4096});
+   Assert.isNotNull(bounded, "Arena creation");
+   arena_budget_crossed = 0;
+   scope_budget budget = {.soft = 8192, .hard = 12288, .on_soft = arena_budget_on_soft};
+   Assert.areEqual(&(int){OK}, &(int){Arena.set_budget(bounded, &budget)}, INT, "Set arena budget");
+
+   Assert.isNotNull(Arena.alloc(bounded, 4000, false), "First page is already reserved");
+   Assert.isNotNull(Arena.alloc(bounded, 4000, false), "Second page reaches the soft budget");
+   Assert.areEqual(&(usize){0}, &arena_budget_crossed, LONG, "Reaching the soft budget is not crossing it");
+   Assert.isNotNull(Arena.alloc(bounded, 4000, false), "Third page crosses the soft budget");
+   Assert.areEqual(&(usize){12288}, &arena_budget_crossed, LONG, "on_soft should see the new reserved total");
+   Assert.isNull(Arena.alloc(bounded, 4000, false), "Fourth page should fail the hard budget");
+   Assert.isNotNull(Arena.alloc(bounded, 64, false), "Allocations within reserved pages still succeed");
+   Assert.areEqual(&(usize){3}, &(usize){Arena.get_page_count(bounded)}, LONG, "Refused growth should not add a page");
+
+   Arena.set_budget(bounded, NULL);
+   Assert.isNotNull(Arena.alloc(bounded, 4000, false), "Clearing the budget should allow growth");
+   Memory.Arena.dispose(bounded);
+
+   // Reserved arenas count committed bytes
+   sc_arena *reserved = Memory.Arena.create_ex(&(arena_opts){.reserve = 1024 * 1024, .page_size = 64 * 1024});
+   Assert.isNotNull(reserved, "Reserved arena creation");
+   Arena.set_budget(reserved, &(scope_budget){.hard = 128 * 1024});
+   Assert.isNotNull(Arena.alloc(reserved, 100 * 1024, false), "Commit within the hard budget");
+   Assert.isNull(Arena.alloc(reserved, 100 * 1024, false), "Commit past the hard budget should fail");
+   Memory.Arena.dispose(reserved);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.set_budget(NULL, &budget)}, INT, "NULL arena should be rejected");
+}
+
+// test copy-on-write fork, commit and discard
+void test_arena_fork(void) {
+   sc_arena *plain = Memory.Arena.create_ex(&(arena_opts){.reserve = 1024 * 1024});
+   Assert.areEqual(&(int){ERR}, &(int){Arena.fork(plain)}, INT, "Only forkable arenas can fork");
+   Memory.Arena.dispose(plain);
+
+   sc_arena *arena = Memory.Arena.create_ex(&(arena_opts){.reserve = 16 * 1024 * 1024, .forkable = true});
+   Assert.isNotNull(arena, "Forkable arena creation should succeed");
+   int *values = Arena.alloc(arena, 256 * 1024 * sizeof(int), true);
+   for (int i = 0; i < 256 * 1024; i++)
+      values[i] = i;
+   Arena.track(arena, values);
+   arena_stats before;
+   Arena.stats(arena, &before);
+
+   // Discard: in-place changes, new allocations and adopted buffers are undone
+   Assert.areEqual(&(int){OK}, &(int){Arena.fork(arena)}, INT, "Fork should succeed");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.fork(arena)}, INT, "A fork cannot be nested");
+   values[0] = -1;
+   values[200 * 1024] = -2;
+   int *extra = Arena.alloc(arena, 2 * 1024 * 1024, false);
+   Assert.isNotNull(extra, "Allocation inside a fork should succeed");
+   extra[0] = 7;
+   merge_releases = 0;
+   Memory.Scope.adopt(arena, malloc(32), 32, merge_release);
+   frame f = Arena.begin_frame(arena);
+   Assert.isNotNull(f.slot, "Frames can be used inside a fork");
+   Assert.areEqual(&(int){OK}, &(int){Arena.discard(arena)}, INT, "Discard should succeed");
+
+   arena_stats after;
+   Arena.stats(arena, &after);
+   Assert.areEqual(&(int){0}, &values[0], INT, "Discard should restore modified data");
+   Assert.areEqual(&(int){200 * 1024}, &values[200 * 1024], INT, "Discard should restore every touched page");
+   Assert.areEqual(&before.used, &after.used, LONG, "Discard should restore used");
+   Assert.areEqual(&before.reserved, &after.reserved, LONG, "Discard should restore reserved");
+   Assert.areEqual(&before.tracked_blocks, &after.tracked_blocks, LONG, "Discard should drop fork tracking");
+   Assert.areEqual(&(usize){0}, &after.frame_depth, LONG, "Discard should close frames opened in the fork");
+   Assert.areEqual(&(int){1}, &merge_releases, INT, "Discard should release buffers adopted in the fork");
+   Assert.isTrue(Arena.is_tracking(arena, values), "Tracking from before the fork should survive");
+   Assert.isTrue(Arena.alloc(arena, 16, false) == (object)extra, "Allocation should resume at the fork point");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.discard(arena)}, INT, "Discard without a fork should fail");
+
+   // Commit: changes persist, including allocations made in the fork
+   Assert.areEqual(&(int){OK}, &(int){Arena.fork(arena)}, INT, "Fork after discard should succeed");
+   values[1] = -3;
+   int *kept = Arena.alloc(arena, 1024, false);
+   kept[0] = 99;
+   Assert.areEqual(&(int){OK}, &(int){Arena.commit(arena)}, INT, "Commit should succeed");
+   Assert.areEqual(&(int){-3}, &values[1], INT, "Committed change should persist");
+   Assert.areEqual(&(int){99}, &kept[0], INT, "Committed allocation should persist");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.commit(arena)}, INT, "Commit without a fork should fail");
+
+   // The committed state is the base of the next fork
+   Arena.fork(arena);
+   values[1] = 5;
+   Arena.discard(arena);
+   Assert.areEqual(&(int){-3}, &values[1], INT, "Discard should return to the committed state");
+   Assert.isTrue(Arena.contains(arena, kept), "Committed allocations should survive a later discard");
+
+   // A block from before the fork is copied rather than resized in place, so discard restores it
+   Arena.stats(arena, &before);
+   Arena.fork(arena);
+   int *grown = Arena.realloc(arena, kept, 1024, 4096);
+   Assert.isTrue(grown && grown != kept && grown[0] == 99, "Pre-fork block should be copied, not grown in place");
+   Arena.discard(arena);
+   Arena.stats(arena, &after);
+   Assert.areEqual(&before.used, &after.used, LONG, "Discard should restore used after a realloc");
+   Assert.areEqual(&before.tracked_blocks, &after.tracked_blocks, LONG, "Discard should restore tracking after a realloc");
+   Assert.isTrue(Arena.realloc(arena, kept, 1024, 2048) == kept, "Restored block should grow in place again");
+
+   // Reset ends an open fork
+   Arena.fork(arena);
+   Arena.reset(arena);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.discard(arena)}, INT, "Reset should end the fork");
+   Assert.areEqual(&(usize){0}, &(usize){Arena.get_total_allocated(arena)}, LONG, "Reset should empty the arena");
+   Memory.Arena.dispose(arena);
+}
+
+// Records the order deferred calls run in
+static int defer_log[8];
+static int defer_count = 0;
+
+static void defer_record(object arg) {
+   defer_log[defer_count++] = *(int *)arg;
+}
+
+static void defer_release(object ptr, usize size) {
+   (void)size;
+   defer_log[defer_count++] = 0;
+   free(ptr);
+}
+
+// test frame-end deferred calls
+void test_arena_defer(void) {
+   sc_arena *arena = Memory.Arena.create(1);
+   static int ids[] = {1, 2, 3, 4};
+
+   // Deferred calls and adopted buffers run together, most recent first
+   frame outer = Arena.begin_frame(arena);
+   Assert.areEqual(&(int){OK}, &(int){Arena.defer(outer, defer_record, &ids[0])}, INT, "Defer should succeed");
+   Memory.Scope.adopt(Arena.get_frame_scope(outer), malloc(16), 16, defer_release);
+   Arena.defer(outer, defer_record, &ids[1]);
+   frame inner = Arena.begin_frame(arena);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.defer(outer, defer_record, &ids[3])}, INT, "Only the innermost frame can defer");
+   Arena.defer(inner, defer_record, &ids[2]);
+
+   defer_count = 0;
+   Arena.end_frame(inner);
+   Assert.areEqual(&(int){1}, &defer_count, INT, "Ending the inner frame should run its call only");
+   Assert.areEqual(&(int){3}, &defer_log[0], INT, "Inner frame call should run");
+   Arena.end_frame(outer);
+   Assert.areEqual(&(int){4}, &defer_count, INT, "Ending the outer frame should run the rest");
+   Assert.areEqual(&(int){2}, &defer_log[1], INT, "Calls should run in LIFO order");
+   Assert.areEqual(&(int){0}, &defer_log[2], INT, "Adopted buffers should run in the same pass");
+   Assert.areEqual(&(int){1}, &defer_log[3], INT, "First registered call should run last");
+   Assert.areEqual(&(usize){0}, &(usize){Arena.get_total_allocated(arena)}, LONG, "Deferred entries should roll back with the frame");
+
+   // Promoted calls outlive the frame and run on reset
+   frame kept = Arena.begin_frame(arena);
+   Arena.defer(kept, defer_record, &ids[3]);
+   Arena.promote_all(kept);
+   defer_count = 0;
+   Arena.end_frame(kept);
+   Assert.areEqual(&(int){0}, &defer_count, INT, "Promoted calls should not run at frame end");
+   Arena.reset(arena);
+   Assert.areEqual(&(int){1}, &defer_count, INT, "Reset should run pending calls");
+   Assert.areEqual(&(int){4}, &defer_log[0], INT, "Reset should run the promoted call");
+
+   // Frames still open when the arena is disposed run their calls too
+   frame open = Arena.begin_frame(arena);
+   Arena.defer(open, defer_record, &ids[0]);
+   Assert.areEqual(&(int){ERR}, &(int){Arena.defer(open, NULL, NULL)}, INT, "NULL function should be rejected");
+   Assert.areEqual(&(int){ERR}, &(int){Arena.defer((frame){0}, defer_record, NULL)}, INT, "NULL frame should be rejected");
+   defer_count = 0;
+   Memory.Arena.dispose(arena);
+   Assert.areEqual(&(int){1}, &defer_count, INT, "Dispose should run pending calls");
+}
+
 //  register test cases
 __attribute__((constructor)) void init_arena_tests(void) {
    testset("core_arena_set", set_config, set_teardown);
@@ -549,5 +1487,24 @@ __attribute__((constructor)) void init_arena_tests(void) {
    testcase("Frame nested frames", test_frame_nested);
    testcase("Frame with page growth", test_frame_page_growth);
    testcase("Frame edge cases", test_frame_edge_cases);
+   testcase("Frame stale handles", test_frame_stale_handles);
    testcase("Frame early exit handling", test_frame_early_exit);
+   testcase("Frame inline stack depth", test_frame_inline_stack);
+   testcase("Frame page reuse", test_frame_page_reuse);
+   testcase("Frame rollback after a skipped page", test_frame_skip_rollback);
+   testcase("Arena page cache recycling", test_arena_page_cache);
+   testcase("Arena geometric page growth", test_arena_geometric_growth);
+   testcase("Arena usage statistics", test_arena_stats);
+   testcase("Reserved virtual memory arena", test_arena_reserved);
+   testcase("Reserved arena huge page advice", test_arena_huge_pages);
+   testcase("Arena contains and reset", test_arena_contains_reset);
+   testcase("Arena image save and load", test_arena_image);
+   testcase("Frame promotion", test_arena_frame_promotion);
+   testcase("Frame promotion of growing collections", test_arena_promoted_growth);
+   testcase("Arena merge", test_arena_merge);
+   testcase("Arena in-place realloc", test_arena_realloc);
+   testcase("NUMA binding and placement", test_arena_numa_placement);
+   testcase("Arena budgets", test_arena_budgets);
+   testcase("Arena fork commit and discard", test_arena_fork);
+   testcase("Frame deferred calls", test_arena_defer);
 }
\ No newline at end of file
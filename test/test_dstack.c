@@ -0,0 +1,122 @@
+/*
+ *  Test File: test_dstack.c
+ *  Description: Test cases for the SigmaCore double-ended stack allocator
+ */
+
+#include "sigcore/dstack.h"
+#include "sigcore/list.h"
+#include "sigcore/memory.h"
+#include <sigtest/sigtest.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static void set_config(FILE **log_stream) {
+   *log_stream = fopen("logs/test_dstack.log", "w");
+}
+
+static void set_teardown(void) {
+   // No hooks to reset
+}
+
+// test allocating from both ends
+void test_dstack_ends(void) {
+   dstack ds = DStack.create(64 * 1024);
+   Assert.isNotNull(ds, "DStack creation should succeed");
+
+   char *low = DStack.alloc(ds, DSTACK_BOTTOM, 100, false);
+   char *high = DStack.alloc(ds, DSTACK_TOP, 100, true);
+   Assert.isTrue(low != NULL && high != NULL, "Both ends should allocate");
+   Assert.isTrue(low < high, "Bottom allocations should lie below top allocations");
+   Assert.isTrue((uintptr_t)low % sizeof(double) == 0 && (uintptr_t)high % sizeof(double) == 0,
+                 "Allocations should be aligned");
+   Assert.areEqual(&(char){0}, &high[99], CHAR, "Zeroed allocation should be cleared");
+
+   char *next_low = DStack.alloc(ds, DSTACK_BOTTOM, 16, false);
+   char *next_high = DStack.alloc(ds, DSTACK_TOP, 16, false);
+   Assert.isTrue(next_low > low && next_high < high, "Each end should grow toward the middle");
+
+   memset(low, 'a', 100);
+   memset(high, 'b', 100);
+   Assert.isTrue(low[99] == 'a' && high[0] == 'b', "Ends should not overlap");
+   Assert.isNull(DStack.alloc(ds, DSTACK_TOP, 0, false), "Zero-size allocation should fail");
+   DStack.dispose(ds);
+}
+
+// test popping each end back to a marker
+void test_dstack_markers(void) {
+   dstack ds = DStack.create(64 * 1024);
+   DStack.alloc(ds, DSTACK_BOTTOM, 256, false);
+   usize before = DStack.remaining(ds);
+
+   dstack_marker top_mark = DStack.mark(ds, DSTACK_TOP);
+   char *scratch = DStack.alloc(ds, DSTACK_TOP, 1000, false);
+   DStack.alloc(ds, DSTACK_TOP, 1000, false);
+   Assert.areEqual(&(int){OK}, &(int){DStack.pop(ds, DSTACK_TOP, top_mark)}, INT, "Pop to marker should succeed");
+   usize after = DStack.remaining(ds);
+   Assert.areEqual(&before, &after, LONG, "Pop should release the top allocations");
+   Assert.isTrue(DStack.alloc(ds, DSTACK_TOP, 1000, false) == scratch, "Top space should be reused after pop");
+
+   dstack_marker bottom_mark = DStack.mark(ds, DSTACK_BOTTOM);
+   char *persistent = DStack.alloc(ds, DSTACK_BOTTOM, 64, false);
+   Assert.areEqual(&(int){OK}, &(int){DStack.pop(ds, DSTACK_BOTTOM, bottom_mark)}, INT, "Bottom pop should succeed");
+   Assert.isTrue(DStack.alloc(ds, DSTACK_BOTTOM, 64, false) == persistent, "Bottom space should be reused after pop");
+
+   // A marker past the end's current position is stale
+   dstack_marker stale = DStack.mark(ds, DSTACK_BOTTOM) + 64;
+   Assert.areEqual(&(int){ERR}, &(int){DStack.pop(ds, DSTACK_BOTTOM, stale)}, INT, "Stale bottom marker should fail");
+   Assert.areEqual(&(int){ERR}, &(int){DStack.pop(ds, DSTACK_TOP, 0)}, INT, "Top marker below the top should fail");
+
+   DStack.reset(ds, DSTACK_TOP);
+   DStack.reset(ds, DSTACK_BOTTOM);
+   usize empty = DStack.remaining(ds);
+   Assert.isTrue(empty >= 64 * 1024, "Reset should release both ends");
+   DStack.dispose(ds);
+}
+
+// test filling the region from both ends across commit steps
+void test_dstack_exhaustion(void) {
+   dstack ds = DStack.create(256 * 1024);
+   usize count = 0;
+   for (;;) {
+      char *low = DStack.alloc(ds, DSTACK_BOTTOM, 4000, false);
+      char *high = DStack.alloc(ds, DSTACK_TOP, 4000, false);
+      if (low)
+         memset(low, 1, 4000);
+      if (high)
+         memset(high, 2, 4000);
+      if (!low && !high)
+         break;
+      count++;
+   }
+   Assert.isTrue(count >= 30, "Both ends should share the whole region (%zu rounds)", count);
+   usize left = DStack.remaining(ds);
+   Assert.isTrue(left < 4000 + 2 * 16, "Region should be nearly full when the ends meet");
+   DStack.dispose(ds);
+}
+
+// test collections living on one end
+void test_dstack_allocator(void) {
+   dstack ds = DStack.create(64 * 1024);
+   list lst = List.new_with(2, sizeof(addr), DStack.allocator(ds, DSTACK_BOTTOM));
+   for (usize i = 0; i < 64; i++) {
+      List.append(lst, (object)(i + 1));
+   }
+   usize size = List.size(lst);
+   Assert.areEqual(&(usize){64}, &size, LONG, "List should grow on the bottom end");
+   object last = NULL;
+   List.get(lst, 63, &last);
+   Assert.areEqual(&(addr){64}, &(addr){(addr)last}, LONG, "List contents should survive growth");
+   Assert.isNull(DStack.allocator(NULL, DSTACK_TOP), "NULL dstack should have no allocator");
+   DStack.dispose(ds);
+}
+
+//  register test cases
+__attribute__((constructor)) void init_dstack_tests(void) {
+   testset("core_dstack_set", set_config, set_teardown);
+
+   testcase("DStack allocation from both ends", test_dstack_ends);
+   testcase("DStack markers and pop", test_dstack_markers);
+   testcase("DStack exhaustion", test_dstack_exhaustion);
+   testcase("DStack allocator", test_dstack_allocator);
+}
@@ -0,0 +1,200 @@
+/*
+ *  Test File: test_epoch.c
+ *  Description: Test cases for SigmaCore epoch-based memory reclamation
+ */
+
+#include "sigcore/epoch.h"
+#include "sigcore/memory.h"
+#include <sigtest/sigtest.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#define NODE_LIVE 0x5EC0DE
+#define NODE_DEAD 0xDEAD
+
+// Node published to readers through a shared pointer
+struct epoch_test_node {
+   int magic;
+   int value;
+};
+
+static int releases = 0;
+
+static void set_config(FILE **log_stream) {
+   *log_stream = fopen("logs/test_epoch.log", "w");
+}
+
+static void set_teardown(void) {
+   // No hooks to reset
+}
+
+// Poison a node before freeing it, so readers that still hold it would notice
+static void node_release(object ptr, usize size) {
+   (void)size;
+   ((struct epoch_test_node *)ptr)->magic = NODE_DEAD;
+   free(ptr);
+   releases++;
+}
+
+// test that retired memory waits for read sections to end
+void test_epoch_deferred_release(void) {
+   epoch domain = Epoch.create();
+   Assert.isNotNull(domain, "Domain creation should succeed");
+
+   struct epoch_test_node *node = malloc(sizeof(*node));
+   node->magic = NODE_LIVE;
+   releases = 0;
+
+   Assert.areEqual(&(int){OK}, &(int){Epoch.enter(domain)}, INT, "Enter should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Epoch.enter(domain)}, INT, "Sections should nest");
+   Assert.areEqual(&(int){OK}, &(int){Epoch.retire(domain, node, sizeof(*node), node_release)}, INT, "Retire should succeed");
+   Assert.areEqual(&(usize){1}, &(usize){Epoch.pending(domain)}, LONG, "Retired object should be pending");
+   for (int i = 0; i < 4; i++)
+      Epoch.reclaim(domain);
+   Assert.areEqual(&(int){0}, &releases, INT, "Nothing should be released inside the section");
+   Assert.areEqual(&(usize){0}, &(usize){Epoch.synchronize(domain)}, LONG, "Synchronize inside a section should refuse");
+   Epoch.exit(domain);
+   for (int i = 0; i < 4; i++)
+      Epoch.reclaim(domain);
+   Assert.areEqual(&(int){0}, &releases, INT, "The outer section should still hold the node");
+   Epoch.exit(domain);
+
+   Assert.areEqual(&(usize){1}, &(usize){Epoch.synchronize(domain)}, LONG, "Synchronize should release the node");
+   Assert.areEqual(&(int){1}, &releases, INT, "Release should run once");
+   Assert.areEqual(&(usize){0}, &(usize){Epoch.pending(domain)}, LONG, "Nothing should remain pending");
+
+   // Default release is Memory.dispose; batches are reclaimed while retiring
+   for (int i = 0; i < 1000; i++)
+      Epoch.retire(domain, Memory.alloc(32, false), 32, NULL);
+   Assert.isTrue(Epoch.pending(domain) < 1000, "Retiring should reclaim older batches");
+   Epoch.synchronize(domain);
+   Assert.areEqual(&(usize){0}, &(usize){Epoch.pending(domain)}, LONG, "Synchronize should drain the thread's batches");
+
+   Assert.areEqual(&(int){ERR}, &(int){Epoch.enter(NULL)}, INT, "NULL domain should be rejected");
+   Assert.areEqual(&(int){ERR}, &(int){Epoch.retire(domain, NULL, 0, NULL)}, INT, "NULL object should be rejected");
+   Epoch.detach(domain);
+   Epoch.dispose(domain);
+}
+
+// Shared state for the reader/writer test
+static epoch shared_domain;
+static _Atomic(struct epoch_test_node *) shared_node;
+static atomic_bool readers_stop;
+static atomic_int reader_violations;
+static atomic_long reader_reads;
+
+static int epoch_reader(void *arg) {
+   (void)arg;
+   while (!atomic_load(&readers_stop)) {
+      Epoch.enter(shared_domain);
+      struct epoch_test_node *node = atomic_load(&shared_node);
+      for (int spin = 0; spin < 50; spin++) {
+         if (node->magic != NODE_LIVE)
+            atomic_fetch_add(&reader_violations, 1);
+      }
+      Epoch.exit(shared_domain);
+      atomic_fetch_add(&reader_reads, 1);
+   }
+   Epoch.detach(shared_domain);
+   return 0;
+}
+
+// test concurrent readers against a writer that retires what it replaces
+void test_epoch_concurrent_readers(void) {
+   shared_domain = Epoch.create();
+   struct epoch_test_node *first = malloc(sizeof(*first));
+   *first = (struct epoch_test_node){NODE_LIVE, 0};
+   atomic_store(&shared_node, first);
+   atomic_store(&readers_stop, false);
+   atomic_store(&reader_violations, 0);
+   atomic_store(&reader_reads, 0);
+   releases = 0;
+
+   thrd_t readers[3];
+   for (int i = 0; i < 3; i++)
+      thrd_create(&readers[i], epoch_reader, NULL);
+   while (atomic_load(&reader_reads) < 3)
+      thrd_yield();
+
+   for (int i = 1; i <= 5000; i++) {
+      struct epoch_test_node *next = malloc(sizeof(*next));
+      *next = (struct epoch_test_node){NODE_LIVE, i};
+      struct epoch_test_node *old = atomic_exchange(&shared_node, next);
+      Epoch.retire(shared_domain, old, sizeof(*old), node_release);
+   }
+
+   atomic_store(&readers_stop, true);
+   for (int i = 0; i < 3; i++)
+      thrd_join(readers[i], NULL);
+   Epoch.synchronize(shared_domain);
+
+   Assert.areEqual(&(int){0}, &(int){atomic_load(&reader_violations)}, INT, "Readers should never see released nodes");
+   Assert.isTrue(atomic_load(&reader_reads) > 0, "Readers should have run");
+   Assert.areEqual(&(int){5000}, &releases, INT, "Every replaced node should be released");
+   Assert.areEqual(&(usize){0}, &(usize){Epoch.pending(shared_domain)}, LONG, "Nothing should remain pending");
+
+   free(atomic_load(&shared_node));
+   Epoch.dispose(shared_domain);
+}
+
+// Retires a few nodes and exits inside a read section, without detaching
+static int epoch_abandoner(void *arg) {
+   (void)arg;
+   Epoch.enter(shared_domain);
+   for (int i = 0; i < 3; i++) {
+      struct epoch_test_node *node = malloc(sizeof(*node));
+      *node = (struct epoch_test_node){NODE_LIVE, i};
+      Epoch.retire(shared_domain, node, sizeof(*node), node_release);
+   }
+   return 0;
+}
+
+// Takes over a free record and drains what it holds
+static int epoch_adopter(void *arg) {
+   Epoch.enter(shared_domain);
+   Epoch.exit(shared_domain);
+   *(usize *)arg = Epoch.synchronize(shared_domain);
+   Epoch.detach(shared_domain);
+   return 0;
+}
+
+// test that a thread exiting without detaching neither stalls nor keeps its record
+void test_epoch_thread_exit(void) {
+   shared_domain = Epoch.create();
+   releases = 0;
+   Epoch.enter(shared_domain); // Register first so this thread keeps its own record
+   Epoch.exit(shared_domain);
+
+   thrd_t worker;
+   thrd_create(&worker, epoch_abandoner, NULL);
+   thrd_join(worker, NULL);
+   Assert.areEqual(&(usize){3}, &(usize){Epoch.pending(shared_domain)}, LONG, "Exited thread's retirements should be pending");
+
+   // The dead thread's read section must not hold the epoch back
+   struct epoch_test_node *node = malloc(sizeof(*node));
+   *node = (struct epoch_test_node){NODE_LIVE, 3};
+   Epoch.retire(shared_domain, node, sizeof(*node), node_release);
+   Assert.areEqual(&(usize){1}, &(usize){Epoch.synchronize(shared_domain)}, LONG, "Retirement should still be reclaimed");
+
+   // Its record is free again, so the next thread takes it over and releases its batches
+   usize adopted = 0;
+   thrd_create(&worker, epoch_adopter, &adopted);
+   thrd_join(worker, NULL);
+   Assert.areEqual(&(usize){3}, &adopted, LONG, "The next thread should release the exited thread's batches");
+   Assert.areEqual(&(int){4}, &releases, INT, "Every retired node should be released");
+   Assert.areEqual(&(usize){0}, &(usize){Epoch.pending(shared_domain)}, LONG, "Nothing should remain pending");
+
+   Epoch.detach(shared_domain);
+   Epoch.dispose(shared_domain);
+}
+
+//  register test cases
+__attribute__((constructor)) void init_epoch_tests(void) {
+   testset("core_epoch_set", set_config, set_teardown);
+
+   testcase("Retired memory outlives read sections", test_epoch_deferred_release);
+   testcase("Concurrent readers with a retiring writer", test_epoch_concurrent_readers);
+   testcase("Threads that exit without detaching", test_epoch_thread_exit);
+}
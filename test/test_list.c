@@ -472,6 +472,82 @@ static void test_list_append_null_value(void) {
    List.dispose(lst);
 }
 
+//  counting allocator backed by the root pool
+typedef struct {
+   int allocs;
+   int frees;
+   int reallocs;
+} AllocCounts;
+
+static object counting_alloc(void *ctx, usize size, bool zero) {
+   ((AllocCounts *)ctx)->allocs++;
+   return Memory.alloc(size, zero);
+}
+static void counting_free(void *ctx, object ptr) {
+   ((AllocCounts *)ctx)->frees++;
+   Memory.dispose(ptr);
+}
+static object counting_realloc(void *ctx, object ptr, usize old_size, usize new_size) {
+   (void)old_size;
+   ((AllocCounts *)ctx)->reallocs++;
+   return Memory.realloc(ptr, new_size);
+}
+
+//  growth and disposal go back through the list's own allocator
+static void test_list_explicit_allocator(void) {
+   AllocCounts counts = {0};
+   sc_allocator counting = {counting_alloc, counting_free, counting_realloc, &counts};
+
+   list lst = List.new_with(2, sizeof(addr), &counting);
+   Assert.isNotNull(lst, "List creation with allocator failed");
+   for (int i = 0; i < 20; i++) {
+      List.append(lst, &i);
+   }
+   Assert.isTrue(counts.reallocs > 0, "List growth should use the allocator's realloc");
+
+   int allocs = counts.allocs;
+   List.dispose(lst);
+   Assert.areEqual(&allocs, &counts.frees, INT, "Every allocation should be freed through the allocator");
+}
+
+//  arena-backed list grows and disposes without touching the root pool
+static void test_list_arena_allocator(void) {
+   arena scratch = Memory.Arena.create(1);
+   list lst = List.new_with(2, sizeof(addr), Arena.allocator(scratch));
+   Assert.isNotNull(lst, "Arena-backed list creation failed");
+
+   static int values[100];
+   for (int i = 0; i < 100; i++) {
+      values[i] = i;
+      List.append(lst, &values[i]);
+   }
+   object value = NULL;
+   List.get(lst, 99, &value);
+   Assert.areEqual(&values[99], value, PTR, "Arena-backed list should keep values across growth");
+   Assert.isTrue(Arena.get_total_allocated(scratch) > 100 * sizeof(addr), "Buckets should come from the arena");
+
+   List.dispose(lst);
+   Memory.Arena.dispose(scratch);
+}
+
+//  collections created inside a scope capture that scope's allocator
+static void test_list_scope_allocator(void) {
+   arena scope = Memory.Arena.create(1);
+   Memory.Scope.push(scope);
+   list lst = List.new(2, sizeof(addr));
+   Memory.Scope.pop();
+
+   // Growth after the scope was popped still goes to the arena
+   usize before = Arena.get_total_allocated(scope);
+   for (int i = 0; i < 16; i++) {
+      List.append(lst, &i);
+   }
+   Assert.isTrue(Arena.get_total_allocated(scope) > before, "Growth should use the captured arena allocator");
+
+   List.dispose(lst);
+   Memory.Arena.dispose(scope);
+}
+
 //  register test cases
 __attribute__((constructor)) void init_list_tests(void) {
    testset("core_list_set", set_config, set_teardown);
@@ -502,6 +578,10 @@ __attribute__((constructor)) void init_list_tests(void) {
    testcase("list_get_empty_list", test_list_get_empty_list);
    testcase("list_remove_empty_list", test_list_remove_empty_list);
    testcase("list_append_null_value", test_list_append_null_value);
+
+   testcase("list_explicit_allocator", test_list_explicit_allocator);
+   testcase("list_arena_allocator", test_list_arena_allocator);
+   testcase("list_scope_allocator", test_list_scope_allocator);
 }
 
 static void load_person_list(list *lst) {
@@ -5,10 +5,13 @@
 
 #include "internal/memory_internal.h"
 #include "prototyping/proto_arena.h"
+#include "sigcore/list.h"
 #include "sigcore/memory.h"
 #include <sigtest/sigtest.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <threads.h>
 
 #define PAGE_SLOTS_CAPACITY 4096
 
@@ -234,6 +237,217 @@ void test_memory_fragmentation_stress(void) {
    Memory.dispose(large);
 }
 
+// soft budget callback: count crossings
+static int budget_soft_calls = 0;
+static void budget_on_soft(void *scope, usize reserved, usize soft_limit) {
+   (void)scope;
+   if (reserved > soft_limit)
+      budget_soft_calls++;
+}
+
+void test_memory_pool_budgets(void) {
+   // Pool: one page up front, a soft budget at that page and a hard budget at two
+   pool p = Memory.Pool.create(1);
+   Assert.isNotNull(p, "Pool creation");
+   budget_soft_calls = 0;
+   Assert.areEqual(&(int){OK}, &(int){Memory.Pool.set_budget(p, &(scope_budget){.soft = 4096, .hard = 8192, .on_soft = budget_on_soft})}, INT, "Set pool budget");
+   Assert.isNotNull(pool_alloc(p, 3000, false), "First page allocation");
+   Assert.isNotNull(pool_alloc(p, 3000, false), "Second page stays within the hard budget");
+   Assert.areEqual(&(int){1}, &budget_soft_calls, INT, "Crossing the soft budget should call on_soft once");
+   Assert.isNull(pool_alloc(p, 3000, false), "Third page should fail the hard budget");
+   Assert.areEqual(&(int){1}, &budget_soft_calls, INT, "Refused growth should not call on_soft");
+   Memory.Pool.set_budget(p, NULL);
+   Assert.isNotNull(pool_alloc(p, 3000, false), "Clearing the budget should allow growth");
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Pool.set_budget(NULL, NULL)}, INT, "NULL pool should be rejected");
+   Memory.Pool.dispose(p);
+
+   // Root pool: with a 1-byte hard budget, whole-page allocations run out instead of growing
+   object blocks[1024];
+   int count = 0;
+   Memory.set_budget(&(scope_budget){.hard = 1});
+   while (count < 1024 && (blocks[count] = Memory.alloc(3000, false)) != NULL)
+      count++;
+   Assert.isTrue(count < 1024, "Root pool should stop growing at the hard budget (%d blocks)", count);
+   Memory.set_budget(NULL);
+   object grown = Memory.alloc(3000, false);
+   Assert.isNotNull(grown, "Root pool should grow again once the budget is removed");
+   Memory.dispose(grown);
+   for (int i = 0; i < count; i++)
+      Memory.dispose(blocks[i]);
+}
+
+// block allocated under a tag by another thread and handed back
+typedef struct {
+   memory_tag tag;
+   object block;
+} tag_handoff;
+
+static int tag_worker(void *arg) {
+   tag_handoff *handoff = arg;
+   Memory.Tag.set(handoff->tag);
+   handoff->block = Memory.alloc(300, false);
+   return 0;
+}
+
+void test_memory_tags(void) {
+   memory_tag parser = Memory.Tag.define("parser");
+   memory_tag cache = Memory.Tag.define("cache");
+   Assert.isTrue(parser != 0 && cache != 0 && parser != cache, "Defined tags should be distinct and non-zero");
+   memory_tag previous = Memory.Tag.set(parser);
+   Assert.areEqual(&(int){parser}, &(int){Memory.Tag.get()}, INT, "Thread tag should be set");
+
+   // Root pool allocations are charged to the thread's tag
+   memory_tag_stats stats;
+   object block = Memory.alloc(100, false);
+   Memory.Tag.stats(parser, &stats);
+   Assert.isTrue(stats.live_bytes >= 100, "Root allocation should be charged (%zu bytes)", stats.live_bytes);
+   Assert.areEqual(&(usize){1}, &stats.allocations, LONG, "Root allocation should be counted");
+   Memory.dispose(block);
+   Memory.Tag.stats(parser, &stats);
+   Assert.areEqual(&(usize){0}, &stats.live_bytes, LONG, "Dispose should return the bytes");
+
+   // Arenas and pools are charged to the tag they were created under (the arena
+   // header itself comes from the root pool, so only deltas are compared)
+   arena a = Memory.Arena.create(1);
+   pool p = Memory.Pool.create(1);
+   Memory.Tag.set(previous);
+   memory_tag_stats base;
+   Memory.Tag.stats(parser, &base);
+   Arena.alloc(a, 1000, false);
+   frame f = Arena.begin_frame(a);
+   Arena.alloc(a, 500, false);
+   Memory.Tag.stats(parser, &stats);
+   Assert.areEqual(&(usize){base.live_bytes + 1500}, &stats.live_bytes, LONG, "Arena bytes should be charged to the arena's tag");
+   Arena.end_frame(f);
+   Memory.Tag.stats(parser, &stats);
+   Assert.areEqual(&(usize){base.live_bytes + 1000}, &stats.live_bytes, LONG, "end_frame should return the frame's bytes");
+   Assert.areEqual(&(usize){base.allocations + 2}, &stats.allocations, LONG, "Allocation count is cumulative");
+
+   object pooled = pool_alloc(p, 200, false);
+   Memory.Tag.stats(parser, &stats);
+   Assert.isTrue(stats.live_bytes >= base.live_bytes + 1200, "Pool bytes should be charged to the pool's tag");
+
+   // Retagging moves live bytes
+   Assert.areEqual(&(int){OK}, &(int){Memory.Tag.set_scope(a, cache)}, INT, "Retag arena");
+   Assert.areEqual(&(int){OK}, &(int){Memory.Tag.set_scope(p, cache)}, INT, "Retag pool");
+   Memory.Tag.stats(parser, &stats);
+   Assert.areEqual(&base.live_bytes, &stats.live_bytes, LONG, "Old tag should only keep the arena header after retagging");
+   Memory.Tag.stats(cache, &stats);
+   Assert.isTrue(stats.live_bytes >= 1200, "New tag should hold the moved bytes");
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Tag.set_scope(a, MEMORY_TAG_MAX)}, INT, "Out-of-range tag should be rejected");
+
+   Memory.report_tags();
+
+   pool_free(p, pooled);
+   Memory.Pool.dispose(p);
+   Memory.Arena.dispose(a);
+   Memory.Tag.stats(cache, &stats);
+   Assert.areEqual(&(usize){0}, &stats.live_bytes, LONG, "Dispose should return every byte");
+   Memory.Tag.stats(parser, &stats);
+   Assert.areEqual(&(usize){0}, &stats.live_bytes, LONG, "Disposing the arena header should empty the old tag");
+
+   // Counters are kept per thread: a block charged by an exited thread and freed here
+   // still nets out once every thread's counters are folded
+   usize allocations = stats.allocations;
+   for (int round = 0; round < 2; round++) {
+      tag_handoff handoff = {.tag = parser};
+      thrd_t worker;
+      Assert.areEqual(&(int){thrd_success}, &(int){thrd_create(&worker, tag_worker, &handoff)}, INT, "Worker should start");
+      thrd_join(worker, NULL);
+      Assert.isNotNull(handoff.block, "Worker allocation should succeed");
+      Memory.Tag.stats(parser, &stats);
+      Assert.isTrue(stats.live_bytes >= 300, "Exited thread's charge should still be counted");
+      Memory.dispose(handoff.block);
+   }
+   Memory.Tag.stats(parser, &stats);
+   Assert.areEqual(&(usize){0}, &stats.live_bytes, LONG, "Cross-thread frees should net out");
+   Assert.areEqual(&(usize){allocations + 2}, &stats.allocations, LONG, "Each worker allocation should be counted");
+}
+
+// Read a whole trace dump
+static char *read_trace(const char *path) {
+   FILE *file = fopen(path, "r");
+   if (!file)
+      return NULL;
+   static char text[1 << 20];
+   usize length = fread(text, 1, sizeof(text) - 1, file);
+   text[length] = '\0';
+   fclose(file);
+   return text;
+}
+
+// Highest thread number in a trace dump
+static unsigned trace_max_tid(const char *trace) {
+   unsigned max = 0, tid;
+   for (const char *at = strstr(trace, "\"tid\":"); at; at = strstr(at + 1, "\"tid\":"))
+      if (sscanf(at, "\"tid\":%u", &tid) == 1 && tid > max)
+         max = tid;
+   return max;
+}
+
+// Worker for the trace ring reuse check: records one event and exits
+static int trace_worker(void *arg) {
+   (void)arg;
+   Memory.dispose(Memory.alloc(32, false));
+   return 0;
+}
+
+// test allocator event tracing and its Chrome trace export
+void test_memory_trace(void) {
+   const char *path = "logs/test_memory_trace.json";
+   Assert.areEqual(&(int){OK}, &(int){Memory.Trace.start(256)}, INT, "Starting the trace should succeed");
+   Memory.Trace.clear();
+
+   object ptr = Memory.alloc(48, false);
+   Memory.dispose(ptr);
+   arena a = Memory.Arena.create(1);
+   frame f = Arena.begin_frame(a);
+   Arena.alloc(a, 6000, false); // Needs a second page
+   Arena.end_frame(f);
+   list lst = List.new(2, sizeof(int));
+   for (int i = 0; i < 8; i++)
+      List.append(lst, &i);
+   List.dispose(lst);
+   Memory.Arena.dispose(a);
+   Memory.Trace.stop();
+
+   Assert.areEqual(&(int){OK}, &(int){Memory.Trace.dump(path)}, INT, "Dump should succeed");
+   char *trace = read_trace(path);
+   Assert.isNotNull(trace, "Dump should be readable");
+   Assert.isTrue(strncmp(trace, "{\"displayTimeUnit\"", 18) == 0, "Dump should be a Chrome trace object");
+   Assert.isNotNull(strstr(trace, "\"name\":\"alloc\""), "Allocations should be traced");
+   Assert.isNotNull(strstr(trace, "\"name\":\"dispose\""), "Disposals should be traced");
+   Assert.isNotNull(strstr(trace, "\"name\":\"page_grow\""), "Page growth should be traced");
+   Assert.isNotNull(strstr(trace, "\"name\":\"page_release\""), "Page release should be traced");
+   Assert.isNotNull(strstr(trace, "\"name\":\"frame\",\"cat\":\"memory\",\"ph\":\"B\""), "Frame begin should be a duration start");
+   Assert.isNotNull(strstr(trace, "\"name\":\"frame\",\"cat\":\"memory\",\"ph\":\"E\""), "Frame end should be a duration end");
+   Assert.isNotNull(strstr(trace, "\"name\":\"collection_grow\""), "Collection growth should be traced");
+   Assert.isTrue(strcmp(trace + strlen(trace) - 3, "]}\n") == 0, "Dump should close the event array");
+
+   // Threads that come and go take over the rings of exited ones
+   Memory.Trace.start(256);
+   unsigned max_tid = trace_max_tid(trace);
+   for (int i = 0; i < 32; i++) {
+      thrd_t worker;
+      Assert.areEqual(&(int){thrd_success}, &(int){thrd_create(&worker, trace_worker, NULL)}, INT, "Worker should start");
+      thrd_join(worker, NULL);
+   }
+   Memory.Trace.stop();
+   Memory.Trace.dump(path);
+   trace = read_trace(path);
+   Assert.isTrue(trace_max_tid(trace) <= max_tid + 1, "Exited threads' rings should be reused");
+
+   // Stopped: nothing more is recorded; cleared: nothing is left
+   usize length = strlen(trace);
+   Memory.dispose(Memory.alloc(16, false));
+   Memory.Trace.dump(path);
+   Assert.areEqual(&length, &(usize){strlen(read_trace(path))}, LONG, "Stopped trace should not record");
+   Memory.Trace.clear();
+   Memory.Trace.dump(path);
+   Assert.isTrue(strcmp(read_trace(path), "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[]}\n") == 0, "Cleared trace should be empty");
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Trace.dump(NULL)}, INT, "NULL path should be rejected");
+}
+
 //  register test cases
 __attribute__((constructor)) void init_memory_tests(void) {
    testset("core_memory_set", set_config, set_teardown);
@@ -256,4 +470,7 @@ __attribute__((constructor)) void init_memory_tests(void) {
    testcase("Merge both adjacent blocks", test_memory_merge_both);
    testcase("No merge non-adjacent blocks", test_memory_no_merge_non_adjacent);
    testcase("Fragmentation stress test", test_memory_fragmentation_stress);
+   testcase("Pool and root pool budgets", test_memory_pool_budgets);
+   testcase("Allocation tags", test_memory_tags);
+   testcase("Allocator event trace", test_memory_trace);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
  */
 
 #include "internal/page_tests.h"
+#include "internal/vmem.h"
 #include "sigcore/memory.h"
 #include "sigcore/slotarray.h"
 #include <sigtest/sigtest.h>
@@ -347,6 +348,23 @@ void test_page_alloc_size_extremes(void) {
    Page_destroy(page);
 }
 
+// test page data starts on an OS page boundary
+void test_page_os_alignment(void) {
+   usize os_page = vmem_page_size();
+   usize sizes[] = {PAGE_DATA_SIZE, 4 * PAGE_DATA_SIZE, 100};
+   for (usize i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+      sc_page *page = Page_create(sizes[i]);
+      Assert.isNotNull(page, "Page_create(%zu) should succeed", sizes[i]);
+      Assert.isTrue((addr)Page_get_bump(page) % os_page == 0, "Page data (%zu bytes) should be OS-page aligned", sizes[i]);
+      Assert.isTrue(Page_get_capacity(page) == sizes[i], "Page capacity should not be padded");
+
+      object ptr = Page_alloc(page, sizes[i], true);
+      Assert.isNotNull(ptr, "Whole-page allocation should succeed");
+      Assert.isTrue(Page_contains(page, ptr), "Whole-page allocation should be within page");
+      Page_destroy(page);
+   }
+}
+
 //  register test cases
 __attribute__((constructor)) void init_page_tests(void) {
    testset("core_page_set", set_config, set_teardown);
@@ -364,4 +382,5 @@ __attribute__((constructor)) void init_page_tests(void) {
    testcase("Memory exhaustion", test_page_memory_exhaustion);
    testcase("Null safety", test_page_null_safety);
    testcase("Size extremes", test_page_alloc_size_extremes);
+   testcase("OS page alignment", test_page_os_alignment);
 }
\ No newline at end of file
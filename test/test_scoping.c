@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
 
 static void set_config(FILE **log_stream) {
    *log_stream = fopen("logs/test_scoping.log", "w");
@@ -31,8 +32,8 @@ void test_scope_handle_validation(void) {
    Assert.isTrue(memcmp((const char *)test_arena, "ARN", 4) == 0, "Arena handle should be 'ARN\\0'");
 
    frame test_frame = Arena.begin_frame(test_arena);
-   Assert.isNotNull(test_frame, "Frame creation should succeed");
-   Assert.isTrue(memcmp((const char *)test_frame, "FRM", 4) == 0, "Frame handle should be 'FRM\\0'");
+   Assert.isNotNull(test_frame.slot, "Frame creation should succeed");
+   Assert.isTrue(memcmp(Arena.get_frame_scope(test_frame), "FRM", 4) == 0, "Frame scope handle should be 'FRM\\0'");
 
    Arena.end_frame(test_frame);
    Memory.Arena.dispose(test_arena);
@@ -68,16 +69,16 @@ void test_scope_transfer_frame_to_frame(void) {
    Assert.isNotNull(test_arena, "Arena creation should succeed");
 
    frame source_frame = Arena.begin_frame(test_arena);
-   Assert.isNotNull(source_frame, "Source frame creation should succeed");
+   Assert.isNotNull(source_frame.slot, "Source frame creation should succeed");
 
    object ptr = Arena.alloc(test_arena, 64, false);
    Assert.isNotNull(ptr, "Frame allocation should succeed");
    Assert.isTrue(Arena.is_tracking(test_arena, ptr), "Pointer should be tracked by arena");
 
    frame dest_frame = Arena.begin_frame(test_arena);
-   Assert.isNotNull(dest_frame, "Destination frame creation should succeed");
+   Assert.isNotNull(dest_frame.slot, "Destination frame creation should succeed");
 
-   int result = Memory.Scope.move(source_frame, dest_frame, ptr);
+   int result = Memory.Scope.move(Arena.get_frame_scope(source_frame), Arena.get_frame_scope(dest_frame), ptr);
    Assert.areEqual(&result, &(int){0}, INT, "Frame to frame transfer should succeed");
 
    // End source frame - pointer should still be valid in dest frame
@@ -100,12 +101,12 @@ void test_scope_transfer_frame_to_arena(void) {
    Assert.isNotNull(dest_arena, "Destination arena creation should succeed");
 
    frame test_frame = Arena.begin_frame(source_arena);
-   Assert.isNotNull(test_frame, "Frame creation should succeed");
+   Assert.isNotNull(test_frame.slot, "Frame creation should succeed");
 
    void *ptr = Arena.alloc(source_arena, 64, false); // Allocate within frame scope
    Assert.isNotNull(ptr, "Arena allocation should succeed");
 
-   int result = Memory.Scope.move(test_frame, dest_arena, ptr);
+   int result = Memory.Scope.move(Arena.get_frame_scope(test_frame), dest_arena, ptr);
    Assert.areEqual(&(int){result}, &(int){OK}, INT, "Scope_transfer from Frame to Arena should succeed");
 
    Arena.end_frame(test_frame);
@@ -119,12 +120,12 @@ void test_scope_transfer_arena_to_frame(void) {
    Assert.isNotNull(test_arena, "Arena creation should succeed");
 
    frame test_frame = Arena.begin_frame(test_arena);
-   Assert.isNotNull(test_frame, "Frame creation should succeed");
+   Assert.isNotNull(test_frame.slot, "Frame creation should succeed");
 
    void *ptr = Arena.alloc(test_arena, 64, false);
    Assert.isNotNull(ptr, "Arena allocation should succeed");
 
-   int result = Memory.Scope.move(test_arena, test_frame, ptr);
+   int result = Memory.Scope.move(test_arena, Arena.get_frame_scope(test_frame), ptr);
    Assert.areEqual(&(int){result}, &(int){OK}, INT, "Scope_transfer from Arena to Frame should succeed");
 
    Arena.end_frame(test_frame); // This should dispose the transferred pointer
@@ -155,13 +156,13 @@ void test_scope_transfer_between_frames(void) {
 
    frame source_frame = Arena.begin_frame(test_arena);
    frame dest_frame = Arena.begin_frame(test_arena);
-   Assert.isNotNull(source_frame, "Source frame creation should succeed");
-   Assert.isNotNull(dest_frame, "Destination frame creation should succeed");
+   Assert.isNotNull(source_frame.slot, "Source frame creation should succeed");
+   Assert.isNotNull(dest_frame.slot, "Destination frame creation should succeed");
 
    void *ptr = Arena.alloc(test_arena, 64, false);
    Assert.isNotNull(ptr, "Arena allocation should succeed");
 
-   int result = Memory.Scope.move(source_frame, dest_frame, ptr);
+   int result = Memory.Scope.move(Arena.get_frame_scope(source_frame), Arena.get_frame_scope(dest_frame), ptr);
    Assert.areEqual(&(int){result}, &(int){OK}, INT, "Scope_transfer between frames should succeed");
 
    Arena.end_frame(source_frame);
@@ -286,6 +287,249 @@ void test_collections_scoped_allocation(void) {
    Memory.Arena.dispose(test_arena);
 }
 
+// Test scope push/pop nesting
+void test_scope_push_pop(void) {
+   sc_arena *outer = Memory.Arena.create(1);
+   sc_arena *inner = Memory.Arena.create(1);
+
+   Assert.areEqual(&(int){OK}, &(int){Memory.Scope.push(outer)}, INT, "Push outer should succeed");
+   Assert.areEqual(&(int){OK}, &(int){Memory.Scope.push(inner)}, INT, "Push inner should succeed");
+   Assert.areEqual(inner, Memory.Scope.get_current(), PTR, "Inner scope should be current");
+
+   object ptr = scope_alloc(16, false);
+   Assert.isTrue(Arena.is_tracking(inner, ptr), "scope_alloc should use the pushed arena");
+
+   Assert.areEqual(inner, Memory.Scope.pop(), PTR, "Pop should return the inner scope");
+   Assert.areEqual(outer, Memory.Scope.get_current(), PTR, "Outer scope should be restored");
+   Assert.areEqual(outer, Memory.Scope.pop(), PTR, "Pop should return the outer scope");
+   Assert.isNull(Memory.Scope.get_current(), "Original scope should be restored");
+   Assert.isNull(Memory.Scope.pop(), "Pop on an empty stack should return NULL");
+
+   Memory.Arena.dispose(inner);
+   Memory.Arena.dispose(outer);
+}
+
+// User-defined scope backed by malloc that counts its calls
+typedef struct {
+   sc_scope scope; // Must be the first member
+   int allocs;
+   int frees;
+} counting_scope;
+
+static object counting_alloc(void *scope, usize size, bool zero) {
+   ((counting_scope *)scope)->allocs++;
+   return zero ? calloc(1, size) : malloc(size);
+}
+
+static void counting_free(void *scope, object ptr) {
+   ((counting_scope *)scope)->frees++;
+   free(ptr);
+}
+
+static object counting_realloc(void *scope, object ptr, usize old_size, usize new_size) {
+   (void)old_size;
+   ((counting_scope *)scope)->allocs++;
+   return realloc(ptr, new_size);
+}
+
+static const scope_ops counting_ops = {
+    .alloc = counting_alloc,
+    .free = counting_free,
+    .realloc = counting_realloc,
+};
+
+// Test frames, pools and user-defined scopes as the current scope
+void test_scope_dispatch(void) {
+   // Frame scope: allocations land in the frame's arena and roll back with it
+   sc_arena *test_arena = Memory.Arena.create(1);
+   frame test_frame = Arena.begin_frame(test_arena);
+   Memory.Scope.push(Arena.get_frame_scope(test_frame));
+   object in_frame = scope_alloc(32, false);
+   Assert.isTrue(Arena.contains(test_arena, in_frame), "Frame scope should allocate from its arena");
+   Memory.Scope.pop();
+   Arena.end_frame(test_frame);
+   usize used = Arena.get_total_allocated(test_arena);
+   Assert.areEqual(&(usize){0}, &used, LONG, "Frame scope allocations should roll back");
+
+   // A frame scope still current when the frame ends falls back to the arena
+   test_frame = Arena.begin_frame(test_arena);
+   Memory.Scope.push(Arena.get_frame_scope(test_frame));
+   Arena.end_frame(test_frame);
+   object after_end = scope_alloc(32, false);
+   Memory.Scope.pop();
+   Assert.isTrue(Arena.contains(test_arena, after_end), "Ended frame scope should allocate from its arena");
+   Arena.reset(test_arena);
+   Memory.Arena.dispose(test_arena);
+
+   // Pool scope: collections capture the pool's allocator
+   pool test_pool = Memory.Pool.create(1);
+   Memory.Scope.push(test_pool);
+   Assert.isTrue(Memory.Scope.allocator() != Memory.allocator(), "Pool scope should have its own allocator");
+   list lst = List.new(2, sizeof(addr));
+   for (usize i = 0; i < 8; i++) {
+      Assert.areEqual(&(int){OK}, &(int){List.append(lst, (object)(i + 1))}, INT, "Append in pool scope should succeed");
+   }
+   Memory.Scope.pop();
+   usize count = List.size(lst);
+   Assert.areEqual(&(usize){8}, &count, LONG, "Pool-scoped list should hold all items");
+   List.dispose(lst);
+   Memory.Pool.dispose(test_pool);
+
+   // User scope: every allocation goes through its ops
+   counting_scope user = {0};
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Scope.init(&user.scope, NULL)}, INT, "Init without ops should fail");
+   Assert.areEqual(&(int){OK}, &(int){Memory.Scope.init(&user.scope, &counting_ops)}, INT, "Init should succeed");
+   Memory.Scope.push(&user);
+   object ptr = scope_alloc(16, false);
+   lst = List.new(4, sizeof(addr));
+   Memory.Scope.pop();
+   Assert.isNotNull(ptr, "User scope allocation should succeed");
+   Assert.isTrue(user.allocs >= 2, "User scope should see the allocations");
+   List.dispose(lst);
+   Assert.isTrue(user.frees >= 1, "Collections should free through the user scope");
+   free(ptr);
+
+   object copy = Memory.Scope.import(&user, "scope", 6);
+   Assert.areEqual(&(int){0}, &(int){strcmp(copy, "scope")}, INT, "Import should copy into the user scope");
+   free(copy);
+
+   // Without track/untrack the user scope cannot take part in moves
+   sc_arena *source = Memory.Arena.create(1);
+   object owned = Arena.alloc(source, 16, false);
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Scope.move(source, &user, owned)}, INT, "Move into untracked scope should fail");
+   Assert.isTrue(Arena.is_tracking(source, owned), "Failed move should leave ownership unchanged");
+   Memory.Arena.dispose(source);
+}
+
+// Release order recorded by adopt_release
+static int adopt_released[8];
+static int adopt_release_count = 0;
+
+static void adopt_release(object ptr, usize size) {
+   adopt_released[adopt_release_count++] = (int)size;
+   free(ptr);
+}
+
+// Test adopting external buffers without copying
+void test_scope_adopt(void) {
+   adopt_release_count = 0;
+   sc_arena *test_arena = Memory.Arena.create(1);
+
+   char *buffer = malloc(64);
+   strcpy(buffer, "adopted");
+   Assert.areEqual(&(int){OK}, &(int){Memory.Scope.adopt(test_arena, buffer, 1, adopt_release)}, INT, "Arena should adopt a buffer");
+   Assert.areEqual(&(int){OK}, &(int){Memory.Scope.adopt(test_arena, malloc(16), 2, adopt_release)}, INT, "Arena should adopt a second buffer");
+   usize used = Arena.get_total_allocated(test_arena);
+   Assert.areEqual(&(usize){0}, &used, LONG, "Adoption should not copy into the arena");
+
+   // Frame adoptions are released when the frame ends, unless promoted
+   frame test_frame = Arena.begin_frame(test_arena);
+   Memory.Scope.adopt(Arena.get_frame_scope(test_frame), malloc(16), 3, adopt_release);
+   Arena.end_frame(test_frame);
+   Assert.areEqual(&(int){1}, &adopt_release_count, INT, "Frame end should release the frame's buffer");
+   Assert.areEqual(&(int){3}, &adopt_released[0], INT, "Frame buffer should be released first");
+
+   test_frame = Arena.begin_frame(test_arena);
+   Memory.Scope.adopt(Arena.get_frame_scope(test_frame), malloc(16), 4, adopt_release);
+   Arena.promote_all(test_frame);
+   Arena.end_frame(test_frame);
+   Assert.areEqual(&(int){1}, &adopt_release_count, INT, "Promoted frame buffers should survive");
+
+   // Reset releases everything in reverse order of adoption
+   Arena.reset(test_arena);
+   Assert.areEqual(&(int){4}, &adopt_release_count, INT, "Reset should release the arena's buffers");
+   Assert.areEqual(&(int){4}, &adopt_released[1], INT, "Most recent buffer should be released first");
+   Assert.areEqual(&(int){1}, &adopt_released[3], INT, "Oldest buffer should be released last");
+
+   Memory.Scope.adopt(test_arena, malloc(16), 5, adopt_release);
+   Memory.Arena.dispose(test_arena);
+   Assert.areEqual(&(int){5}, &adopt_release_count, INT, "Dispose should release adopted buffers");
+
+   // Pools cannot release foreign buffers
+   pool test_pool = Memory.Pool.create(1);
+   char *kept = malloc(16);
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Scope.adopt(test_pool, kept, 16, adopt_release)}, INT, "Pool should not adopt");
+   Assert.areEqual(&(int){ERR}, &(int){Memory.Scope.adopt(NULL, kept, 16, adopt_release)}, INT, "NULL scope should not adopt");
+   free(kept);
+   Memory.Pool.dispose(test_pool);
+}
+
+// Builds a result in `out` using scratch memory for temporaries
+static int *scratch_build_squares(arena out, int count) {
+   frame scratch = Memory.Scope.scratch(out);
+   int *temp = Arena.alloc(Arena.get_frame_arena(scratch), count * sizeof(int), false);
+   for (int i = 0; i < count; i++)
+      temp[i] = i * i;
+
+   int *result = Arena.alloc(out, count * sizeof(int), false);
+   memcpy(result, temp, count * sizeof(int));
+   Arena.end_frame(scratch);
+   return result;
+}
+
+// Test scratch arena pair
+void test_scope_scratch(void) {
+   frame first = Memory.Scope.scratch(NULL);
+   Assert.isNotNull(first.slot, "Scratch frame should be created");
+   arena scratch_a = Arena.get_frame_arena(first);
+   Assert.isNotNull(scratch_a, "Scratch frame should have an arena");
+
+   // A scratch request conflicting with the first scratch arena gets the other one
+   frame second = Memory.Scope.scratch(scratch_a);
+   arena scratch_b = Arena.get_frame_arena(second);
+   Assert.isNotNull(scratch_b, "Second scratch frame should have an arena");
+   Assert.isTrue(scratch_a != scratch_b, "Conflicting scratch should use the other arena");
+
+   // Results written to a scratch arena survive temporary work in the nested call
+   int *squares = scratch_build_squares(scratch_a, 8);
+   Assert.areEqual(&(int){49}, &squares[7], INT, "Result should survive scratch rollback");
+
+   Arena.end_frame(second);
+   Arena.end_frame(first);
+   Assert.isNull(Arena.get_frame_arena(first), "Ended frame should have no arena");
+
+   usize used = Arena.get_total_allocated(scratch_a);
+   Assert.areEqual(&(usize){0}, &used, LONG, "Scratch arena should be empty after its frames end");
+}
+
+// Worker: checks that scopes are private to the thread
+static int scope_thread_worker(void *arg) {
+   void **result = (void **)arg;
+   result[0] = Memory.Scope.get_current(); // Must not see the main thread's scope
+
+   arena own = Memory.Scope.thread_arena();
+   Memory.Scope.push(own);
+   object ptr = scope_alloc(64, false);
+   result[1] = own;
+   result[2] = (own && Arena.is_tracking(own, ptr)) ? ptr : NULL;
+   Memory.Scope.pop();
+   return 0;
+}
+
+// Test thread-local current scope and per-thread default arenas
+void test_scope_thread_local(void) {
+   arena main_arena = Memory.Scope.thread_arena();
+   Assert.isNotNull(main_arena, "Main thread arena should be created");
+   Assert.areEqual(main_arena, Memory.Scope.thread_arena(), PTR, "Thread arena should be created once");
+   Memory.Scope.set_current(main_arena);
+
+   void *result[2][3] = {0};
+   thrd_t workers[2];
+   for (int i = 0; i < 2; i++)
+      thrd_create(&workers[i], scope_thread_worker, result[i]);
+   for (int i = 0; i < 2; i++)
+      thrd_join(workers[i], NULL);
+
+   for (int i = 0; i < 2; i++) {
+      Assert.isNull(result[i][0], "Worker %d should start without a current scope", i);
+      Assert.isNotNull(result[i][1], "Worker %d should get its own arena", i);
+      Assert.isTrue(result[i][1] != main_arena, "Worker %d arena should differ from the main arena", i);
+      Assert.isNotNull(result[i][2], "Worker %d should allocate from its own arena", i);
+   }
+   Assert.areEqual(main_arena, Memory.Scope.get_current(), PTR, "Main thread scope should be unaffected");
+   Memory.Scope.set_current(NULL);
+}
+
 // Test collection scope transfer
 void test_collection_scope_transfer(void) {
    sc_arena *source_arena = Memory.Arena.create(1);
@@ -333,6 +577,11 @@ __attribute__((constructor)) void init_scoping_tests(void) {
    testcase("Unowned object transfer fails", test_scope_transfer_unowned_object_fails);
    testcase("NULL parameters fail", test_scope_transfer_null_parameters_fail);
    testcase("Import functionality", test_scope_import);
+   testcase("Scope push/pop nesting", test_scope_push_pop);
+   testcase("Thread-local scopes and arenas", test_scope_thread_local);
+   testcase("Scratch arena pair", test_scope_scratch);
+   testcase("Frame, pool and user scope dispatch", test_scope_dispatch);
+   testcase("Adopt external buffers", test_scope_adopt);
    // testcase("Export functionality", test_scope_export);
    // testcase("Collections use scoped allocation", test_collections_scoped_allocation);
    // testcase("Collection scope transfer", test_collection_scope_transfer);
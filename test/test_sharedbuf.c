@@ -0,0 +1,137 @@
+/*
+ *  Test File: test_sharedbuf.c
+ *  Description: Test cases for SigmaCore reference-counted shared buffers
+ */
+
+#include "sigcore/farray.h"
+#include "sigcore/memory.h"
+#include "sigcore/sharedbuf.h"
+#include "sigcore/strings.h"
+#include <sigtest/sigtest.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+
+#define VALUES 4096
+#define CONSUMERS 4
+
+static void set_config(FILE **log_stream) {
+   *log_stream = fopen("logs/test_sharedbuf.log", "w");
+}
+
+static void set_teardown(void) {
+   // No hooks to reset
+}
+
+// Allocator over malloc that counts frees, to see where memory is returned
+static atomic_int counted_frees;
+
+static object counted_alloc(void *ctx, usize size, bool zero) {
+   (void)ctx;
+   return zero ? calloc(1, size) : malloc(size);
+}
+static void counted_free(void *ctx, object ptr) {
+   (void)ctx;
+   atomic_fetch_add(&counted_frees, 1);
+   free(ptr);
+}
+static object counted_realloc(void *ctx, object ptr, usize old_size, usize new_size) {
+   (void)ctx;
+   (void)old_size;
+   return realloc(ptr, new_size);
+}
+static const sc_allocator counting_allocator = {counted_alloc, counted_free, counted_realloc, NULL};
+
+// test wrapping, string sharing and reference counting on one thread
+void test_sharedbuf_basics(void) {
+   string text = String.dupe("shared payload");
+   shared_buffer buf = SharedBuffer.from_string(text, NULL);
+   Assert.isNotNull(buf, "Sharing a string should succeed");
+   Assert.isTrue(SharedBuffer.data(buf) == text, "The string should be shared, not copied");
+   Assert.areEqual(&(usize){15}, &(usize){SharedBuffer.size(buf)}, LONG, "Size should include the terminator");
+   Assert.areEqual(&(usize){1}, &(usize){SharedBuffer.refs(buf)}, LONG, "A new buffer should have one reference");
+   Assert.isTrue(SharedBuffer.retain(buf) == buf, "Retain should return the buffer");
+   Assert.areEqual(&(usize){2}, &(usize){SharedBuffer.refs(buf)}, LONG, "Retain should add a reference");
+   SharedBuffer.release(buf);
+   Assert.isTrue(strcmp(SharedBuffer.data(buf), "shared payload") == 0, "Data should survive while referenced");
+   SharedBuffer.release(buf);
+
+   atomic_store(&counted_frees, 0);
+   object block = counted_alloc(NULL, 64, true);
+   shared_buffer wrapped = SharedBuffer.wrap(block, 64, &counting_allocator);
+   SharedBuffer.release(wrapped);
+   Assert.areEqual(&(int){1}, &(int){atomic_load(&counted_frees)}, INT, "Last release should free through the allocator");
+
+   // A string made in another scope goes back to that scope, not the root pool
+   memory_tag tag = Memory.Tag.define("sharedbuf");
+   pool scratch = Memory.Pool.create(1);
+   Memory.Tag.set_scope(scratch, tag);
+   Memory.Scope.push(scratch);
+   string pooled = String.dupe("pooled payload");
+   allocator pool_alloc = Memory.Scope.allocator();
+   Memory.Scope.pop();
+   memory_tag_stats stats;
+   Memory.Tag.stats(tag, &stats);
+   Assert.isTrue(stats.live_bytes > 0, "Scoped string should be charged to its pool");
+   shared_buffer scoped = SharedBuffer.from_string(pooled, pool_alloc);
+   Assert.isTrue(SharedBuffer.data(scoped) == pooled, "Scoped string should be shared, not copied");
+   SharedBuffer.release(scoped);
+   Memory.Tag.stats(tag, &stats);
+   Assert.areEqual(&(usize){0}, &stats.live_bytes, LONG, "Last release should free the string into its pool");
+   Memory.Pool.dispose(scratch);
+
+   Assert.isNull(SharedBuffer.from_string(NULL, NULL), "NULL string should be rejected");
+   Assert.isNull(SharedBuffer.wrap(NULL, 8, NULL), "NULL data should be rejected");
+   Assert.isNull(SharedBuffer.from_farray(NULL), "NULL array should be rejected");
+   Assert.isNull(SharedBuffer.data(NULL), "NULL buffer has no data");
+   SharedBuffer.release(NULL);
+}
+
+// Sums a shared array and drops its reference
+static atomic_long consumer_sums;
+
+static int sharedbuf_consumer(void *arg) {
+   shared_buffer buf = arg;
+   const int *values = SharedBuffer.data(buf);
+   long sum = 0;
+   for (usize i = 0; i < SharedBuffer.size(buf) / sizeof(int); i++)
+      sum += values[i];
+   atomic_fetch_add(&consumer_sums, sum);
+   SharedBuffer.release(buf);
+   return 0;
+}
+
+// test handing an FArray bucket to several threads without copying
+void test_sharedbuf_farray_handoff(void) {
+   atomic_store(&counted_frees, 0);
+   atomic_store(&consumer_sums, 0);
+   farray arr = FArray.new_with(VALUES, sizeof(int), &counting_allocator);
+   for (int i = 0; i < VALUES; i++)
+      FArray.set(arr, (usize)i, sizeof(int), &i);
+
+   shared_buffer buf = SharedBuffer.from_farray(arr);
+   Assert.isNotNull(buf, "Sharing an array bucket should succeed");
+   Assert.areEqual(&(int){1}, &(int){atomic_load(&counted_frees)}, INT, "Only the array header should be freed");
+   Assert.areEqual(&(usize){VALUES * sizeof(int)}, &(usize){SharedBuffer.size(buf)}, LONG, "Buffer should cover the bucket");
+
+   thrd_t consumers[CONSUMERS];
+   for (int i = 0; i < CONSUMERS; i++)
+      thrd_create(&consumers[i], sharedbuf_consumer, SharedBuffer.retain(buf));
+   SharedBuffer.release(buf); // The producer is done; consumers hold the rest
+   for (int i = 0; i < CONSUMERS; i++)
+      thrd_join(consumers[i], NULL);
+
+   long expected = (long)CONSUMERS * VALUES * (VALUES - 1) / 2;
+   Assert.areEqual(&expected, &(long){atomic_load(&consumer_sums)}, LONG, "Every consumer should read the same values");
+   Assert.areEqual(&(int){2}, &(int){atomic_load(&counted_frees)}, INT, "The bucket should go back to its allocator once");
+}
+
+//  register test cases
+__attribute__((constructor)) void init_sharedbuf_tests(void) {
+   testset("core_sharedbuf_set", set_config, set_teardown);
+
+   testcase("Shared buffer basics", test_sharedbuf_basics);
+   testcase("FArray bucket handed to several threads", test_sharedbuf_farray_handoff);
+}
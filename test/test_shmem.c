@@ -0,0 +1,168 @@
+/*
+ *  Test File: test_shmem.c
+ *  Description: Test cases for SigmaCore shared memory regions and offset collections
+ */
+
+#define _GNU_SOURCE
+#include "sigcore/shmem.h"
+#include <sigtest/sigtest.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// A row of the shared table, referring to its name by offset
+struct shm_row {
+   int id;
+   shm_offset name;
+};
+
+// Root object tying the table together
+struct shm_table {
+   shm_farray rows;
+   shm_list names;
+   shm_slotarray index;
+};
+
+static void set_config(FILE **log_stream) {
+   *log_stream = fopen("logs/test_shmem.log", "w");
+}
+
+static void set_teardown(void) {
+   // No hooks to reset
+}
+
+// Copy a string into the region
+static shm_offset shm_strdup(shm_region region, const char *text) {
+   shm_offset offset = ShmRegion.alloc(region, strlen(text) + 1);
+   if (offset)
+      strcpy(ShmRegion.at(region, offset), text);
+   return offset;
+}
+
+// Build the table in a region and publish it as the root
+static void build_table(shm_region region) {
+   shm_offset root = ShmRegion.alloc(region, sizeof(struct shm_table));
+   struct shm_table *table = ShmRegion.at(region, root);
+   table->rows = ShmFArray.new(region, 8, sizeof(struct shm_row));
+   table->names = ShmList.new(region, 2);
+   table->index = ShmSlotArray.new(region, 2);
+
+   const char *names[] = {"alpha", "beta", "gamma", "delta", "epsilon"};
+   for (int i = 0; i < 5; i++) {
+      struct shm_row row = {.id = 100 + i, .name = shm_strdup(region, names[i])};
+      ShmFArray.set(region, table->rows, (usize)i, &row);
+      ShmList.append(region, table->names, row.name);
+      ShmSlotArray.add(region, table->index, ShmRegion.offset_of(region, ShmFArray.at(region, table->rows, (usize)i)));
+   }
+   ShmRegion.set_root(region, root);
+}
+
+// test collections read back through a second mapping at another address
+void test_shmem_second_mapping(void) {
+   shm_region writer = ShmRegion.create(NULL, 256 * 1024);
+   Assert.isNotNull(writer, "Anonymous region creation should succeed");
+   build_table(writer);
+
+   shm_region reader = ShmRegion.open_fd(ShmRegion.fd(writer));
+   Assert.isNotNull(reader, "Second mapping should open");
+   Assert.isTrue(ShmRegion.at(reader, ShmRegion.root(reader)) != ShmRegion.at(writer, ShmRegion.root(writer)),
+                 "The two mappings should sit at different addresses");
+
+   struct shm_table *table = ShmRegion.at(reader, ShmRegion.root(reader));
+   Assert.isNotNull(table, "Root should be visible through the second mapping");
+   Assert.areEqual(&(usize){8}, &(usize){ShmFArray.capacity(reader, table->rows)}, LONG, "Array capacity");
+   Assert.areEqual(&(usize){5}, &(usize){ShmList.size(reader, table->names)}, LONG, "List should have grown to 5 items");
+   Assert.isTrue(ShmList.capacity(reader, table->names) >= 5, "List capacity should cover its items");
+   Assert.isTrue(ShmSlotArray.capacity(reader, table->index) >= 5, "Slot array should have grown");
+
+   struct shm_row row;
+   Assert.areEqual(&(int){OK}, &(int){ShmFArray.get(reader, table->rows, 3, &row)}, INT, "Row read");
+   Assert.areEqual(&(int){103}, &row.id, INT, "Row id");
+   Assert.isTrue(strcmp(ShmRegion.at(reader, row.name), "delta") == 0, "Row name should resolve in the reader");
+
+   shm_offset name;
+   ShmList.get(reader, table->names, 4, &name);
+   Assert.isTrue(strcmp(ShmRegion.at(reader, name), "epsilon") == 0, "List item should resolve in the reader");
+
+   shm_offset slot;
+   Assert.areEqual(&(int){OK}, &(int){ShmSlotArray.get_at(reader, table->index, 2, &slot)}, INT, "Slot read");
+   Assert.areEqual(&(int){102}, &((struct shm_row *)ShmRegion.at(reader, slot))->id, INT, "Slot should point at row 2");
+
+   // Writes through either mapping are seen by the other
+   ShmList.remove(reader, table->names, 0);
+   ShmSlotArray.remove_at(reader, table->index, 1);
+   struct shm_table *writer_table = ShmRegion.at(writer, ShmRegion.root(writer));
+   Assert.areEqual(&(usize){4}, &(usize){ShmList.size(writer, writer_table->names)}, LONG, "Removal should be shared");
+   Assert.isTrue(ShmSlotArray.is_empty_slot(writer, writer_table->index, 1), "Freed slot should be shared");
+   Assert.areEqual(&(int){1}, &(int){ShmSlotArray.add(writer, writer_table->index, slot)}, INT, "Freed slot should be reused");
+
+   ShmRegion.close(reader);
+   ShmRegion.close(writer);
+}
+
+// test a child process extending the table through its own mapping
+void test_shmem_cross_process(void) {
+   shm_region region = ShmRegion.create(NULL, 256 * 1024);
+   Assert.isNotNull(region, "Region creation should succeed");
+   build_table(region);
+
+   pid_t child = fork();
+   if (child == 0) {
+      shm_region mine = ShmRegion.open_fd(ShmRegion.fd(region));
+      struct shm_table *table = mine ? ShmRegion.at(mine, ShmRegion.root(mine)) : NULL;
+      int ok = table && ShmList.append(mine, table->names, shm_strdup(mine, "from-child")) == OK;
+      _exit(ok ? 0 : 1);
+   }
+   int status = -1;
+   waitpid(child, &status, 0);
+   Assert.isTrue(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Child should extend the table");
+
+   struct shm_table *table = ShmRegion.at(region, ShmRegion.root(region));
+   shm_offset name;
+   Assert.areEqual(&(int){OK}, &(int){ShmList.get(region, table->names, 5, &name)}, INT, "Child's item should be visible");
+   Assert.isTrue(strcmp(ShmRegion.at(region, name), "from-child") == 0, "Child's string should resolve in the parent");
+   ShmRegion.close(region);
+}
+
+// test named regions, bounds and exhaustion
+void test_shmem_named_and_bounds(void) {
+   char name[64];
+   snprintf(name, sizeof(name), "/sigcore_test_%d", (int)getpid());
+   ShmRegion.unlink(name);
+
+   shm_region region = ShmRegion.create(name, 64 * 1024);
+   Assert.isNotNull(region, "Named region creation should succeed");
+   Assert.isNull(ShmRegion.create(name, 64 * 1024), "Creating an existing name should fail");
+   shm_offset value = ShmRegion.alloc(region, sizeof(int));
+   *(int *)ShmRegion.at(region, value) = 42;
+   ShmRegion.set_root(region, value);
+
+   shm_region other = ShmRegion.open(name);
+   Assert.isNotNull(other, "Named region should open");
+   Assert.areEqual(&(int){42}, (int *)ShmRegion.at(other, ShmRegion.root(other)), INT, "Root value should be shared");
+   Assert.areEqual(&(int){OK}, &(int){ShmRegion.unlink(name)}, INT, "Unlink should succeed");
+   Assert.isNull(ShmRegion.open(name), "Unlinked name should not open");
+   Assert.areEqual(&(int){42}, (int *)ShmRegion.at(other, ShmRegion.root(other)), INT, "Mappings outlive the name");
+
+   Assert.isNull(ShmRegion.at(region, 0), "Offset 0 is null");
+   Assert.isNull(ShmRegion.at(region, 64 * 1024), "Offsets past the region should not resolve");
+   Assert.areEqual(&(shm_offset){0}, &(shm_offset){ShmRegion.offset_of(region, &value)}, LONG, "Foreign pointers have no offset");
+   Assert.areEqual(&(shm_offset){0}, &(shm_offset){ShmRegion.alloc(region, 64 * 1024)}, LONG, "Oversized allocation should fail");
+   Assert.areEqual(&(shm_farray){0}, &(shm_farray){ShmFArray.new(region, 1024 * 1024, 8)}, LONG, "Array larger than the region should fail");
+   Assert.isTrue(ShmRegion.used(region) < 64 * 1024, "Failed allocations should not consume space");
+   Assert.areEqual(&(int){ERR}, &(int){ShmSlotArray.add(region, 0, value)}, INT, "Invalid slot array should be rejected");
+
+   ShmRegion.close(other);
+   ShmRegion.close(region);
+}
+
+//  register test cases
+__attribute__((constructor)) void init_shmem_tests(void) {
+   testset("core_shmem_set", set_config, set_teardown);
+
+   testcase("Shared collections through a second mapping", test_shmem_second_mapping);
+   testcase("Shared region across processes", test_shmem_cross_process);
+   testcase("Named regions and bounds", test_shmem_named_and_bounds);
+}